@@ -12,7 +12,7 @@ protected:
         CObject* = nullptr); ///< Collision response.
 
 public:
-    CActivity(eSprite t, const Vector2& p); ///< Constructor.
+    CActivity(CWorld* pWorld, eSprite t, const Vector2& p); ///< Constructor.
     void UpdatePos(const Vector2&);
     void HideActivity();
 }; //CBullet
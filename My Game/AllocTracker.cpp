@@ -0,0 +1,188 @@
+/// \file AllocTracker.cpp
+/// \brief Code for the allocation tracker CAllocTracker and the global
+/// allocation operators that feed it.
+
+#include "AllocTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef TRACK_ALLOCATIONS
+
+/// \brief Header at the start of every tracked block.
+
+struct CAllocHeader{
+  size_t m_nSize; ///< Size requested, not counting the header.
+  eAlloc m_eTag; ///< Tag the block was charged to.
+}; //CAllocHeader
+
+static const size_t ALLOC_HEADER_SIZE = 16; ///< Header size, keeping blocks 16-byte aligned.
+static_assert(sizeof(CAllocHeader) <= ALLOC_HEADER_SIZE, "Allocation header is too big.");
+
+std::atomic<size_t> CAllocTracker::m_nBytes[(UINT)eAlloc::Size] = {};
+std::atomic<size_t> CAllocTracker::m_nBlocks[(UINT)eAlloc::Size] = {};
+std::atomic<size_t> CAllocTracker::m_nTotal[(UINT)eAlloc::Size] = {};
+size_t CAllocTracker::m_nFrameStart[(UINT)eAlloc::Size] = {};
+size_t CAllocTracker::m_nFrameAllocs[(UINT)eAlloc::Size] = {};
+thread_local eAlloc CAllocTracker::m_eTag = eAlloc::Other;
+
+#endif //TRACK_ALLOCATIONS
+
+/// Allocate a block and charge it to the current thread's tag. The counters
+/// are constant-initialized, so this is safe to call before `main()`.
+/// \param n Number of bytes.
+/// \return Pointer to the block, or `nullptr` if out of memory.
+
+void* CAllocTracker::Allocate(size_t n){
+  #ifdef TRACK_ALLOCATIONS
+    char* p = (char*)malloc(ALLOC_HEADER_SIZE + n); //block with header
+    if(p == nullptr)return nullptr;
+
+    CAllocHeader* h = (CAllocHeader*)p; //header
+    h->m_nSize = n;
+    h->m_eTag = m_eTag;
+
+    const UINT t = (UINT)h->m_eTag; //tag index
+    m_nBytes[t].fetch_add(n, std::memory_order_relaxed);
+    m_nBlocks[t].fetch_add(1, std::memory_order_relaxed);
+    m_nTotal[t].fetch_add(1, std::memory_order_relaxed);
+
+    return p + ALLOC_HEADER_SIZE;
+  #else
+    return malloc(n);
+  #endif //TRACK_ALLOCATIONS
+} //Allocate
+
+/// Free a block made by `Allocate()` and uncount it from the tag that it was
+/// charged to.
+/// \param p Pointer to the block, which may be `nullptr`.
+
+void CAllocTracker::Free(void* p){
+  #ifdef TRACK_ALLOCATIONS
+    if(p == nullptr)return;
+
+    CAllocHeader* h = (CAllocHeader*)((char*)p - ALLOC_HEADER_SIZE); //header
+    const UINT t = (UINT)h->m_eTag; //tag index
+    m_nBytes[t].fetch_sub(h->m_nSize, std::memory_order_relaxed);
+    m_nBlocks[t].fetch_sub(1, std::memory_order_relaxed);
+
+    free(h);
+  #else
+    free(p);
+  #endif //TRACK_ALLOCATIONS
+} //Free
+
+/// Start counting the allocations for a new frame, remembering how many were
+/// made during the frame that just ended. Call this once per frame from the
+/// main thread.
+
+void CAllocTracker::NewFrame(){
+  #ifdef TRACK_ALLOCATIONS
+    for(UINT t=0; t<(UINT)eAlloc::Size; t++){
+      const size_t n = m_nTotal[t].load(std::memory_order_relaxed); //total so far
+      m_nFrameAllocs[t] = n - m_nFrameStart[t];
+      m_nFrameStart[t] = n;
+    } //for
+  #endif //TRACK_ALLOCATIONS
+} //NewFrame
+
+/// Get the statistics for a tag.
+/// \param t Tag.
+/// \return Statistics, all zero if allocations aren't being tracked.
+
+const CAllocStats CAllocTracker::GetStats(eAlloc t){
+  CAllocStats s; //result
+
+  #ifdef TRACK_ALLOCATIONS
+    s.m_nBytes = m_nBytes[(UINT)t].load(std::memory_order_relaxed);
+    s.m_nBlocks = m_nBlocks[(UINT)t].load(std::memory_order_relaxed);
+    s.m_nFrameAllocs = m_nFrameAllocs[(UINT)t];
+  #endif //TRACK_ALLOCATIONS
+
+  return s;
+} //GetStats
+
+/// Get the name of a tag, for display.
+/// \param t Tag.
+/// \return Name.
+
+const char* CAllocTracker::GetName(eAlloc t){
+  switch(t){
+    case eAlloc::Objects:   return "objects";
+    case eAlloc::Map:       return "map";
+    case eAlloc::Particles: return "particles";
+    case eAlloc::UI:        return "UI";
+    case eAlloc::Audio:     return "audio";
+    default:                return "other";
+  } //switch
+} //GetName
+
+/// Constructor. Charge this thread's allocations to a tag until destroyed.
+/// \param t Tag.
+
+#ifdef TRACK_ALLOCATIONS
+  CAllocScope::CAllocScope(eAlloc t): m_ePrevTag(CAllocTracker::m_eTag){
+    CAllocTracker::m_eTag = t;
+  } //constructor
+#else
+  CAllocScope::CAllocScope(eAlloc){} //constructor
+#endif //TRACK_ALLOCATIONS
+
+/// Destructor. Put back the tag that was in use before.
+
+CAllocScope::~CAllocScope(){
+  #ifdef TRACK_ALLOCATIONS
+    CAllocTracker::m_eTag = m_ePrevTag;
+  #endif //TRACK_ALLOCATIONS
+} //destructor
+
+#ifdef TRACK_ALLOCATIONS
+
+//Replacements for the global allocation operators. There must be exactly one
+//definition of each in the program, and this is it.
+
+void* operator new(size_t n){
+  void* p = CAllocTracker::Allocate(n);
+  if(p == nullptr)throw std::bad_alloc();
+  return p;
+} //operator new
+
+void* operator new[](size_t n){
+  void* p = CAllocTracker::Allocate(n);
+  if(p == nullptr)throw std::bad_alloc();
+  return p;
+} //operator new[]
+
+void* operator new(size_t n, const std::nothrow_t&) noexcept{
+  return CAllocTracker::Allocate(n);
+} //operator new
+
+void* operator new[](size_t n, const std::nothrow_t&) noexcept{
+  return CAllocTracker::Allocate(n);
+} //operator new[]
+
+void operator delete(void* p) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete
+
+void operator delete[](void* p) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete[]
+
+void operator delete(void* p, size_t) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete
+
+void operator delete[](void* p, size_t) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete[]
+
+void operator delete(void* p, const std::nothrow_t&) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept{
+  CAllocTracker::Free(p);
+} //operator delete[]
+
+#endif //TRACK_ALLOCATIONS
@@ -0,0 +1,82 @@
+/// \file AllocTracker.h
+/// \brief Interface for the allocation tracker CAllocTracker.
+
+#ifndef __L4RC_GAME_ALLOCTRACKER_H__
+#define __L4RC_GAME_ALLOCTRACKER_H__
+
+#include "GameDefines.h"
+
+#include <atomic>
+
+/// Allocation tracking is compiled into debug builds. Define `TRACK_ALLOCATIONS`
+/// in the project settings to compile it into a release build as well.
+
+#ifndef TRACK_ALLOCATIONS
+  #ifdef _DEBUG
+    #define TRACK_ALLOCATIONS
+  #endif //_DEBUG
+#endif //TRACK_ALLOCATIONS
+
+/// \brief Allocation statistics for one tag.
+
+struct CAllocStats{
+  size_t m_nBytes = 0; ///< Bytes allocated and not yet freed.
+  size_t m_nBlocks = 0; ///< Allocations not yet freed.
+  size_t m_nFrameAllocs = 0; ///< Allocations made during the last frame.
+}; //CAllocStats
+
+/// \brief The allocation tracker.
+///
+/// The global `operator new` and `operator delete` are replaced so that
+/// every heap allocation made by the game and the engine is counted against
+/// the tag of the innermost `CAllocScope` on the thread that made it. Each
+/// block carries a small header holding its size and tag, so that freeing
+/// it uncounts it from the tag that it was charged to, whichever thread
+/// frees it and whatever scope that thread is in. The counters are atomic,
+/// so the co-op sessions and the map prefetch thread are counted too. If
+/// `TRACK_ALLOCATIONS` isn't defined then none of this is compiled and the
+/// statistics are all zero.
+
+class CAllocTracker{
+  private:
+    #ifdef TRACK_ALLOCATIONS
+      static std::atomic<size_t> m_nBytes[(UINT)eAlloc::Size]; ///< Live bytes.
+      static std::atomic<size_t> m_nBlocks[(UINT)eAlloc::Size]; ///< Live allocations.
+      static std::atomic<size_t> m_nTotal[(UINT)eAlloc::Size]; ///< Allocations ever made.
+      static size_t m_nFrameStart[(UINT)eAlloc::Size]; ///< Total at start of frame.
+      static size_t m_nFrameAllocs[(UINT)eAlloc::Size]; ///< Allocations made last frame.
+      static thread_local eAlloc m_eTag; ///< Tag for this thread's allocations.
+    #endif //TRACK_ALLOCATIONS
+
+    friend class CAllocScope;
+
+  public:
+    static void* Allocate(size_t); ///< Allocate a tagged block.
+    static void Free(void*); ///< Free a tagged block.
+
+    static void NewFrame(); ///< Start counting a new frame.
+    static const CAllocStats GetStats(eAlloc); ///< Get statistics for a tag.
+    static const char* GetName(eAlloc); ///< Get tag name.
+}; //CAllocTracker
+
+/// \brief An allocation scope.
+///
+/// While one of these exists, heap allocations made on its thread are charged
+/// to its tag. Scopes can nest, and the previous tag is put back when a scope
+/// ends.
+
+class CAllocScope{
+  private:
+    #ifdef TRACK_ALLOCATIONS
+      const eAlloc m_ePrevTag = eAlloc::Other; ///< Tag to put back.
+    #endif //TRACK_ALLOCATIONS
+
+  public:
+    CAllocScope(eAlloc); ///< Constructor.
+    ~CAllocScope(); ///< Destructor.
+
+    CAllocScope(const CAllocScope&) = delete; ///< No copying.
+    CAllocScope& operator=(const CAllocScope&) = delete; ///< No assignment.
+}; //CAllocScope
+
+#endif //__L4RC_GAME_ALLOCTRACKER_H__
@@ -0,0 +1,171 @@
+/// \file AssetPack.cpp
+/// \brief Code for the asset pack CAssetPack.
+
+#include "AssetPack.h"
+#include "Defines.h"
+#include "Abort.h"
+
+#include <windows.h>
+#include <cstring>
+#include <cstdio>
+
+/// Unmap the pack file, if any.
+
+CAssetPack::~CAssetPack(){
+  Close();
+} //destructor
+
+/// Map a pack file into memory read-only and check its header and table of
+/// contents. A missing pack is not an error, since the assets can be read
+/// from loose files, but a pack that is present and damaged is.
+/// \param filename Name of the pack file.
+/// \return true if the pack was mapped.
+
+const bool CAssetPack::Open(const char* filename){
+  Close();
+
+  HANDLE hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+  if(hFile == INVALID_HANDLE_VALUE)return false; //no pack
+
+  m_hFile = hFile;
+
+  LARGE_INTEGER size; //file size
+
+  if(!GetFileSizeEx(hFile, &size) || size.QuadPart < (LONGLONG)sizeof(PackHeader))
+    ABORT("Asset pack %s is too small.", filename);
+
+  m_nSize = (uint64_t)size.QuadPart;
+  m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if(m_hMapping != nullptr)
+    m_pBase = (const uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+
+  if(m_pBase == nullptr)
+    ABORT("Cannot map asset pack %s.", filename);
+
+  m_pHeader = (const PackHeader*)m_pBase;
+  m_pTable = (const PackEntry*)(m_pBase + sizeof(PackHeader));
+
+  if(!Validate())
+    ABORT("Asset pack %s is damaged.", filename);
+
+  return true;
+} //Open
+
+/// Check that the header has the right signature and version, and that the
+/// table of contents, names, and data all lie inside the mapped file, so that
+/// `Find()` can trust them without further checks.
+/// \return true if the pack is sound.
+
+const bool CAssetPack::Validate() const{
+  const PackHeader& h = *m_pHeader; //shorthand
+
+  if(memcmp(h.m_chMagic, PACK_MAGIC, 4) || h.m_nVersion != PACK_VERSION)
+    return false;
+
+  if(h.m_nTableSize == 0 || (h.m_nTableSize & (h.m_nTableSize - 1)) ||
+     h.m_nNumEntries >= h.m_nTableSize) //table must have an empty slot
+    return false;
+
+  const uint64_t tableEnd = sizeof(PackHeader) +
+    (uint64_t)h.m_nTableSize*sizeof(PackEntry); //end of table
+  if(tableEnd > m_nSize)return false;
+
+  for(uint32_t i=0; i<h.m_nTableSize; i++){
+    const PackEntry& e = m_pTable[i]; //shorthand
+    if(e.m_nHash == 0)continue; //empty slot
+
+    if((uint64_t)e.m_nNameOffset + e.m_nNameLength > m_nSize ||
+       e.m_nOffset > m_nSize || e.m_nSize > m_nSize - e.m_nOffset)
+      return false;
+  } //for
+
+  return true;
+} //Validate
+
+/// Unmap the pack file and close it.
+
+void CAssetPack::Close(){
+  if(m_pBase)UnmapViewOfFile(m_pBase);
+  if(m_hMapping)CloseHandle(m_hMapping);
+  if(m_hFile)CloseHandle(m_hFile);
+
+  m_pBase = nullptr;
+  m_hMapping = nullptr;
+  m_hFile = nullptr;
+  m_pHeader = nullptr;
+  m_pTable = nullptr;
+  m_nSize = 0;
+} //Close
+
+/// Find an asset in the pack by probing the table of contents linearly from
+/// the slot given by the hash of its name. The stored name is compared too,
+/// so that a hash collision can't return the wrong asset.
+/// \param filename Asset file name, with either kind of slash.
+/// \param p [out] Pointer to the asset data in the mapped file.
+/// \param n [out] Size of the asset data in bytes.
+/// \return true if the asset is in the pack.
+
+const bool CAssetPack::Find(const char* filename, const char*& p, size_t& n) const{
+  if(m_pTable == nullptr)return false; //no pack
+
+  const size_t len = strlen(filename); //length of name
+  const uint64_t hash = PackHash(filename, len); //hash of name
+  const uint32_t mask = m_pHeader->m_nTableSize - 1; //for wrapping slot index
+
+  for(uint32_t i=(uint32_t)hash & mask; m_pTable[i].m_nHash != 0; i=(i + 1) & mask){
+    const PackEntry& e = m_pTable[i]; //shorthand
+    if(e.m_nHash != hash || e.m_nNameLength != len)continue;
+
+    const char* name = (const char*)m_pBase + e.m_nNameOffset; //stored name
+    size_t j = 0; //index into names
+    while(j < len && name[j] == PackNormalize(filename[j]))j++;
+
+    if(j == len){ //found it
+      p = (const char*)m_pBase + e.m_nOffset;
+      n = (size_t)e.m_nSize;
+      return true;
+    } //if
+  } //for
+
+  return false;
+} //Find
+
+/// Get the contents of an asset. If it is in the pack, this is a pointer into
+/// the mapped file. Otherwise the loose file is read into a buffer supplied
+/// by the caller, and the pointer points into that.
+/// \param filename Asset file name.
+/// \param p [out] Pointer to the asset data.
+/// \param n [out] Size of the asset data in bytes.
+/// \param buffer Storage for the data if it is read from a loose file.
+/// \return true if the asset was found in the pack or on disk.
+
+const bool CAssetPack::Load(const char* filename, const char*& p, size_t& n,
+  std::vector<char>& buffer) const
+{
+  if(Find(filename, p, n))return true; //zero copy
+
+  FILE *input; //input file handle
+  fopen_s(&input, filename, "rb");
+  if(input == nullptr)return false; //not found
+
+  fseek(input, 0, SEEK_END); //seek to end of file
+  n = (size_t)ftell(input); //get file size in bytes
+  rewind(input); //seek to start of file
+
+  buffer.resize(n + 1); //room for a terminating null
+  n = fread(buffer.data(), 1, n, input);
+  buffer[n] = 0;
+  fclose(input);
+
+  p = buffer.data();
+  return true;
+} //Load
+
+/// Reader function for whether a pack is mapped.
+/// \return true if a pack is mapped.
+
+const bool CAssetPack::IsOpen() const{
+  return m_pBase != nullptr;
+} //IsOpen
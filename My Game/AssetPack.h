@@ -0,0 +1,104 @@
+/// \file AssetPack.h
+/// \brief Interface for the asset pack CAssetPack.
+
+#ifndef __L4RC_GAME_ASSETPACK_H__
+#define __L4RC_GAME_ASSETPACK_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/// \brief Asset pack file header.
+///
+/// An asset pack starts with this header. It is followed by the table of
+/// contents, which is an open-addressed hash table of `PackEntry` records
+/// whose size is a power of two, then the asset names, then the asset data.
+/// Each asset starts on a `PACK_ALIGN` boundary so that reading one asset
+/// only faults in the pages that hold it.
+
+struct PackHeader{
+  char m_chMagic[4]; ///< File signature, `PACK_MAGIC`.
+  uint32_t m_nVersion; ///< Format version, `PACK_VERSION`.
+  uint32_t m_nNumEntries; ///< Number of assets.
+  uint32_t m_nTableSize; ///< Number of table slots, a power of two.
+}; //PackHeader
+
+/// \brief Asset pack table of contents entry.
+///
+/// A slot with a zero hash is empty.
+
+struct PackEntry{
+  uint64_t m_nHash; ///< Hash of normalized asset name.
+  uint64_t m_nOffset; ///< Offset of data from start of file.
+  uint64_t m_nSize; ///< Size of data in bytes.
+  uint32_t m_nNameOffset; ///< Offset of name from start of file.
+  uint32_t m_nNameLength; ///< Length of name in bytes.
+}; //PackEntry
+
+static const char PACK_MAGIC[4] = {'L', '4', 'P', 'K'}; ///< Pack file signature.
+static const uint32_t PACK_VERSION = 1; ///< Pack format version.
+static const uint64_t PACK_ALIGN = 4096; ///< Alignment of asset data.
+
+/// Normalize an asset file name to the form used in the table of contents,
+/// which is lower case with forward slashes, so that names written with
+/// either kind of slash find the same asset.
+/// \param c A character from a file name.
+/// \return The normalized character.
+
+inline char PackNormalize(char c){
+  if(c == '\\')return '/';
+  if(c >= 'A' && c <= 'Z')return c - 'A' + 'a';
+  return c;
+} //PackNormalize
+
+/// Hash a normalized asset file name using 64-bit FNV-1a. Zero marks an
+/// empty table slot, so it is never returned.
+/// \param name Asset file name.
+/// \param n Length of name.
+/// \return Hash of the normalized name.
+
+inline uint64_t PackHash(const char* name, size_t n){
+  uint64_t h = 0xCBF29CE484222325ULL; //FNV offset basis
+
+  for(size_t i=0; i<n; i++){
+    h ^= (uint8_t)PackNormalize(name[i]);
+    h *= 0x100000001B3ULL; //FNV prime
+  } //for
+
+  return h == 0? 1: h;
+} //PackHash
+
+/// \brief The asset pack.
+///
+/// The asset pack maps a pack file into memory, so that opening the game's
+/// assets costs one file open and the operating system pages in the data as
+/// it is read. Assets are found by hashing their file name into the table of
+/// contents and are returned as pointers into the mapped file, so nothing is
+/// copied. Assets that are not in the pack, or all of them if there is no
+/// pack, are read from loose files instead.
+
+class CAssetPack{
+  private:
+    void* m_hFile = nullptr; ///< File handle.
+    void* m_hMapping = nullptr; ///< File mapping handle.
+    const uint8_t* m_pBase = nullptr; ///< Start of mapped file.
+    uint64_t m_nSize = 0; ///< Size of mapped file.
+
+    const PackHeader* m_pHeader = nullptr; ///< Pack header.
+    const PackEntry* m_pTable = nullptr; ///< Table of contents.
+
+    const bool Validate() const; ///< Check pack structure.
+
+  public:
+    ~CAssetPack(); ///< Destructor.
+
+    const bool Open(const char*); ///< Map a pack file.
+    void Close(); ///< Unmap the pack file.
+
+    const bool Find(const char*, const char*&, size_t&) const; ///< Find asset in pack.
+    const bool Load(const char*, const char*&, size_t&, std::vector<char>&) const; ///< Get asset from pack or file.
+
+    const bool IsOpen() const; ///< Whether a pack is mapped.
+}; //CAssetPack
+
+#endif //__L4RC_GAME_ASSETPACK_H__
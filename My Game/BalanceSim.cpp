@@ -0,0 +1,286 @@
+/// \file BalanceSim.cpp
+/// \brief Code for the balance harness CBalanceSim.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "BalanceSim.h"
+#include "ComponentIncludes.h"
+#include "ObjectManager.h"
+#include "BulletManager.h"
+#include "TileManager.h"
+#include "Player.h"
+#include "Helpers.h"
+#include "Log.h"
+
+static const float FRAME_TIME = 1.0f/60.0f; ///< Seconds per frame.
+static const UINT SIGHT_INTERVAL = 4; ///< Frames between looks for a target.
+static const float SIGHT_RANGE = 640.0f; ///< Furthest the bot shoots.
+
+/// Parse a tuning value, which is a single value, a comma-separated list,
+/// or a range `lo:hi:step`.
+/// \param s Text to parse.
+/// \return Values, which are empty if there are none.
+
+static std::vector<double> ParseList(const std::string& s){
+  std::vector<double> values; //result
+  double lo = 0, hi = 0, step = 0; //range
+
+  if(sscanf_s(s.c_str(), "%lf:%lf:%lf", &lo, &hi, &step) == 3 && step > 0){
+    for(double x=lo; x<=hi + 1e-9; x+=step)
+      values.push_back(x);
+  } //if
+
+  else{
+    std::stringstream ss(s); //list
+    std::string item; //current item
+
+    while(std::getline(ss, item, ','))
+      if(!item.empty())values.push_back(atof(item.c_str()));
+  } //else
+
+  return values;
+} //ParseList
+
+/// Get a percentile of a sorted list.
+/// \param v Sorted values.
+/// \param f Fraction, from 0 to 1.
+/// \return Percentile.
+
+static UINT Percentile(const std::vector<UINT>& v, double f){
+  return v[std::min(v.size() - 1, (size_t)(f*v.size()))];
+} //Percentile
+
+/// Read the options from the command line and make the combinations of
+/// tuning values to play.
+/// \param args Command line.
+
+CBalanceSim::CBalanceSim(const char* args){
+  const CTuning game; //the game's tuning values
+
+  std::vector<double> zombies = {(double)game.m_nNightZombies},
+    ramp = {(double)game.m_nNightRamp}, cooldown = {game.m_fShotCooldown},
+    zhealth = {(double)game.m_nZombieHealth}, zspeed = {game.m_fZombieSpeed};
+
+  std::istringstream ss(args); //command line arguments
+  std::string arg, val; //current argument and its value
+
+  while(ss >> arg){
+    if(arg == "-balance")ss >> m_nRuns;
+    else if(arg == "-map")ss >> m_strMap;
+    else if(arg == "-nights")ss >> m_nNightsToSurvive;
+    else if(arg == "-seed")ss >> m_nSeed;
+    else if(arg == "-threads")ss >> m_nThreads;
+    else if(arg == "-aim")ss >> m_fAim;
+    else if(arg == "-zombies" && ss >> val)zombies = ParseList(val);
+    else if(arg == "-ramp" && ss >> val)ramp = ParseList(val);
+    else if(arg == "-cooldown" && ss >> val)cooldown = ParseList(val);
+    else if(arg == "-zhealth" && ss >> val)zhealth = ParseList(val);
+    else if(arg == "-zspeed" && ss >> val)zspeed = ParseList(val);
+  } //while
+
+  m_nNightsToSurvive = std::max(m_nNightsToSurvive, 1U);
+
+  for(double a: zombies)for(double b: ramp)for(double c: cooldown)
+  for(double d: zhealth)for(double e: zspeed){
+    CTuning t; //combination of tuning values
+    t.m_nNightZombies = (UINT)std::max(a, 0.0);
+    t.m_nNightRamp = (UINT)std::max(b, 0.0);
+    t.m_fShotCooldown = (float)c;
+    t.m_nZombieHealth = (UINT)std::max(d, 1.0);
+    t.m_fZombieSpeed = (float)e;
+    m_vecTuning.push_back(t);
+  } //for
+} //constructor
+
+/// Play all of the games on a pool of worker threads, then write the results
+/// to the console and to `balance.txt`.
+/// \param bStop Set when asked to stop early.
+/// \return Exit code, 0 for success.
+
+const int CBalanceSim::Run(const std::atomic<bool>& bStop){
+  if(m_nRuns == 0 || m_vecTuning.empty()){
+    LOG_ERROR("No balance games to play.");
+    return 1;
+  } //if
+
+  const UINT threads = m_nThreads > 0? m_nThreads:
+    std::max(1U, std::thread::hardware_concurrency()); //number of workers
+
+  m_vecResults.assign(m_vecTuning.size()*m_nRuns, CBalanceResult());
+  m_nNext = 0;
+
+  printf("%s: %zu combinations x %u games on %u threads\n", m_strMap.c_str(),
+    m_vecTuning.size(), m_nRuns, threads);
+  fflush(stdout);
+
+  const auto start = std::chrono::steady_clock::now(); //start time
+
+  std::vector<std::thread> pool; //worker threads
+
+  for(UINT i=0; i<threads; i++)
+    pool.emplace_back(&CBalanceSim::Work, this, std::cref(bStop));
+
+  for(std::thread& t: pool)
+    t.join();
+
+  const double secs = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count(); //time taken
+  const size_t played = std::min(m_nNext.load(), m_vecResults.size()); //games played
+
+  FILE* output = nullptr; //report file
+  fopen_s(&output, "balance.txt", "wt");
+
+  for(FILE* f: {stdout, output})
+    if(f)Report(f, played, secs);
+
+  if(output)fclose(output);
+  return bStop? 1: 0;
+} //Run
+
+/// Worker thread. Make a world, load the map and create the level in it,
+/// and then play games in it until there are none left or it is asked to
+/// stop.
+/// \param bStop Set when asked to stop early.
+
+void CBalanceSim::Work(const std::atomic<bool>& bStop){
+  CWorld world((size_t)GetSpriteSize(eSprite::Tile).x, nullptr, m_nSeed); //this worker's world
+  world.m_fFrameTime = FRAME_TIME;
+  world.m_bMute = true;
+
+  world.m_pTileManager->LoadMap(m_strMap.c_str());
+  world.CreateLevel(true);
+
+  for(size_t i=m_nNext++; i<m_vecResults.size() && !bStop; i=m_nNext++)
+    m_vecResults[i] = Play(world, m_vecTuning[i/m_nRuns],
+      m_nSeed*2654435761u + (uint32_t)(i%m_nRuns));
+} //Work
+
+/// Play a game from the start of the level until the bot dies or survives
+/// enough nights, at 60 frames per second. The clock and the zombies and
+/// turrets that come out at night follow the same rules as in the game. A
+/// night counts as survived when it ends with the bot still alive.
+/// \param world World to play in, which has the level created.
+/// \param tuning Tuning values.
+/// \param seed Seed for the world's random number generator.
+/// \return Result.
+
+const CBalanceResult CBalanceSim::Play(CWorld& world, const CTuning& tuning,
+  uint32_t seed)
+{
+  world.m_cTuning = tuning;
+  world.m_cRandom.srand(seed);
+  world.m_pBulletManager->clear();
+  world.RestoreLevel();
+  world.gotBattery = world.gotAntenna = world.gotLogicBoard = false;
+
+  std::normal_distribution<float> aim(0.0f, m_fAim); //aiming error
+  const float r = 0.5f*GetSpriteSize(eSprite::Zombie2).x; //target radius
+  const Vector2 range(SIGHT_RANGE, SIGHT_RANGE); //half size of sight box
+  std::vector<UINT> found; //objects in sight box
+
+  CBalanceResult result; //result
+  UINT spawned = 0; //zombies and turrets that came out
+  bool bNight = false; //whether it is night
+  float fLastShot = -tuning.m_fShotCooldown; //time of last shot
+
+  for(UINT frame=0; world.m_pPlayer && result.m_nNights<m_nNightsToSurvive; frame++){
+    const float t = frame*FRAME_TIME; //time since start of level
+
+    if(CWorld::IsNight(CWorld::GetClockMinutes(t))){
+      if(!bNight)spawned += world.SpawnNight();
+      bNight = true;
+    } //if
+
+    else if(bNight){ //survived the night
+      result.m_nNights++;
+      bNight = false;
+    } //else if
+
+    if(frame%SIGHT_INTERVAL == 0 && t - fLastShot >= tuning.m_fShotCooldown){
+      CPlayer* pPlayer = world.m_pPlayer; //shorthand
+      const Vector2 p = pPlayer->GetPos(); //player position
+      const CObject* pTarget = nullptr; //nearest zombie or turret in sight
+      float fBest = SIGHT_RANGE*SIGHT_RANGE; //its distance squared
+
+      world.m_pObjectManager->Query(p - range, p + range, found);
+
+      for(UINT i: found){
+        const CObject* q = world.m_pObjectManager->GetQueryResult(i); //candidate
+        if(!q->isTurret() || q->isDead())continue; //zombies are flagged as turrets too
+
+        const float d = (q->m_vPos - p).LengthSquared(); //its distance squared
+
+        if(d < fBest && world.m_pTileManager->Visible(p, q->m_vPos, r)){
+          fBest = d;
+          pTarget = q;
+        } //if
+      } //for
+
+      if(pTarget){ //aim and fire
+        const Vector2 v = pTarget->m_vPos - p; //direction to target
+        const float a = atan2f(v.y, v.x) + aim(world.m_cRandom); //aim angle
+        pPlayer->SetRotation(a*180.0f/XM_PI);
+        world.m_pObjectManager->FireGun(pPlayer, eSprite::Bullet);
+        fLastShot = t;
+      } //if
+    } //if
+
+    world.m_pObjectManager->move();
+    world.m_pBulletManager->step();
+  } //for
+
+  const size_t alive = world.m_pObjectManager->GetNumZombies() +
+    world.m_pObjectManager->GetNumTurrets(); //zombies and turrets still alive
+  result.m_nKills = spawned - (UINT)std::min<size_t>(alive, spawned);
+
+  return result;
+} //Play
+
+/// Write the distribution of nights survived for each combination of tuning
+/// values, and how fast the games were played.
+/// \param f File to write to.
+/// \param played Number of games played.
+/// \param secs Time taken in seconds.
+
+void CBalanceSim::Report(FILE* f, size_t played, double secs) const{
+  const UINT n = m_nNightsToSurvive; //shorthand
+
+  fprintf(f, "zombies ramp cooldown zhealth zspeed | survived  mean p10 p50 p90 kills | nights survived 0..%u\n", n);
+
+  for(size_t c=0; c<m_vecTuning.size() && (c + 1)*m_nRuns<=played; c++){
+    const CTuning& t = m_vecTuning[c]; //tuning values
+    std::vector<UINT> nights(m_nRuns); //nights survived in each game
+    std::vector<UINT> histogram(n + 1, 0); //number of games surviving each number of nights
+    double total = 0, kills = 0; //totals
+
+    for(UINT i=0; i<m_nRuns; i++){
+      const CBalanceResult& res = m_vecResults[c*m_nRuns + i]; //result of game
+      nights[i] = res.m_nNights;
+      histogram[res.m_nNights]++;
+      total += res.m_nNights;
+      kills += res.m_nKills;
+    } //for
+
+    std::sort(nights.begin(), nights.end());
+
+    fprintf(f, "%7u %4u %8.2f %7u %6.2f | %7.1f%% %5.2f %3u %3u %3u %5.1f |",
+      t.m_nNightZombies, t.m_nNightRamp, t.m_fShotCooldown, t.m_nZombieHealth,
+      t.m_fZombieSpeed, 100.0*histogram[n]/m_nRuns, total/m_nRuns,
+      Percentile(nights, 0.1), Percentile(nights, 0.5), Percentile(nights, 0.9),
+      kills/m_nRuns);
+
+    for(UINT k: histogram)
+      fprintf(f, " %u", k);
+
+    fprintf(f, "\n");
+  } //for
+
+  fprintf(f, "\n%zu games in %.2f s, %.1f games per second\n", played, secs,
+    secs > 0? played/secs: 0.0);
+  fflush(f);
+} //Report
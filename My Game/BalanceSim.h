@@ -0,0 +1,68 @@
+/// \file BalanceSim.h
+/// \brief Interface for the balance harness CBalanceSim.
+
+#ifndef __L4RC_GAME_BALANCESIM_H__
+#define __L4RC_GAME_BALANCESIM_H__
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+#include "World.h"
+
+/// \brief Result of a balance game.
+
+struct CBalanceResult{
+  UINT m_nNights = 0; ///< Nights survived.
+  UINT m_nKills = 0; ///< Zombies and turrets killed.
+}; //CBalanceResult
+
+/// \brief The balance harness.
+///
+/// The balance harness plays thousands of seeded games of one map with a bot
+/// player that stays at home and shoots at the nearest zombie or turret that
+/// it can see, and reports how many nights the bot survives for each
+/// combination of the tuning values in `CTuning`. The games are played by
+/// the game's own object, bullet, and tile managers in worlds without a
+/// renderer, one world for each worker thread. Each worker loads the map and
+/// creates the level once, and restarts the level from its snapshot for each
+/// game. The world's random number generator is seeded from the base seed
+/// and the game number at the start of each game.
+///
+/// The options, each of which follows `-balance` and the number of games to
+/// play for each combination on the command line, are `-map` (map 1),
+/// `-nights` to survive (7), `-seed` (1), `-threads` (one per core), `-aim`
+/// for the bot's aiming error as a standard deviation in radians (0.05), and
+/// the tuning values `-zombies`, `-ramp`, `-cooldown`, `-zhealth`, and
+/// `-zspeed`, which default to the game's. Each tuning value is a single
+/// value, a comma-separated list, or a range `lo:hi:step`, and every
+/// combination of them is played.
+
+class CBalanceSim:
+  public CCommon
+{
+  private:
+    std::string m_strMap = "Media\\Maps\\map1.txt"; ///< Map file name.
+    UINT m_nRuns = 0; ///< Games per combination of tuning values.
+    UINT m_nNightsToSurvive = 7; ///< Nights to survive.
+    uint32_t m_nSeed = 1; ///< Base seed.
+    UINT m_nThreads = 0; ///< Worker threads, 0 for one per core.
+    float m_fAim = 0.05f; ///< Bot aiming error in radians.
+
+    std::vector<CTuning> m_vecTuning; ///< Combinations of tuning values.
+    std::vector<CBalanceResult> m_vecResults; ///< Results by combination, then game.
+    std::atomic<size_t> m_nNext{0}; ///< Next game to play.
+
+    void Work(const std::atomic<bool>&); ///< Play games until there are none left.
+    const CBalanceResult Play(CWorld&, const CTuning&, uint32_t); ///< Play a game.
+    void Report(FILE*, size_t, double) const; ///< Write the results.
+
+  public:
+    CBalanceSim(const char*); ///< Constructor.
+
+    const int Run(const std::atomic<bool>&); ///< Play the games and report.
+}; //CBalanceSim
+
+#endif //__L4RC_GAME_BALANCESIM_H__
@@ -0,0 +1,234 @@
+/// \file BulletManager.cpp
+/// \brief Code for the bullet manager CBulletManager.
+
+#include "BulletManager.h"
+#include "ComponentIncludes.h"
+#include "SpriteRenderer.h"
+#include "DrawList.h"
+#include "Particle.h"
+#include "ParticleEngine.h"
+#include "ObjectManager.h"
+#include "TileManager.h"
+#include "Helpers.h"
+#include "PositionHistory.h"
+#include "AllocTracker.h"
+#include "World.h"
+
+/// Reserve enough space for a few thousand bullets so that automatic weapons
+/// don't cause the arrays to be reallocated mid-game.
+/// \param pWorld Pointer to the world the bullet manager is part of.
+
+CBulletManager::CBulletManager(CWorld* pWorld): CCommon(pWorld){
+  const size_t n = 4096; //initial capacity
+
+  m_vecPos.reserve(n);
+  m_vecVel.reserve(n);
+  m_vecRoll.reserve(n);
+  m_vecRadius.reserve(n);
+  m_vecSprite.reserve(n);
+  m_vecCandidates.reserve(64);
+} //constructor
+
+/// Create a bullet by appending it to the end of the bullet arrays.
+/// \param t Sprite type of bullet.
+/// \param pos Initial position.
+/// \param vel Velocity.
+/// \param roll Orientation.
+
+void CBulletManager::create(eSprite t, const Vector2& pos, const Vector2& vel,
+  float roll)
+{
+  const Vector2 size = GetSpriteSize(t); //sprite width and height
+
+  m_vecPos.push_back(pos);
+  m_vecVel.push_back(vel);
+  m_vecRoll.push_back(roll);
+  m_vecRadius.push_back(std::max(size.x, size.y)/2);
+  m_vecSprite.push_back((UINT)t);
+} //create
+
+/// Remove all bullets.
+
+void CBulletManager::clear(){
+  m_vecPos.clear();
+  m_vecVel.clear();
+  m_vecRoll.clear();
+  m_vecRadius.clear();
+  m_vecSprite.clear();
+} //clear
+
+/// Remove a bullet by moving the last bullet into its place. Order doesn't
+/// matter, so this is constant time.
+/// \param i Index of bullet.
+
+void CBulletManager::remove(size_t i){
+  const size_t last = m_vecPos.size() - 1; //index of last bullet
+
+  m_vecPos[i] = m_vecPos[last];       m_vecPos.pop_back();
+  m_vecVel[i] = m_vecVel[last];       m_vecVel.pop_back();
+  m_vecRoll[i] = m_vecRoll[last];     m_vecRoll.pop_back();
+  m_vecRadius[i] = m_vecRadius[last]; m_vecRadius.pop_back();
+  m_vecSprite[i] = m_vecSprite[last]; m_vecSprite.pop_back();
+} //remove
+
+/// Find the first object that a bullet touches as it moves along its path for
+/// this step. Bullets hit every object except the activity, the same as when
+/// bullets were objects themselves, so the player and the radio parts stop
+/// them too, although only the zombies and turrets are hurt. Only the objects that the object
+/// manager's spatial grid reports near the path are tested. For lag
+/// compensation the zombies and turrets can be tested where they were at
+/// the end of a past tick instead of where they are now, in which case the
+/// query is grown by the most that they can have moved since then, and
+/// the ones that didn't exist then are ignored.
+/// \param p Bullet position at start of step.
+/// \param v Bullet displacement this step.
+/// \param r Bullet radius.
+/// \param t [in, out] Fraction of v at first contact. Objects hit later than
+/// this are ignored.
+/// \param norm [out] Collision normal pointing from object to bullet.
+/// \param pHistory Position history for a past tick, or `nullptr` for now.
+/// \param tick Past tick.
+/// \return Pointer to object hit, or `nullptr` if none.
+
+CObject* CBulletManager::FindTarget(const Vector2& p, const Vector2& v, float r,
+  float& t, Vector2& norm, const CPositionHistory* pHistory, UINT tick)
+{
+  const float d = pHistory? pHistory->GetDrift(tick): 0.0f; //movement since then
+  const Vector2 q = p + t*v; //end of path
+  const Vector2 vr(r + d, r + d); //bullet half-size, and movement
+  const Vector2 lo = Vector2(std::min(p.x, q.x), std::min(p.y, q.y)) - vr; //bottom left
+  const Vector2 hi = Vector2(std::max(p.x, q.x), std::max(p.y, q.y)) + vr; //top right
+
+  m_vecCandidates.clear();
+  m_pWorld->m_pObjectManager->Query(lo, hi, m_vecCandidates);
+
+  CObject* pHit = nullptr; //object hit
+
+  for(UINT i: m_vecCandidates){
+    CObject* pObj = m_pWorld->m_pObjectManager->GetQueryResult(i); //candidate object
+    const eObjectType type = pObj->m_eObjectType; //shorthand
+    const bool bMoving = type == eObjectType::Zombie || type == eObjectType::Turret;
+    Vector2 pos = pObj->m_vPos; //object position at that time
+    float t0 = 0; //time of contact
+
+    if(pObj->m_bDead || pObj->isActivity())
+      continue; //not a target
+
+    if(bMoving && pHistory && !pHistory->GetPos(pObj->m_nNetId, tick, pos.x, pos.y))
+      continue; //wasn't there then
+
+    if(SweepCircleVsCircle(p, v, r, pos, pObj->m_fRadius, t0) && t0 < t){ //earliest so far
+      t = t0;
+      norm = p + t0*v - pos; //from object to bullet at contact
+      norm.Normalize();
+      pHit = pObj;
+    } //if
+  } //for
+
+  return pHit;
+} //FindTarget
+
+/// Move a bullet one step and resolve its hit, if any. The bullet's bounding
+/// circle is swept along its path for the step, and it is stopped by the
+/// first wall or object that it touches. An object that is hit gets its
+/// `TakeHit()` response. A bullet that hits something is removed.
+/// \param i Index of bullet.
+/// \param pHistory Position history to find targets in, or `nullptr` for now.
+/// \param tick Past tick to find targets at.
+/// \return true if the bullet was removed.
+
+const bool CBulletManager::Advance(size_t i, const CPositionHistory* pHistory,
+  UINT tick)
+{
+  const Vector2 v = m_vecVel[i]*m_pWorld->m_fFrameTime; //displacement this step
+  const float r = m_vecRadius[i]; //bullet radius
+  float t = 1.0f; //fraction of displacement at first contact
+  Vector2 norm; //collision normal
+
+  const bool bWall = m_pWorld->m_pTileManager->SweepWalls(m_vecPos[i], v, r, t, norm);
+  CObject* pObj = FindTarget(m_vecPos[i], v, r, t, norm, pHistory, tick);
+
+  if(pObj || bWall){ //hit something
+    m_vecPos[i] += t*v; //move to point of contact
+
+    if(pObj)pObj->TakeHit(-norm); //object was hit
+    else if(!m_pWorld->m_bMute)m_pAudio->play(eSound::Ricochet); //wall was hit
+
+    DeathFX(m_vecPos[i]);
+    remove(i);
+    return true;
+  } //if
+
+  m_vecPos[i] += v; //nothing in the way
+  return false;
+} //Advance
+
+/// Move all bullets and resolve their hits in one pass over the bullet
+/// arrays.
+
+void CBulletManager::step(){
+  for(size_t i=0; i<m_vecPos.size();) //for each bullet
+    if(!Advance(i))i++;
+} //step
+
+/// Lag compensation for the bullet that was created last, which must have
+/// just been fired by a network client that was looking at the world as it
+/// was at the end of a past tick. The bullet is moved one step for each tick
+/// from then until the newest tick in the position history, and at each of
+/// those steps it is tested against where the zombies and turrets were at
+/// that tick, which is what the client saw. An object that it hits and that
+/// is still alive takes the hit now. After this the bullet moves with the
+/// others.
+/// \param history Position history.
+/// \param from Tick that the client was looking at.
+
+void CBulletManager::CatchUp(const CPositionHistory& history, UINT from){
+  if(m_vecPos.empty() || from == 0)return;
+
+  const size_t i = m_vecPos.size() - 1; //newest bullet
+
+  for(UINT tick=std::max(from, (UINT)history.GetOldest()); tick<history.GetNewest(); tick++)
+    if(Advance(i, &history, tick))
+      break;
+} //CatchUp
+
+/// Create a smoke particle effect to mark the death of a bullet.
+/// \param pos Position of bullet.
+
+void CBulletManager::DeathFX(const Vector2& pos){
+  if(m_pWorld->m_pParticleEngine == nullptr)return; //nobody to see it
+  const CAllocScope scope(eAlloc::Particles); //charge to particles
+  LParticleDesc2D d; //particle descriptor
+
+  d.m_nSpriteIndex = (UINT)eSprite::Smoke;
+  d.m_vPos = pos;
+  d.m_fLifeSpan = 0.5f;
+  d.m_fMaxScale = 0.5f;
+  d.m_fScaleInFrac = 0.2f;
+  d.m_fFadeOutFrac = 0.8f;
+  d.m_fScaleOutFrac = d.m_fFadeOutFrac;
+
+  m_pWorld->m_pParticleEngine->create(d); //create particle
+} //DeathFX
+
+/// Add the bullets to the draw list in their own layer over the objects, so
+/// that they are sorted into one batch per bullet sprite when the draw list
+/// is flushed.
+
+void CBulletManager::Draw(){
+  LSpriteDesc2D desc; //sprite descriptor
+
+  for(size_t i=0; i<m_vecPos.size(); i++){
+    desc.m_nSpriteIndex = m_vecSprite[i];
+    desc.m_vPos = m_vecPos[i];
+    desc.m_fRoll = m_vecRoll[i];
+    m_pDrawList->Add(eDrawLayer::Bullet, desc);
+  } //for
+} //Draw
+
+/// Reader function for the number of bullets.
+/// \return Number of bullets in flight.
+
+const size_t CBulletManager::GetNumBullets() const{
+  return m_vecPos.size();
+} //GetNumBullets
@@ -0,0 +1,62 @@
+/// \file BulletManager.h
+/// \brief Interface for the bullet manager CBulletManager.
+
+#ifndef __L4RC_GAME_BULLETMANAGER_H__
+#define __L4RC_GAME_BULLETMANAGER_H__
+
+#include <vector>
+
+#include "Common.h"
+#include "Component.h"
+#include "SpriteDesc.h"
+#include "GameDefines.h"
+
+class CObject;
+class CPositionHistory;
+
+/// \brief The bullet manager.
+///
+/// Bullets are not game objects. They are kept in flat arrays of position,
+/// velocity, orientation, and size so that they can be advanced and tested
+/// for hits in one pass over the arrays. A bullet lives until it hits
+/// something, and the edges of the map count as walls. Hits against walls
+/// are found by sweeping each bullet's bounding circle past the wall tiles
+/// near its path. Hits against zombies, turrets, and
+/// static objects are found from the object manager's spatial grid, so that
+/// each bullet only tests the objects near its path. A bullet fired by a
+/// network client can be caught up to the present against the positions
+/// that the client saw, which come from a `CPositionHistory`.
+
+class CBulletManager:
+  public CCommon,
+  public LComponent
+{
+  private:
+    std::vector<Vector2> m_vecPos; ///< Bullet positions.
+    std::vector<Vector2> m_vecVel; ///< Bullet velocities.
+    std::vector<float> m_vecRoll; ///< Bullet orientations.
+    std::vector<float> m_vecRadius; ///< Bullet radii.
+    std::vector<UINT> m_vecSprite; ///< Bullet sprite indices.
+
+    std::vector<UINT> m_vecCandidates; ///< Objects near a bullet's path.
+
+    CObject* FindTarget(const Vector2&, const Vector2&, float, float&,
+      Vector2&, const CPositionHistory* = nullptr, UINT = 0); ///< Find first object a bullet hits.
+    const bool Advance(size_t, const CPositionHistory* = nullptr,
+      UINT = 0); ///< Move a bullet and resolve its hit.
+    void DeathFX(const Vector2&); ///< Death special effects.
+    void remove(size_t); ///< Remove a bullet.
+
+  public:
+    CBulletManager(CWorld*); ///< Constructor.
+
+    void create(eSprite, const Vector2&, const Vector2&, float); ///< Create a bullet.
+    void clear(); ///< Remove all bullets.
+    void step(); ///< Move bullets and resolve hits.
+    void CatchUp(const CPositionHistory&, UINT); ///< Lag compensation for newest bullet.
+    void Draw(); ///< Draw all bullets.
+
+    const size_t GetNumBullets() const; ///< Get number of bullets in flight.
+}; //CBulletManager
+
+#endif //__L4RC_GAME_BULLETMANAGER_H__
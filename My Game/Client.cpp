@@ -0,0 +1,107 @@
+/// \file Client.cpp
+/// \brief Code for the co-op client CClient.
+
+#include <cstring>
+
+#include "Client.h"
+#include "GameDefines.h"
+
+/// Constructor.
+/// \param tile Tile width and height in pixels, which must be the same as
+/// the server's.
+/// \param w Window width in pixels, which the server sends objects for.
+/// \param h Window height in pixels, which the server sends objects for.
+
+CClient::CClient(float tile, UINT w, UINT h):
+  m_nViewWidth(w), m_nViewHeight(h),
+  m_cCodec(tile, (uint32_t)eSprite::Size), m_vecPacket(NET_MAX_PACKET){
+} //constructor
+
+/// Open a socket on any free port and look up the server. UDP has no
+/// connection, so the server doesn't know about this client until its first
+/// input arrives.
+/// \param host Server host name or dotted IP address.
+/// \param port Server port.
+/// \param session Session to play in.
+/// \return true if the server was found.
+
+const bool CClient::Connect(const char* host, uint16_t port, UINT session){
+  m_nSession = session;
+  m_nSequence = m_nTick = 0;
+  m_cReceived.clear();
+
+  return m_cSocket.Open(0) && CUdpSocket::Resolve(host, port, m_cServer);
+} //Connect
+
+/// Send the player's input to the server, together with the tick of the
+/// newest snapshot received so that the server can encode against it, and
+/// the window size so that it knows what the player can see.
+/// \param buttons Buttons held down, a combination of the `NET_*` flags.
+/// \param rotation Player orientation in degrees.
+
+void CClient::SendInput(UINT buttons, float rotation){
+  CNetInput p = {}; //input packet
+  memcpy(p.m_chMagic, NET_MAGIC, 4);
+  p.m_eType = eNetPacket::Input;
+  p.m_nSession = m_nSession;
+  p.m_nSequence = ++m_nSequence;
+  p.m_nSnapshot = m_nTick;
+  p.m_nButtons = buttons;
+  p.m_fRotation = rotation;
+  p.m_nViewWidth = m_nViewWidth;
+  p.m_nViewHeight = m_nViewHeight;
+
+  m_cSocket.SendTo(m_cServer, &p, sizeof(p));
+} //SendInput
+
+/// Receive all of the snapshots waiting, decode the ones that are newer than
+/// the newest one so far, and output the newest. A snapshot whose baseline
+/// has already left the ring can't be decoded and is dropped, but the
+/// server will soon switch to a newer baseline.
+/// \param objects [out] Objects in the newest snapshot.
+/// \param player [out] Network identifier of this client's player, or 0 if
+/// dead.
+/// \return true if there was a newer snapshot.
+
+const bool CClient::Receive(std::vector<CNetObject>& objects, UINT& player){
+  static const std::vector<CNetQuantized> empty; //baseline of nothing
+  const std::vector<CNetQuantized>* pNewest = nullptr; //newest snapshot
+  CNetAddress from; //sender
+
+  for(;;){
+    const int n = m_cSocket.RecvFrom(from, m_vecPacket.data(), m_vecPacket.size()); //packet size
+    if(n < 0)break; //no more packets
+    if(!(from == m_cServer) || n < (int)sizeof(CNetSnapshot))continue; //not for us
+
+    CNetSnapshot h; //header
+    memcpy(&h, m_vecPacket.data(), sizeof(h));
+
+    if(memcmp(h.m_chMagic, NET_MAGIC, 4) || h.m_eType != eNetPacket::Snapshot ||
+      h.m_nSession != m_nSession || h.m_nTick <= m_nTick)
+      continue; //not for us, or late
+
+    const std::vector<CNetQuantized>* pBase = h.m_nBaseline?
+      m_cReceived.Find(h.m_nBaseline): &empty; //baseline
+    if(pBase == nullptr)continue; //baseline is too old
+
+    if(!m_cCodec.Decode(*pBase, m_vecPacket.data() + sizeof(h), n - sizeof(h), m_vecDecoded))
+      continue; //damaged
+
+    std::vector<CNetQuantized>& slot = m_cReceived.Add(h.m_nTick); //ring slot
+    slot.swap(m_vecDecoded); //old slot buffer is reused next time
+    pNewest = &slot;
+
+    player = h.m_nPlayer;
+    m_nTick = h.m_nTick;
+  } //for
+
+  if(pNewest)m_cCodec.Dequantize(*pNewest, objects);
+  return pNewest != nullptr;
+} //Receive
+
+/// Reader function for the tick of the newest snapshot received.
+/// \return Server tick, or 0 if none.
+
+const UINT CClient::GetTick() const{
+  return m_nTick;
+} //GetTick
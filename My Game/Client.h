@@ -0,0 +1,43 @@
+/// \file Client.h
+/// \brief Interface for the co-op client CClient.
+
+#ifndef __L4RC_GAME_CLIENT_H__
+#define __L4RC_GAME_CLIENT_H__
+
+#include <vector>
+
+#include "Net.h"
+
+/// \brief The co-op client.
+///
+/// The client sends the player's input to the server every frame and
+/// receives snapshots of the server's objects. It doesn't simulate anything
+/// itself. Snapshots that arrive late are dropped, so the game always shows
+/// the newest one. The snapshots received recently are kept, since the
+/// server encodes each snapshot against the newest one that the client has
+/// acknowledged, and it may not have heard about the very newest yet.
+
+class CClient{
+  private:
+    CUdpSocket m_cSocket; ///< Client socket.
+    CNetAddress m_cServer; ///< Server address.
+    UINT m_nSession = 0; ///< Session to play in.
+    UINT m_nSequence = 0; ///< Sequence number of last input sent.
+    UINT m_nTick = 0; ///< Tick of newest snapshot received, or 0 if none.
+    UINT m_nViewWidth = 0; ///< Window width in pixels.
+    UINT m_nViewHeight = 0; ///< Window height in pixels.
+    CSnapshotCodec m_cCodec; ///< Snapshot codec.
+    CSnapshotRing m_cReceived{NET_HISTORY}; ///< Snapshots received.
+    std::vector<CNetQuantized> m_vecDecoded; ///< Decoded snapshot buffer.
+    std::vector<uint8_t> m_vecPacket; ///< Packet buffer.
+
+  public:
+    CClient(float, UINT, UINT); ///< Constructor.
+
+    const bool Connect(const char*, uint16_t, UINT); ///< Connect to server.
+    void SendInput(UINT, float); ///< Send input.
+    const bool Receive(std::vector<CNetObject>&, UINT&); ///< Receive newest snapshot.
+    const UINT GetTick() const; ///< Get tick of newest snapshot.
+}; //CClient
+
+#endif //__L4RC_GAME_CLIENT_H__
@@ -7,20 +7,13 @@
 #include "Common.h"
 
 LSpriteRenderer* CCommon::m_pRenderer = nullptr;
-CObjectManager* CCommon::m_pObjectManager = nullptr;
-LParticleEngine2D* CCommon::m_pParticleEngine = nullptr;
-CTileManager* CCommon::m_pTileManager = nullptr; 
-
+CDrawList* CCommon::m_pDrawList = nullptr;
+CAssetPack* CCommon::m_pAssetPack = nullptr;
 bool CCommon::m_bDrawAABBs = false;
-bool CCommon::m_bGodMode = false;
 
-bool CCommon::gotBattery = false;
-bool CCommon::gotAntenna = false;
-bool CCommon::gotLogicBoard = false;
+/// Constructor.
+/// \param pWorld Pointer to the world this is part of, or `nullptr` if it
+/// isn't part of one.
 
-Vector2 CCommon::m_vWorldSize = Vector2::Zero;
-CPlayer* CCommon::m_pPlayer = nullptr;
-CActivity* CCommon::m_pActivity = nullptr;
-CHouse* CCommon::m_pHouse = nullptr;
-CShop* CCommon::m_pShop = nullptr;
-CRadioTower* CCommon::m_pRadioTower = nullptr;
+CCommon::CCommon(CWorld* pWorld): m_pWorld(pWorld){
+} //constructor
@@ -8,15 +8,10 @@
 
 //forward declarations to make the compiler less stroppy
 
-class CObjectManager; 
+class CDrawList;
+class CAssetPack;
 class LSpriteRenderer;
-class LParticleEngine2D;
-class CTileManager;
-class CPlayer;
-class CActivity;
-class CHouse;
-class CShop;
-class CRadioTower;
+class CWorld;
 
 /// \brief The common variables class.
 ///
@@ -25,28 +20,23 @@ class CRadioTower;
 /// singleton class means that we can avoid passing its member variables
 /// around as parameters, which makes the code minisculely faster, and more
 /// importantly, makes the code more readable by reducing function clutter.
+///
+/// The renderer, draw list, and asset pack are shared by the whole process.
+/// Everything else belongs to a world, which is a `CWorld`. Each game
+/// component points to the world that it is part of, so any number of worlds
+/// can exist at once, on whichever threads run them.
 
 class CCommon{
   protected:  
     static LSpriteRenderer* m_pRenderer; ///< Pointer to renderer.
-    static CObjectManager* m_pObjectManager; ///< Pointer to object manager.
-    static LParticleEngine2D* m_pParticleEngine; ///< Pointer to particle engine.
-    static CTileManager* m_pTileManager; ///< Pointer to tile manager. 
-
+    static CDrawList* m_pDrawList; ///< Pointer to draw list.
+    static CAssetPack* m_pAssetPack; ///< Pointer to asset pack.
     static bool m_bDrawAABBs; ///< Draw AABB flag.
-    static bool m_bGodMode; ///< God mode flag.
-    
-    static bool gotBattery;
-    static bool gotAntenna;
-    static bool gotLogicBoard;
-
-    static Vector2 m_vWorldSize; ///< World height and width.
-    static CPlayer* m_pPlayer; ///< Pointer to player character.
-    static CActivity* m_pActivity;
-    static CHouse* m_pHouse;
-    static CShop* m_pShop;
-    static CRadioTower* m_pRadioTower;
 
+    CWorld* m_pWorld = nullptr; ///< Pointer to the world this is part of.
+
+  public:
+    CCommon(CWorld* = nullptr); ///< Constructor.
 }; //CCommon
 
 #endif //__L4RC_GAME_COMMON_H__
\ No newline at end of file
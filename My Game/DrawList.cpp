@@ -0,0 +1,176 @@
+/// \file DrawList.cpp
+/// \brief Code for the sorted draw list CDrawList.
+
+#include "DrawList.h"
+#include "SpriteRenderer.h"
+
+/// Reserve enough space for a screen full of tiles and objects so that the
+/// arrays aren't reallocated every frame.
+/// \param pSink Pointer to where the sprites go, or `nullptr` (the default)
+/// for the renderer.
+
+CDrawList::CDrawList(CDrawSink* pSink): m_pSink(pSink){
+  const size_t n = 4096; //initial capacity
+
+  m_vecDesc.reserve(n);
+  m_vecKey.reserve(n);
+  m_vecTemp.reserve(n);
+} //constructor
+
+/// Zero the batch break counts, which are added up over the flushes made
+/// during a frame.
+
+void CDrawList::BeginFrame(){
+  m_nBreaksBefore = m_nBreaksAfter = 0;
+} //BeginFrame
+
+/// Add a sprite to the draw list. Its sort key is made from the layer, the
+/// sprite index, and its position in the draw list.
+/// \param layer Draw layer.
+/// \param desc Sprite descriptor.
+
+void CDrawList::Add(eDrawLayer layer, const LSpriteDesc2D& desc){
+  const UINT64 key = ((UINT64)layer << 56) |
+    ((UINT64)(desc.m_nSpriteIndex & 0xFFFF) << 40) |
+    (UINT64)m_vecDesc.size(); //sort key
+
+  m_vecKey.push_back(key);
+  m_vecDesc.push_back(desc);
+} //Add
+
+/// Sort the keys using a least significant digit radix sort with 8-bit
+/// digits. Each pass is a stable counting sort on one byte of the key. A
+/// pass is skipped if all keys have the same value in that byte, which is
+/// the case for most of the high bytes of the submission order.
+
+void CDrawList::RadixSort(){
+  const size_t n = m_vecKey.size(); //number of keys
+  m_vecTemp.resize(n);
+
+  for(UINT shift=0; shift<64; shift+=8){ //for each byte
+    size_t count[257] = {0}; //start of each digit in the output
+
+    for(const UINT64 key: m_vecKey)
+      count[((key >> shift) & 0xFF) + 1]++;
+
+    if(count[((m_vecKey[0] >> shift) & 0xFF) + 1] == n)
+      continue; //all the same digit, nothing to do
+
+    for(UINT i=1; i<=256; i++)
+      count[i] += count[i - 1];
+
+    for(const UINT64 key: m_vecKey)
+      m_vecTemp[count[(key >> shift) & 0xFF]++] = key;
+
+    m_vecKey.swap(m_vecTemp);
+  } //for
+} //RadixSort
+
+/// Sort the draw list, unless sorting is off, and send its sprites to the
+/// renderer or the sink, then empty it ready for the next flush.
+
+void CDrawList::Flush(){
+  if(m_vecDesc.empty())return; //nothing to draw
+
+  for(size_t i=1; i<m_vecDesc.size(); i++)
+    if(m_vecDesc[i].m_nSpriteIndex != m_vecDesc[i - 1].m_nSpriteIndex)
+      m_nBreaksBefore++;
+
+  if(m_bSort)RadixSort();
+
+  const UINT64 mask = ((UINT64)1 << 40) - 1; //mask for submission order
+  UINT prev = m_vecDesc[m_vecKey[0] & mask].m_nSpriteIndex; //previous sprite
+
+  for(const UINT64 key: m_vecKey){
+    const LSpriteDesc2D& desc = m_vecDesc[key & mask]; //shorthand
+
+    if(desc.m_nSpriteIndex != prev){
+      m_nBreaksAfter++;
+      prev = desc.m_nSpriteIndex;
+    } //if
+
+    if(m_pSink)m_pSink->Draw((eDrawLayer)(key >> 56), desc);
+    else m_pRenderer->Draw(&desc);
+  } //for
+
+  m_vecDesc.clear();
+  m_vecKey.clear();
+} //Flush
+
+/// Turn sorting on or off. With sorting off the sprites are drawn in the
+/// order that they were added.
+/// \param bSort true to sort.
+
+void CDrawList::SetSorted(bool bSort){
+  m_bSort = bSort;
+} //SetSorted
+
+/// Reader function for the number of batch breaks in the order that the
+/// sprites were added during the flushes this frame.
+/// \return Number of batch breaks before sorting.
+
+const size_t CDrawList::GetBatchBreaksBefore() const{
+  return m_nBreaksBefore;
+} //GetBatchBreaksBefore
+
+/// Reader function for the number of batch breaks in the order that the
+/// sprites were drawn during the flushes this frame.
+/// \return Number of batch breaks after sorting.
+
+const size_t CDrawList::GetBatchBreaksAfter() const{
+  return m_nBreaksAfter;
+} //GetBatchBreaksAfter
+
+/// Record a sprite.
+/// \param layer Layer it was added to.
+/// \param desc Sprite descriptor.
+
+void CDrawRecorder::Draw(eDrawLayer layer, const LSpriteDesc2D& desc){
+  m_vecLayer.push_back(layer);
+  m_vecDesc.push_back(desc);
+} //Draw
+
+/// Forget the sprites recorded so far.
+
+void CDrawRecorder::clear(){
+  m_vecLayer.clear();
+  m_vecDesc.clear();
+} //clear
+
+/// Reader function for the number of sprites recorded.
+/// \return Number of sprites recorded.
+
+const size_t CDrawRecorder::GetSize() const{
+  return m_vecDesc.size();
+} //GetSize
+
+/// Reader function for the layer of a recorded sprite.
+/// \param i Index of sprite in the order recorded.
+/// \return Layer that it was added to.
+
+const eDrawLayer CDrawRecorder::GetLayer(size_t i) const{
+  return m_vecLayer[i];
+} //GetLayer
+
+/// Reader function for a recorded sprite.
+/// \param i Index of sprite in the order recorded.
+/// \return Sprite descriptor.
+
+const LSpriteDesc2D& CDrawRecorder::GetDesc(size_t i) const{
+  return m_vecDesc[i];
+} //GetDesc
+
+/// Count the batch breaks in the order that the sprites were recorded, that
+/// is, the number of times that consecutive sprites have different sprite
+/// indices.
+/// \return Number of batch breaks.
+
+const size_t CDrawRecorder::GetBatchBreaks() const{
+  size_t n = 0; //number of batch breaks
+
+  for(size_t i=1; i<m_vecDesc.size(); i++)
+    if(m_vecDesc[i].m_nSpriteIndex != m_vecDesc[i - 1].m_nSpriteIndex)
+      n++;
+
+  return n;
+} //GetBatchBreaks
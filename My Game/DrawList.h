@@ -0,0 +1,92 @@
+/// \file DrawList.h
+/// \brief Interface for the sorted draw list CDrawList.
+
+#ifndef __L4RC_GAME_DRAWLIST_H__
+#define __L4RC_GAME_DRAWLIST_H__
+
+#include <vector>
+
+#include "Common.h"
+#include "SpriteDesc.h"
+#include "GameDefines.h"
+
+/// \brief A draw sink.
+///
+/// Somewhere that a draw list can send its sprites instead of to the
+/// renderer, together with the layer that each was added to.
+
+class CDrawSink{
+  public:
+    virtual ~CDrawSink(){} ///< Destructor.
+    virtual void Draw(eDrawLayer, const LSpriteDesc2D&) = 0; ///< Draw a sprite.
+}; //CDrawSink
+
+/// \brief A recording draw sink.
+///
+/// A draw sink that records the sprites sent to it in the order that they
+/// arrive, so that what a draw list would have drawn can be checked without
+/// a renderer.
+
+class CDrawRecorder:
+  public CDrawSink
+{
+  private:
+    std::vector<eDrawLayer> m_vecLayer; ///< Layers in the order drawn.
+    std::vector<LSpriteDesc2D> m_vecDesc; ///< Sprites in the order drawn.
+
+  public:
+    virtual void Draw(eDrawLayer, const LSpriteDesc2D&); ///< Record a sprite.
+    void clear(); ///< Forget the sprites recorded.
+
+    const size_t GetSize() const; ///< Get number of sprites recorded.
+    const eDrawLayer GetLayer(size_t) const; ///< Get layer of a recorded sprite.
+    const LSpriteDesc2D& GetDesc(size_t) const; ///< Get a recorded sprite.
+    const size_t GetBatchBreaks() const; ///< Get batch breaks in recorded order.
+}; //CDrawRecorder
+
+/// \brief A sorted draw list.
+///
+/// Sprites are not sent to the renderer as they are drawn. Instead they are
+/// added to the draw list with a 64-bit sort key made up of the draw layer in
+/// the top 8 bits, the sprite index in the next 16 bits, and the order in
+/// which the sprite was added in the bottom 40 bits. The submission order
+/// stands in for depth, since later sprites are drawn over earlier ones. When
+/// the draw list is flushed the keys are radix sorted and the sprites are
+/// sent to the renderer in key order, so that sprites with the same texture
+/// in the same layer end up next to each other in one batch. The number of
+/// batch breaks, that is, the number of times that consecutive sprites have
+/// different sprite indices, is counted before and after sorting, and added
+/// up over the flushes since `BeginFrame()`. The sprites can be sent to a
+/// draw sink instead of the renderer, and sorting can be turned off so that
+/// they are drawn in the order added, which is how they were drawn before
+/// there was a draw list.
+
+class CDrawList:
+  public CCommon
+{
+  private:
+    std::vector<LSpriteDesc2D> m_vecDesc; ///< Sprites in the order added.
+    std::vector<UINT64> m_vecKey; ///< Sort keys.
+    std::vector<UINT64> m_vecTemp; ///< Scratch space for radix sort.
+
+    size_t m_nBreaksBefore = 0; ///< Batch breaks in the order added.
+    size_t m_nBreaksAfter = 0; ///< Batch breaks in sorted order.
+
+    CDrawSink* m_pSink = nullptr; ///< Where sprites go, or nullptr for the renderer.
+    bool m_bSort = true; ///< Whether to sort before drawing.
+
+    void RadixSort(); ///< Sort the keys.
+
+  public:
+    CDrawList(CDrawSink* = nullptr); ///< Constructor.
+
+    void BeginFrame(); ///< Start counting batch breaks for a new frame.
+    void Add(eDrawLayer, const LSpriteDesc2D&); ///< Add a sprite.
+    void Flush(); ///< Sort and draw all sprites.
+    void SetSorted(bool); ///< Turn sorting on or off.
+
+    const size_t GetBatchBreaksBefore() const; ///< Get batch breaks before sorting.
+    const size_t GetBatchBreaksAfter() const; ///< Get batch breaks after sorting.
+}; //CDrawList
+
+#endif //__L4RC_GAME_DRAWLIST_H__
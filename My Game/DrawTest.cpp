@@ -0,0 +1,222 @@
+/// \file DrawTest.cpp
+/// \brief Code for the draw test CDrawTest.
+
+#include <cstdio>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "DrawTest.h"
+#include "ComponentIncludes.h"
+#include "ObjectManager.h"
+#include "BulletManager.h"
+#include "TileManager.h"
+#include "World.h"
+#include "Player.h"
+#include "Helpers.h"
+#include "Log.h"
+
+static const char* DRAWTEST_MAP = "Media\\Maps\\map1.txt"; ///< Map drawn.
+static const Vector2 DRAWTEST_VIEW(1280.0f, 720.0f); ///< Size of view drawn.
+
+/// Whether two sprite descriptors would draw the same thing.
+/// \param a A sprite descriptor.
+/// \param b Another sprite descriptor.
+/// \return true if they are the same.
+
+static bool Same(const LSpriteDesc2D& a, const LSpriteDesc2D& b){
+  return a.m_nSpriteIndex == b.m_nSpriteIndex &&
+    a.m_nCurrentFrame == b.m_nCurrentFrame &&
+    a.m_vPos.x == b.m_vPos.x && a.m_vPos.y == b.m_vPos.y &&
+    a.m_fRoll == b.m_fRoll && a.m_fAlpha == b.m_fAlpha &&
+    a.m_fXScale == b.m_fXScale && a.m_fYScale == b.m_fYScale &&
+    a.m_f4Tint.x == b.m_f4Tint.x && a.m_f4Tint.y == b.m_f4Tint.y &&
+    a.m_f4Tint.z == b.m_f4Tint.z && a.m_f4Tint.w == b.m_f4Tint.w;
+} //Same
+
+/// Set up a level to draw and run the test on it.
+/// \return Exit code, 0 if the test passed.
+
+const int CDrawTest::Run(){
+  m_pDrawList = new CDrawList(&m_cRecorder); //draw to the recorder
+
+  CWorld world((size_t)GetSpriteSize(eSprite::Tile).x, nullptr, 1); //world to draw
+  world.m_fFrameTime = 1.0f/60.0f;
+  world.m_bMute = true;
+
+  world.m_pTileManager->LoadMap(DRAWTEST_MAP);
+  const Vector2 start = world.CreateLevel(true); //player start
+  world.SpawnNight();
+
+  for(UINT t=0; t<60; t++){ //a second of play, firing now and then
+    if(world.m_pPlayer && t%10 == 0){
+      world.m_pPlayer->SetRotation(t*6.0f);
+      world.m_pObjectManager->FireGun(world.m_pPlayer, eSprite::Bullet);
+    } //if
+
+    world.m_pObjectManager->move();
+    world.m_pBulletManager->step();
+  } //for
+
+  const Vector2 lo = start - 0.5f*DRAWTEST_VIEW; //bottom left of view
+  const Vector2 hi = start + 0.5f*DRAWTEST_VIEW; //top right of view
+
+  bool bPassed = TestDrawList(world, lo, hi); //whether the test passed
+
+  const Vector2 size = world.m_vWorldSize; //world size
+  size_t views = 0; //number of views checked
+
+  for(float y=-0.5f*DRAWTEST_VIEW.y; y<size.y; y+=0.5f*DRAWTEST_VIEW.y) //views overlapping each other and the edges
+    for(float x=-0.5f*DRAWTEST_VIEW.x; x<size.x; x+=0.5f*DRAWTEST_VIEW.x, views++)
+      bPassed = TestTiles(world, Vector2(x, y), Vector2(x, y) + DRAWTEST_VIEW) && bPassed;
+
+  printf("Tile chunks: %zu views checked.\n", views);
+
+  delete m_pDrawList;
+  m_pDrawList = nullptr;
+
+  printf(bPassed? "Draw test passed.\n": "Draw test FAILED.\n");
+  return bPassed? 0: 1;
+} //Run
+
+/// Draw a frame with the draw list sorted and unsorted, and check that the
+/// sorted frame draws the same sprites in layer order, with the sprites of
+/// each type in each layer in the order that they were added, and that the
+/// batch breaks that the draw list counts are the ones recorded.
+/// \param world World to draw.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+/// \return true if the checks passed.
+
+const bool CDrawTest::TestDrawList(CWorld& world, const Vector2& lo, const Vector2& hi){
+  m_pDrawList->SetSorted(false);
+  m_cRecorder.clear();
+  world.m_pObjectManager->DrawView(lo, hi);
+
+  const CDrawRecorder added = m_cRecorder; //sprites in the order added
+  const size_t before = m_pDrawList->GetBatchBreaksBefore(); //batch breaks unsorted
+
+  m_pDrawList->SetSorted(true);
+  m_cRecorder.clear();
+  world.m_pObjectManager->DrawView(lo, hi);
+
+  const CDrawRecorder& sorted = m_cRecorder; //sprites in the order drawn
+  const size_t after = m_pDrawList->GetBatchBreaksAfter(); //batch breaks sorted
+  bool bPassed = true; //whether the checks have passed so far
+
+  if(added.GetSize() == 0 || sorted.GetSize() != added.GetSize()){
+    LOG_ERROR("Draw list drew %zu sprites, expected %zu.", sorted.GetSize(), added.GetSize());
+    bPassed = false;
+  } //if
+
+  for(size_t i=1; i<sorted.GetSize(); i++)
+    if(sorted.GetLayer(i) < sorted.GetLayer(i - 1)){
+      LOG_ERROR("Draw list sprite %zu is in a lower layer than the one before.", i);
+      bPassed = false;
+      break;
+    } //if
+
+  //the sprites of each type in each layer, in the order added and drawn
+
+  typedef std::pair<UINT, UINT> CRun; //layer and sprite index
+  std::map<CRun, std::vector<size_t>> a, b; //indices by layer and sprite index
+
+  for(size_t i=0; i<added.GetSize(); i++)
+    a[CRun((UINT)added.GetLayer(i), added.GetDesc(i).m_nSpriteIndex)].push_back(i);
+
+  for(size_t i=0; i<sorted.GetSize(); i++)
+    b[CRun((UINT)sorted.GetLayer(i), sorted.GetDesc(i).m_nSpriteIndex)].push_back(i);
+
+  for(const auto& run: a){
+    const std::vector<size_t>& u = run.second; //in the order added
+    const std::vector<size_t>& v = b[run.first]; //in the order drawn
+    bool bSame = u.size() == v.size(); //whether they match
+
+    for(size_t i=0; i<u.size() && bSame; i++)
+      bSame = Same(added.GetDesc(u[i]), sorted.GetDesc(v[i]));
+
+    if(!bSame){
+      LOG_ERROR("Draw list changed the sprites of type %u in layer %u.",
+        run.first.second, run.first.first);
+      bPassed = false;
+    } //if
+  } //for
+
+  if(added.GetBatchBreaks() != before || sorted.GetBatchBreaks() != after){
+    LOG_ERROR("Draw list counted %zu and %zu batch breaks, recorded %zu and %zu.",
+      before, after, added.GetBatchBreaks(), sorted.GetBatchBreaks());
+    bPassed = false;
+  } //if
+
+  if(after > before){
+    LOG_ERROR("Sorting made more batch breaks, %zu instead of %zu.", after, before);
+    bPassed = false;
+  } //if
+
+  printf("Draw list: %zu sprites, %zu batch breaks unsorted, %zu sorted.\n",
+    sorted.GetSize(), before, after);
+
+  return bPassed;
+} //TestDrawList
+
+/// Draw the tiles in a view from the chunks and one at a time, and check
+/// that every tile drawn one at a time is drawn the same from the chunks,
+/// and that every other tile drawn from the chunks is out of view. Tiles
+/// don't overlap, so the order that they are drawn in doesn't matter.
+/// \param world World to draw.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+/// \return true if the checks passed.
+
+const bool CDrawTest::TestTiles(CWorld& world, const Vector2& lo, const Vector2& hi){
+  m_pDrawList->BeginFrame();
+
+  m_cRecorder.clear();
+  world.m_pTileManager->DrawTiles(eSprite::Tile, lo, hi);
+  m_pDrawList->Flush();
+  const CDrawRecorder tiles = m_cRecorder; //tiles drawn one at a time
+
+  m_cRecorder.clear();
+  world.m_pTileManager->Draw(eSprite::Tile, lo, hi);
+  m_pDrawList->Flush();
+  const CDrawRecorder& chunks = m_cRecorder; //tiles drawn from chunks
+
+  typedef std::tuple<float, float> CPos; //tile position
+  std::map<CPos, size_t> drawn; //index of chunk sprite at each position
+
+  for(size_t i=0; i<chunks.GetSize(); i++)
+    drawn[CPos(chunks.GetDesc(i).m_vPos.x, chunks.GetDesc(i).m_vPos.y)] = i;
+
+  size_t matched = 0; //number of tiles drawn the same both ways
+  const float r = 0.5f*GetSpriteSize(eSprite::Tile).x; //half tile size
+
+  for(size_t i=0; i<tiles.GetSize(); i++){
+    const LSpriteDesc2D& desc = tiles.GetDesc(i); //tile drawn one at a time
+    const auto p = drawn.find(CPos(desc.m_vPos.x, desc.m_vPos.y)); //same tile from chunks
+
+    if(p == drawn.end() || !Same(desc, chunks.GetDesc(p->second))){
+      LOG_ERROR("Tile at %.0f, %.0f is not drawn the same from the chunks.",
+        desc.m_vPos.x, desc.m_vPos.y);
+      return false;
+    } //if
+
+    matched++;
+  } //for
+
+  for(size_t i=0; i<chunks.GetSize(); i++){
+    const Vector2& v = chunks.GetDesc(i).m_vPos; //tile position
+    const bool bInView = v.x + r > lo.x && v.x - r < hi.x &&
+      v.y + r > lo.y && v.y - r < hi.y; //whether it overlaps the view
+
+    if(bInView)matched--;
+  } //for
+
+  if(matched != 0){
+    LOG_ERROR("Chunks and tiles disagree about which tiles are in view %.0f, %.0f.",
+      lo.x, lo.y);
+    return false;
+  } //if
+
+  return true;
+} //TestTiles
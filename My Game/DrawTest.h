@@ -0,0 +1,39 @@
+/// \file DrawTest.h
+/// \brief Interface for the draw test CDrawTest.
+
+#ifndef __L4RC_GAME_DRAWTEST_H__
+#define __L4RC_GAME_DRAWTEST_H__
+
+#include "Common.h"
+#include "DrawList.h"
+
+/// \brief The draw test.
+///
+/// The draw test draws a frame of a level without a renderer, sending the
+/// draw list's sprites to a `CDrawRecorder` instead, and checks what was
+/// recorded. A level is started in a world of its own, the zombies and
+/// turrets are brought out, and a few shots are fired, so that there are
+/// tiles, objects, and bullets in view. The frame is drawn once with the
+/// draw list sorted and once in the order that the sprites were added. The
+/// sorted frame must have the same sprites, in layer order, with sprites of
+/// the same type in the same layer in the order that they were added, and
+/// no more batch breaks than the unsorted frame. The tiles are also drawn
+/// from the per-level chunks and one at a time, for views all over the map,
+/// and the chunks must draw every tile in view exactly as it is drawn one
+/// at a time. The results are written to the console, and the exit code says
+/// whether the checks passed.
+
+class CDrawTest:
+  public CCommon
+{
+  private:
+    CDrawRecorder m_cRecorder; ///< Records what the draw list draws.
+
+    const bool TestDrawList(CWorld&, const Vector2&, const Vector2&); ///< Check sorting.
+    const bool TestTiles(CWorld&, const Vector2&, const Vector2&); ///< Check tile chunks.
+
+  public:
+    const int Run(); ///< Run the test.
+}; //CDrawTest
+
+#endif //__L4RC_GAME_DRAWTEST_H__
@@ -18,155 +18,226 @@
 #include "Tree.h"
 #include <random>
 #include <algorithm>
+#include <chrono>
 #include "Shop.h"
 #include "RadioTower.h"
+#include "BulletManager.h"
+#include "DrawList.h"
+#include "AssetPack.h"
+#include "SaveGame.h"
+#include "Abort.h"
+#include "AllocTracker.h"
+#include "Log.h"
+#include "Helpers.h"
+#include <sstream>
 using namespace std;
 
 #include "shellapi.h"
-CObject* m_pRadio;
-bool radioOn = false;
-bool helpCalled = false;
 
+/// The sprites needed for this game, from the list in `SpriteList.h` that ties
+/// `eSprite` values from `GameDefines.h` to the names of sprite tags in
+/// `gamesettings.xml`. Those sprite tags contain the name of the corresponding
+/// image file. The first `NUM_TITLE_SPRITES` of them are the ones needed by
+/// the title and tutorial screens, plus the tile sprite, whose width is
+/// needed to set up the tile manager.
+
+static const struct{
+  eSprite m_eSprite; ///< Sprite type.
+  const char* m_pName; ///< Sprite tag name in gamesettings.xml.
+} SPRITES[] = {
+  #define SPRITE(e, name) {eSprite::e, name},
+  #include "SpriteList.h"
+  #undef SPRITE
+}; //SPRITES
+
+static const size_t NUM_SPRITES = sizeof(SPRITES)/sizeof(SPRITES[0]); ///< Number of sprites.
+static const size_t NUM_TITLE_SPRITES = 7; ///< Number of title screen sprites.
+
+static const char* SAVE_FILE = "save.dat"; ///< Save game file name.
 
 
-/// Delete the renderer, the object manager, and the tile manager. The renderer
+
+/// Delete the server, the client, the world, the managers, and the asset pack. The renderer
 /// needs to be deleted before this destructor runs so it will be done elsewhere.
 
 CGame::~CGame(){
-  delete m_pParticleEngine;
-  delete m_pObjectManager;
-  delete m_pTileManager;
+  if(m_futPrefetch.valid())m_futPrefetch.wait(); //let the prefetch finish
+  WaitForSave(); //let the save finish
+
+  delete m_pClient;
+  delete m_pWorld;
+  delete m_pDrawList;
+  delete m_pHud;
+  delete m_pTextCache;
+  delete m_pTriggerManager;
+  delete m_pNextTileManager;
   delete m_pMouse;
+  delete m_pAssetPack;
 } //destructor
 
 /// Initialize the renderer, the tile manager and the object manager, load 
 /// images and sounds, and begin the game.
 
 void CGame::Initialize(){
+  CLog::Start("game.log"); //write log messages in the background
+  m_pAssetPack = new CAssetPack; //set up the asset pack
+  m_pAssetPack->Open("Media\\media.pack"); //use loose files if there's no pack
+
   m_pRenderer = new LSpriteRenderer(eSpriteMode::Batched2D); 
   m_pRenderer->Initialize(eSprite::Size); 
-  LoadImages(); //load images from xml file list
+  LoadImages(NUM_TITLE_SPRITES); //load title screen images from xml file list
   
-  m_pTileManager = new CTileManager((size_t)m_pRenderer->GetWidth(eSprite::Tile), this);
-  m_pObjectManager = new CObjectManager; //set up the object manager 
+  const size_t tile = (size_t)GetSpriteSize(eSprite::Tile).x; //tile size
+  m_pWorld = new CWorld(tile, this, std::random_device()()); //set up the world
+  m_pNextTileManager = new CTileManager(nullptr, tile, this); //only reads maps
+  m_pMouse = new LMouse; //set up the mouse handler, once only
+
+  {
+    const CAllocScope scope(eAlloc::UI); //charge to the UI
+    m_pDrawList = new CDrawList; //set up the draw list
+    m_pHud = new CHud; //set up the heads-up display
+    m_pTextCache = new CTextCache; //set up the text cache
+    m_pTextCache->Load("Media\\Fonts\\PixelEmulator_18.spritefont");
+  }
+
+  m_pTriggerManager = new CTriggerManager; //set up the trigger volumes
+  m_pTriggerManager->SetCallback([&](eTrigger t, bool bEnter){
+    OnTrigger(t, bEnter);
+  }); //set trigger callback
   LoadSounds(); //load the sounds for this game
 
-  m_pParticleEngine = new LParticleEngine2D(m_pRenderer);
   m_eGameState = eGameState::Title;
   BeginGame();
+  StartNetwork(); //co-op, if asked for on the command line
 } //Initialize
 
-/// Load the specific images needed for this game. This is where `eSprite`
-/// values from `GameDefines.h` get tied to the names of sprite tags in
-/// `gamesettings.xml`. Those sprite tags contain the name of the corresponding
-/// image file. If the image tag or the image file are missing, then the game
-/// should abort from deeper in the Engine code leaving you with an error
-/// message in a dialog box.
+/// Connect to a co-op server, if asked to on the command line. `-connect`
+/// followed by a host name or IP address plays the levels on that server
+/// instead of locally, in session 0 or the one given by `-session`, on the
+/// default port or the one given by `-port`. Serving is done headless, by
+/// `CHeadless`, without the game.
+
+void CGame::StartNetwork(){
+  std::istringstream args(GetCommandLineA()); //command line arguments
+  std::string arg; //current argument
+  std::string host; //server to connect to
+  UINT port = NET_PORT; //server port
+  UINT session = 0; //session to play in
+
+  while(args >> arg){
+    if(arg == "-connect")args >> host;
+    else if(arg == "-port")args >> port;
+    else if(arg == "-session")args >> session;
+  } //while
+
+  if(!host.empty()){
+    m_pClient = new CClient(GetSpriteSize(eSprite::Tile).x,
+      (UINT)m_nWinWidth, (UINT)m_nWinHeight);
+
+    if(!m_pClient->Connect(host.c_str(), (uint16_t)port, session))
+      ABORT("Cannot find server %s.", host.c_str());
+  } //if
+} //StartNetwork
+
+/// Load the next few images from the sprite table in a single resource
+/// upload. The title screen sprites are loaded in `Initialize()` so that the
+/// title screen appears right away, and the rest are streamed in a few per
+/// frame while it is showing. The images are decoded and uploaded on the
+/// main thread, since the renderer's `Load()` takes an image tag and does
+/// both, and a resource upload can't be shared between threads. If the image
+/// tag or the image file are missing,
+/// then the game should abort from deeper in the Engine code leaving you with
+/// an error message in a dialog box.
+/// \param n Maximum number of images to load.
+
+void CGame::LoadImages(size_t n){
+  const size_t last = std::min(m_nImagesLoaded + n, NUM_SPRITES); //one past last image
+  if(m_nImagesLoaded >= last)return; //nothing to load
 
-void CGame::LoadImages(){  
   m_pRenderer->BeginResourceUpload();
 
-  m_pRenderer->Load(eSprite::Tile,    "tile"); 
-  m_pRenderer->Load(eSprite::Player,  "player");
-  m_pRenderer->Load(eSprite::Bullet,  "bullet");
-  m_pRenderer->Load(eSprite::Bullet2, "bullet2");
-  m_pRenderer->Load(eSprite::Smoke,   "smoke");
-  m_pRenderer->Load(eSprite::Spark,   "spark");
-  m_pRenderer->Load(eSprite::Turret,  "turret");
-  m_pRenderer->Load(eSprite::Line,    "greenline"); 
-  m_pRenderer->Load(eSprite::Activity, "activity");
-  m_pRenderer->Load(eSprite::House, "house");
-  m_pRenderer->Load(eSprite::Tree, "tree");
-  m_pRenderer->Load(eSprite::Title, "title");
-  m_pRenderer->Load(eSprite::HealthBar, "healthbar");
-  m_pRenderer->Load(eSprite::HealthBar80, "healthbar80");
-  m_pRenderer->Load(eSprite::HealthBar60, "healthbar60");
-  m_pRenderer->Load(eSprite::HealthBar40, "healthbar40");
-  m_pRenderer->Load(eSprite::HealthBar20, "healthbar20");
-  m_pRenderer->Load(eSprite::HealthBar0, "healthbar0");
-  m_pRenderer->Load(eSprite::Player2, "player2");
-  m_pRenderer->Load(eSprite::Turret2, "turret2");
-  m_pRenderer->Load(eSprite::Frame, "frame");
-  m_pRenderer->Load(eSprite::Sun, "sun");
-  m_pRenderer->Load(eSprite::Moon, "moon");
-  m_pRenderer->Load(eSprite::Corn, "corn");
-  m_pRenderer->Load(eSprite::HalfCorn, "halfcorn");
-  m_pRenderer->Load(eSprite::Zombie2, "zombie2");
-  m_pRenderer->Load(eSprite::Battery, "battery");
-  m_pRenderer->Load(eSprite::Shop, "shop");
-  m_pRenderer->Load(eSprite::ProgressFrame, "progressframe");
-  m_pRenderer->Load(eSprite::Percent, "percent");
-  m_pRenderer->Load(eSprite::MessageFrame, "messageframe");
-  m_pRenderer->Load(eSprite::Background2, "background");
-  m_pRenderer->Load(eSprite::NightFarm, "nightfarm");
-  m_pRenderer->Load(eSprite::MaxFood, "maxfood");
-  m_pRenderer->Load(eSprite::LogicBoard, "logicBoard");
-  m_pRenderer->Load(eSprite::Antenna, "antenna");
-  m_pRenderer->Load(eSprite::DeadRadio, "deadRadio");
-  m_pRenderer->Load(eSprite::AliveRadio, "aliveRadio");
-  m_pRenderer->Load(eSprite::Victory, "victory");
-  m_pRenderer->Load(eSprite::PressToFarm, "presstofarm");
-  m_pRenderer->Load(eSprite::PressToEat, "presstoeat");
-  m_pRenderer->Load(eSprite::RadioParts, "radioparts");
-  m_pRenderer->Load(eSprite::PressToBuild, "presstobuild");
-  m_pRenderer->Load(eSprite::Radio, "radio");
-  m_pRenderer->Load(eSprite::Research, "research");
-  m_pRenderer->Load(eSprite::PressToLeave, "presstoleave");
-  m_pRenderer->Load(eSprite::Escape, "escape");
-  m_pRenderer->Load(eSprite::PlayButton, "playbutton");
-  m_pRenderer->Load(eSprite::PlayButton2, "playbutton2");
-  m_pRenderer->Load(eSprite::TutorialButton, "tutorialbutton");
-  m_pRenderer->Load(eSprite::Title2, "title2");
-  m_pRenderer->Load(eSprite::BackButton, "backbutton");
-m_pRenderer->EndResourceUpload();
+  for(; m_nImagesLoaded<last; m_nImagesLoaded++)
+    m_pRenderer->Load(SPRITES[m_nImagesLoaded].m_eSprite, SPRITES[m_nImagesLoaded].m_pName);
+
+  m_pRenderer->EndResourceUpload();
 } //LoadImages
 
-/// Initialize the audio player and load game sounds.
+/// Reader function for whether there are still images waiting to be loaded.
+/// \return true if some images have not been loaded yet.
+
+const bool CGame::LoadingImages() const{
+  return m_nImagesLoaded < NUM_SPRITES;
+} //LoadingImages
+
+/// Draw the image loading progress on the title screen.
+
+void CGame::DrawLoadingText(){
+  const std::string s = "Loading " + std::to_string(m_nImagesLoaded) + "/" +
+    std::to_string(NUM_SPRITES); //progress text
+  const Vector2 pos(64.0f, m_nWinHeight - 64.0f); //hard-coded position
+  m_pRenderer->DrawScreenText(s.c_str(), pos); //draw to screen
+} //DrawLoadingText
+
+/// Initialize the audio player and load the game sounds on a worker thread,
+/// so that reading the sound files doesn't hold up the title screen. The
+/// audio player isn't touched on the main thread until `SoundsLoaded()` says
+/// that they are done, and `BeginGame()` waits for them before starting a
+/// level, since levels play sounds.
 
 void CGame::LoadSounds(){
-  m_pAudio->Initialize(eSound::Size);
-
-  m_pAudio->Load(eSound::Grunt, "grunt");
-  m_pAudio->Load(eSound::Clang, "clang");
-  m_pAudio->Load(eSound::Gun, "gun");
-  m_pAudio->Load(eSound::Ricochet, "ricochet");
-  m_pAudio->Load(eSound::Start, "start");
-  m_pAudio->Load(eSound::Boom, "boom");
+  m_futSounds = std::async(std::launch::async, [this](){
+    const CAllocScope scope(eAlloc::Audio); //charge to audio
+    m_pAudio->Initialize(eSound::Size);
+
+    m_pAudio->Load(eSound::Grunt, "grunt");
+    m_pAudio->Load(eSound::Clang, "clang");
+    m_pAudio->Load(eSound::Gun, "gun");
+    m_pAudio->Load(eSound::Ricochet, "ricochet");
+    m_pAudio->Load(eSound::Start, "start");
+    m_pAudio->Load(eSound::Boom, "boom");
+  });
 } //LoadSounds
 
+/// Check whether the sounds have finished loading, without waiting. The
+/// worker thread is joined the first time that they have.
+/// \return true if the sounds have finished loading.
+
+const bool CGame::SoundsLoaded(){
+  if(m_futSounds.valid()){
+    if(m_futSounds.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return false; //still loading
+
+    m_futSounds.get(); //join the worker
+  } //if
+
+  return true;
+} //SoundsLoaded
+
+/// Wait for the sounds to finish loading, if they haven't already.
+
+void CGame::WaitForSounds(){
+  if(m_futSounds.valid())m_futSounds.get();
+} //WaitForSounds
+
 /// Release all of the DirectX12 objects by deleting the renderer.
 
 void CGame::Release(){
+  WaitForSounds(); //don't pull the audio player out from under the loader
+  CLog::Stop(); //write out the last log messages
+
   delete m_pRenderer;
   m_pRenderer = nullptr; //for safety
 } //Release
 
-/// Ask the object manager to create a player object and turrets specified by
-/// the tile manager.
+/// Ask the world to create the objects for the map that has just been
+/// loaded, and build the trigger volumes.
 
 void CGame::CreateObjects(){
-  std::vector<Vector2> turretpos; //vector of turret positions
-  Vector2 acitvitypos;
-  Vector2 housepos;
-  Vector2 shoppos;
-  Vector2 radiotowerpos;
-  std::vector<Vector2> treepos;
-  std::vector<Vector2> zombiepos;
-  acitvitypos = playerpos;
-  m_pTileManager->GetObjects(turretpos, playerpos, acitvitypos, housepos, treepos, zombiepos, shoppos, radiotowerpos); //get positions
-  m_pPlayer = (CPlayer*)m_pObjectManager->create(eSprite::Player, playerpos);
-  m_pActivity = (CActivity*)m_pObjectManager->create(eSprite::Activity, playerpos);
-  m_pHouse = (CHouse*)m_pObjectManager->create(eSprite::House, housepos);
-  m_pShop = (CShop*)m_pObjectManager->create(eSprite::Shop, shoppos);
-  m_pRadioTower = (CRadioTower*)m_pObjectManager->create(eSprite::Research, radiotowerpos);
-  
-  //m_pObjectManager->create(eSprite::Activity, acitvitypos);
+  playerpos = m_pWorld->CreateLevel(true);
 
-  //for(const Vector2& pos: turretpos)
-    //m_pObjectManager->create(eSprite::Turret, pos);
-
-  for (const Vector2& pos : treepos)
-      m_pObjectManager->create(eSprite::Tree, pos);
+  std::vector<CTriggerVolume> triggers; //trigger volumes
+  m_pWorld->m_pTileManager->GetTriggers(triggers);
+  m_pTriggerManager->Build(triggers, m_pWorld->m_vWorldSize);
 } //CreateObjects
 
 /// Call this function to start a new game. This should be re-entrant so that
@@ -175,79 +246,401 @@ void CGame::CreateObjects(){
 /// delete any old objects out of the object manager and create some new ones.
 
 void CGame::BeginGame(){  
-    m_pMouse = new LMouse();
-    m_pParticleEngine->clear(); //clear old particles
-    m_pObjectManager->clear(); //clear old objects
+    if (m_eGameState != eGameState::Title && m_eGameState != eGameState::Tutorial){
+        LoadImages(NUM_SPRITES); //levels need all images, so finish loading them
+        WaitForSounds(); //levels play sounds, so finish loading them
+    } //if
+
+    const bool bRestart = m_eGameState == m_eSnapshotState &&
+        m_pWorld->m_pObjectManager->HasSnapshot(); //restarting the last level started
+
+    m_pWorld->m_pParticleEngine->clear(); //clear old particles
+    if (!bRestart) m_pWorld->m_pObjectManager->clear(); //clear old objects, a restart resets them
+    m_pWorld->m_pBulletManager->clear(); //clear old bullets
+    m_pTriggerManager->Build(std::vector<CTriggerVolume>(), m_pWorld->m_vWorldSize); //clear old trigger volumes
     spawnedBattery = false;
     spawnedAntenna = false;
     spawnedLogic = false;
 
     if (m_eGameState == eGameState::Title) {
-        m_pObjectManager->create(eSprite::Title, m_vWinCenter);
-        m_pObjectManager->create(eSprite::PlayButton, m_vWinCenter);
-        m_pObjectManager->create(eSprite::TutorialButton, Vector2(m_vWinCenter.x, m_vWinCenter.y - 150));
+        m_pWorld->m_pObjectManager->create(eSprite::Title, m_vWinCenter);
+        m_pWorld->m_pObjectManager->create(eSprite::PlayButton, m_vWinCenter);
+        m_pWorld->m_pObjectManager->create(eSprite::TutorialButton, Vector2(m_vWinCenter.x, m_vWinCenter.y - 150));
+        PrefetchMap("Media\\Maps\\map1.txt"); //the title screen leads to level 1
 
     }
     else if (m_eGameState == eGameState::Tutorial) {
-        m_pObjectManager->clear(); //clear old objects
-        m_pObjectManager->create(eSprite::Title2, m_vWinCenter);
-        m_pObjectManager->create(eSprite::BackButton, Vector2(m_vWinCenter.x - 750, m_vWinCenter.y - 425));
+        m_pWorld->m_pObjectManager->clear(); //clear old objects
+        m_pWorld->m_pObjectManager->create(eSprite::Title2, m_vWinCenter);
+        m_pWorld->m_pObjectManager->create(eSprite::BackButton, Vector2(m_vWinCenter.x - 750, m_vWinCenter.y - 425));
     }
     else if (m_eGameState == eGameState::Level1) {
-        m_pTileManager->LoadMap("Media\\Maps\\map1.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map1.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
         m_fElapsedTime = 0.0f;
     }
     else if (m_eGameState == eGameState::Victory) {
-        m_pObjectManager->create(eSprite::Victory, m_vWinCenter);
+        m_pWorld->m_pObjectManager->create(eSprite::Victory, m_vWinCenter);
     }
     else if (m_eGameState == eGameState::Level2) {
-        m_pTileManager->LoadMap("Media\\Maps\\map2.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map2.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
     else if (m_eGameState == eGameState::Level3) {
-        m_pTileManager->LoadMap("Media\\Maps\\map3.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map3.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
     else if (m_eGameState == eGameState::Level4) {
-        m_pTileManager->LoadMap("Media\\Maps\\map4.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map4.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
     else if (m_eGameState == eGameState::Level5) {
-        m_pTileManager->LoadMap("Media\\Maps\\map5.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map5.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
     else if (m_eGameState == eGameState::Level6) {
-        m_pTileManager->LoadMap("Media\\Maps\\map6.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map6.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
     else if (m_eGameState == eGameState::Level7) {
-        m_pTileManager->LoadMap("Media\\Maps\\map7.txt");
-        CreateObjects(); //create new objects (must be after map is loaded) 
+        StartLevel("Media\\Maps\\map7.txt", bRestart);
         m_pAudio->stop(); //stop all  currently playing sounds
         m_pAudio->play(eSound::Start); //play start-of-game sound
     }
 }
 
+/// Start reading a map into the spare tile manager on a worker thread, so
+/// that parsing it and finding its walls and object positions is done before
+/// `BeginGame()` needs it. Only one map is prefetched at a time.
+/// \param filename Name of the map file.
+
+void CGame::PrefetchMap(const char* filename){
+  if(m_strPrefetched == filename)return; //already prefetched or on its way
+  if(m_futPrefetch.valid())m_futPrefetch.get(); //spare tile manager is busy
+
+  m_strPrefetched = filename;
+
+  m_futPrefetch = std::async(std::launch::async, [this, name = m_strPrefetched](){
+    m_pNextTileManager->ReadMap(name.c_str());
+  }); //prefetch
+} //PrefetchMap
+
+/// Load a map into the tile manager. If it is the map that was prefetched,
+/// wait for the prefetch to finish, if it hasn't already, and swap the
+/// prefetched level data in. Otherwise read the map now. Either way the spare
+/// tile manager is left holding an old map, so nothing counts as prefetched.
+/// \param filename Name of the map file.
+
+void CGame::LoadMap(const char* filename){
+  if(m_futPrefetch.valid())m_futPrefetch.get(); //wait for prefetch
+
+  if(m_strPrefetched == filename)
+    m_pWorld->m_pTileManager->Swap(*m_pNextTileManager); //use prefetched map
+  else m_pWorld->m_pTileManager->LoadMap(filename); //read it now
+
+  m_strPrefetched.clear();
+} //LoadMap
+
+/// Start a level. Restarting the level that was started last puts its objects
+/// back the way they were from the object manager's snapshot, and keeps the
+/// map, which doesn't change during play, so there is no disk access and
+/// hardly any object creation. Otherwise the map is loaded, the objects are
+/// created, and a snapshot of them is taken.
+/// \param filename Name of the map file.
+/// \param bRestart true if this is a restart of the last level started.
+
+void CGame::StartLevel(const char* filename, bool bRestart){
+  if(bRestart){
+    m_pWorld->RestoreLevel();
+
+    std::vector<CTriggerVolume> triggers; //trigger volumes
+    m_pWorld->m_pTileManager->GetTriggers(triggers);
+    m_pTriggerManager->Build(triggers, m_pWorld->m_vWorldSize);
+  } //if
+
+  else{
+    LoadMap(filename);
+    CreateObjects(); //create new objects (must be after map is loaded)
+    m_eSnapshotState = m_eGameState;
+  } //else
+
+  m_nAutosaveHour = -1; //don't autosave until the first hour passes
+  m_cHistory.clear(); //can't rewind into a different level
+} //StartLevel
+
+/// Fill in a save header from the current game state.
+/// \param h [out] Save header.
+
+void CGame::GetSaveHeader(CSaveHeader& h){
+  memset(&h, 0, sizeof(h)); //padding too, so that unchanged headers are equal
+
+  memcpy(h.m_chMagic, SAVE_MAGIC, 4);
+  h.m_nVersion = SAVE_VERSION;
+  h.m_nNumObjects = (UINT)m_vecSaved.size();
+  h.m_eGameState = m_eGameState;
+  h.m_fElapsedTime = m_fElapsedTime;
+  h.m_nDayIndex = m_nDayIndex;
+  h.m_bIncrementedDay = m_bIncrementedDay;
+  h.m_bSpawnedZombies = m_bSpawnedZombies;
+  h.m_nNights = m_pWorld->m_nNights;
+  h.m_bGotBattery = m_pWorld->gotBattery;
+  h.m_bGotAntenna = m_pWorld->gotAntenna;
+  h.m_bGotLogicBoard = m_pWorld->gotLogicBoard;
+  h.m_bSpawnedBattery = spawnedBattery;
+  h.m_bSpawnedAntenna = spawnedAntenna;
+  h.m_bSpawnedLogic = spawnedLogic;
+  h.m_bRadioOn = radioOn;
+  h.m_nHungerCount = m_pWorld->m_pPlayer? m_pWorld->m_pPlayer->GetHungerCount(): 0;
+} //GetSaveHeader
+
+/// Put the clock, the night count, radio parts, and player hunger from a save
+/// header into the game. This must be done after the saved objects are loaded, since it
+/// sets the hunger of the loaded player.
+/// \param h Save header.
+
+void CGame::SetSaveHeader(const CSaveHeader& h){
+  m_fElapsedTime = h.m_fElapsedTime;
+  m_nDayIndex = h.m_nDayIndex;
+  m_bIncrementedDay = h.m_bIncrementedDay;
+  m_bSpawnedZombies = h.m_bSpawnedZombies;
+  m_pWorld->m_nNights = h.m_nNights;
+  m_pWorld->gotBattery = h.m_bGotBattery;
+  m_pWorld->gotAntenna = h.m_bGotAntenna;
+  m_pWorld->gotLogicBoard = h.m_bGotLogicBoard;
+  spawnedBattery = h.m_bSpawnedBattery;
+  spawnedAntenna = h.m_bSpawnedAntenna;
+  spawnedLogic = h.m_bSpawnedLogic;
+  radioOn = h.m_bRadioOn;
+
+  if(m_pWorld->m_pPlayer)
+    m_pWorld->m_pPlayer->SetHungerCount(h.m_nHungerCount);
+
+  m_nClockKey = -1; //redo clock text
+  m_nAutosaveHour = -1; //don't save again straight away
+} //SetSaveHeader
+
+/// Get the simulation state, which is the save header followed by the saved
+/// object records, laid out in one buffer. This is plain data, and is both
+/// what a save game file holds and what the state history records.
+/// \param state [out] Simulation state.
+
+void CGame::GetState(std::vector<char>& state){
+  m_pWorld->m_pObjectManager->Save(m_vecSaved);
+
+  CSaveHeader h; //header
+  GetSaveHeader(h);
+
+  const size_t n = m_vecSaved.size()*sizeof(CSavedObject); //size of objects
+  state.resize(sizeof(h) + n);
+  memcpy(state.data(), &h, sizeof(h));
+  if(n > 0)memcpy(state.data() + sizeof(h), m_vecSaved.data(), n);
+} //GetState
+
+/// Write a save game file with a single call. The save is written to a
+/// temporary file first so that a crash part way through can't damage the
+/// previous save. This runs on a worker thread.
+/// \param filename Name of the save file.
+/// \param state Save header and object records.
+/// \return true if the file was written.
+
+static const bool WriteSave(const std::string& filename, const std::vector<char>& state){
+  const std::string tempname = filename + ".tmp"; //temporary file
+  FILE* output; //output file handle
+  fopen_s(&output, tempname.c_str(), "wb");
+
+  if(output == nullptr){
+    LOG_ERROR("Cannot write %s.", tempname.c_str());
+    return false;
+  } //if
+
+  bool bOK = fwrite(state.data(), state.size(), 1, output) == 1; //whether writes succeeded
+  bOK = fclose(output) == 0 && bOK;
+
+  if(bOK){ //replace the old save
+    remove(filename.c_str());
+    bOK = rename(tempname.c_str(), filename.c_str()) == 0;
+  } //if
+
+  else remove(tempname.c_str());
+
+  if(!bOK)LOG_ERROR("Cannot save to %s.", filename.c_str());
+  return bOK;
+} //WriteSave
+
+/// Save the game. The state is copied into a buffer on this frame, which
+/// takes well under a millisecond even with a full horde of zombies, and the
+/// buffer is written to the file on a worker thread so that the frame
+/// doesn't wait for the disk. Only one save is written at a time, so this
+/// waits for the previous one, if it is still being written.
+/// \param filename Name of the save file.
+/// \return true if the save was started.
+
+const bool CGame::SaveGame(const char* filename){
+  if(m_eGameState < eGameState::Level1 || m_eGameState > eGameState::Level7)
+    return false; //not playing a level
+
+  std::vector<char> state; //buffer for the worker to write
+  GetState(state);
+
+  WaitForSave(); //one save at a time
+  m_futSave = std::async(std::launch::async, WriteSave, std::string(filename),
+    std::move(state));
+
+  return true;
+} //SaveGame
+
+/// Wait for the save that is being written, if there is one.
+/// \return true if there was no save being written or it was written.
+
+const bool CGame::WaitForSave(){
+  return m_futSave.valid()? m_futSave.get(): true;
+} //WaitForSave
+
+/// Load a saved game. The saved level is started in the usual way, which
+/// restores it from the object manager's snapshot if it is the level being
+/// played, and then the saved objects, clock, and radio parts are put in.
+/// Nothing is changed if the save file is missing, from a different version,
+/// or damaged, which includes being the wrong size for the number of objects
+/// that its header claims, or having an object with a sprite that doesn't
+/// exist.
+/// \param filename Name of the save file.
+/// \return true if the game was loaded.
+
+const bool CGame::LoadGame(const char* filename){
+  WaitForSave(); //read the newest save
+
+  FILE* input; //input file handle
+  fopen_s(&input, filename, "rb");
+  if(input == nullptr)return false; //no save
+
+  fseek(input, 0, SEEK_END); //seek to end of file
+  const UINT64 size = (UINT64)ftell(input); //file size in bytes
+  rewind(input); //seek to start of file
+
+  CSaveHeader h; //header
+  bool bOK = fread(&h, sizeof(h), 1, input) == 1 &&
+    !memcmp(h.m_chMagic, SAVE_MAGIC, 4) && h.m_nVersion == SAVE_VERSION &&
+    h.m_eGameState >= eGameState::Level1 && h.m_eGameState <= eGameState::Level7 &&
+    h.m_nDayIndex >= 0 && h.m_nDayIndex < 7 &&
+    size == sizeof(h) + (UINT64)h.m_nNumObjects*sizeof(CSavedObject); //whether the save is good
+
+  if(bOK){
+    m_vecSaved.resize(h.m_nNumObjects);
+
+    if(h.m_nNumObjects > 0)
+      bOK = fread(m_vecSaved.data(), sizeof(CSavedObject)*h.m_nNumObjects, 1, input) == 1 &&
+        CObjectManager::IsValid(m_vecSaved.data(), m_vecSaved.size());
+  } //if
+
+  fclose(input);
+  if(!bOK)return false;
+
+  m_eGameState = h.m_eGameState;
+  BeginGame();
+
+  m_pWorld->m_pObjectManager->Load(m_vecSaved.data(), m_vecSaved.size());
+  SetSaveHeader(h);
+
+  return true;
+} //LoadGame
+
+/// Record the simulation state for this tick in the state history. The state
+/// is the same header and object records that a save game has, laid out in
+/// one buffer, so it is plain data and the history can delta-encode it
+/// against the previous tick. Nothing is recorded in a co-op session, since
+/// the server owns the world and a client can't rewind it.
+
+void CGame::RecordState(){
+  if(m_eGameState < eGameState::Level1 || m_eGameState > eGameState::Level7)
+    return; //not playing a level
+
+  if(m_pClient)return; //the server owns the world
+
+  GetState(m_vecState);
+  m_cHistory.Record(m_vecState.data(), m_vecState.size());
+} //RecordState
+
+/// Go back some ticks and carry on simulating from there. The objects are
+/// replaced by the recorded ones in the same way as loading a save, except
+/// that the level is already loaded. Bullets and particles aren't part of
+/// the recorded state, so they are removed. This does nothing in a co-op
+/// session, since rewinding the replicated world would put it out of step
+/// with the server's.
+/// \param n Number of ticks to go back.
+/// \return true if the state history goes back that far.
+
+const bool CGame::Rewind(size_t n){
+  if(m_pClient)return false; //the server owns the world
+  if(!m_cHistory.Rewind(n, m_vecState))return false;
+
+  CSaveHeader h; //header
+  memcpy(&h, m_vecState.data(), sizeof(h));
+
+  const CSavedObject* objects =
+    (const CSavedObject*)(m_vecState.data() + sizeof(h)); //saved objects
+
+  m_pWorld->m_pObjectManager->Load(objects, h.m_nNumObjects);
+  SetSaveHeader(h);
+
+  m_pWorld->m_pBulletManager->clear();
+  m_pWorld->m_pParticleEngine->clear();
+
+  return true;
+} //Rewind
+
+/// Get the buttons to send to the co-op server from the keyboard and mouse,
+/// the same keys that `KeyboardHandler()` uses. The gun fires for as long as
+/// the mouse button is held down, rather than once per click, since a click
+/// could fall between server ticks.
+/// \return Buttons held down, a combination of the `NET_*` flags.
+
+const UINT CGame::GetNetButtons(){
+  UINT b = 0; //result
+
+  if(m_pKeyboard->Down('W'))b |= NET_FORWARD;
+  else if(m_pKeyboard->Down('S'))b |= NET_BACK;
+
+  if(m_pKeyboard->Down('A'))b |= NET_LEFT;
+  if(m_pKeyboard->Down('D'))b |= NET_RIGHT;
+  if(m_pKeyboard->Down(VK_SHIFT))b |= NET_WALK;
+  if(m_pKeyboard->Down(VK_LBUTTON))b |= NET_FIRE;
+
+  return b;
+} //GetNetButtons
+
+/// Send this frame's input to the co-op server and make the objects match
+/// the newest snapshot from it, if there is one. Objects are updated in
+/// place by network identifier, so only the ones that come into or go out of
+/// view are created or deleted, and the player keeps its hunger count, which
+/// the server doesn't know about. A snapshot with an object type or sprite
+/// that doesn't exist is ignored, since the bit widths in the snapshot format
+/// allow them.
+
+void CGame::ClientStep(){
+  m_pClient->SendInput(GetNetButtons(), m_fAimRotation);
+
+  UINT player = 0; //network identifier of our player
+  if(!m_pClient->Receive(m_vecNetObjects, player))return; //nothing new
+
+  if(!CObjectManager::IsValid(m_vecNetObjects)){ //damaged snapshot
+    LOG_WARNING("Ignored a snapshot with an unknown sprite.");
+    return;
+  } //if
+
+  m_pWorld->m_pObjectManager->Replicate(m_vecNetObjects, player);
+} //ClientStep
+
 /// Poll the keyboard state and respond to the key presses that happened since
 /// the last frame.
 
 void CGame::KeyboardHandler() {
     m_pKeyboard->GetState(); //get current keyboard state
-    static float lastEatTime = 0.0f; // Time the player last ate
-    static float lastclickTime = 0.0f; // Time the player last ate
 
     if (m_pKeyboard->TriggerDown(VK_RETURN)) {
         m_nNextLevel = (m_nNextLevel + 1) % 2;
@@ -267,7 +660,16 @@ void CGame::KeyboardHandler() {
     if (m_pKeyboard->TriggerDown(VK_BACK)) //start game
         BeginGame();
 
-    if (m_pPlayer) {
+    if (m_pKeyboard->TriggerDown(VK_F5) && m_pWorld->m_pPlayer) //quick save
+        SaveGame(SAVE_FILE);
+
+    if (m_pKeyboard->TriggerDown(VK_F9)) //quick load
+        LoadGame(SAVE_FILE);
+
+    if (m_pKeyboard->TriggerDown(VK_F6) && !m_pClient) //rewind, but not in co-op
+        Rewind(std::min(m_nRewindTicks, m_cHistory.GetMaxRewind()));
+
+    if (m_pWorld->m_pPlayer) {
         float baseSpeed = 35.0f; // base speed
         float walkSpeedFactor = 0.5f; // walking speed is half of the base speed
 
@@ -276,38 +678,37 @@ void CGame::KeyboardHandler() {
 
         if (m_pKeyboard->Down('W')) { // move up
             // If walking (shift held down), move at a slower speed
-            m_pPlayer->SetSpeed(isWalking ? (baseSpeed * walkSpeedFactor) : baseSpeed);
-            m_pActivity->UpdatePos(m_pPlayer->GetPos());
-            playerpos = m_pPlayer->GetPos();
+            m_pWorld->m_pPlayer->SetSpeed(isWalking ? (baseSpeed * walkSpeedFactor) : baseSpeed);
+            m_pWorld->m_pActivity->UpdatePos(m_pWorld->m_pPlayer->GetPos());
+            playerpos = m_pWorld->m_pPlayer->GetPos();
         }
         else if (m_pKeyboard->Down('S')) { // move down
             // If walking (shift held down), move at a slower speed
-            m_pPlayer->SetSpeed(isWalking ? (-baseSpeed * walkSpeedFactor) : -baseSpeed);
-            m_pActivity->UpdatePos(m_pPlayer->GetPos());
-            playerpos = m_pPlayer->GetPos();
+            m_pWorld->m_pPlayer->SetSpeed(isWalking ? (-baseSpeed * walkSpeedFactor) : -baseSpeed);
+            m_pWorld->m_pActivity->UpdatePos(m_pWorld->m_pPlayer->GetPos());
+            playerpos = m_pWorld->m_pPlayer->GetPos();
         }
         else {
-            m_pPlayer->SetSpeed(0.0f); // stop
-            m_pActivity->HideActivity();
+            m_pWorld->m_pPlayer->SetSpeed(0.0f); // stop
+            m_pWorld->m_pActivity->HideActivity();
         }
         if (m_pKeyboard->Down('D')) { // move right
-            m_pPlayer->SetWalking(m_pKeyboard->Down(VK_SHIFT)); // set walking state before strafing
-            m_pPlayer->StrafeRight();
-            m_pActivity->UpdatePos(m_pPlayer->GetPos());
-            playerpos = m_pPlayer->GetPos();
+            m_pWorld->m_pPlayer->SetWalking(m_pKeyboard->Down(VK_SHIFT)); // set walking state before strafing
+            m_pWorld->m_pPlayer->StrafeRight();
+            m_pWorld->m_pActivity->UpdatePos(m_pWorld->m_pPlayer->GetPos());
+            playerpos = m_pWorld->m_pPlayer->GetPos();
         }
 
         if (m_pKeyboard->Down('A')) { // move left
-            m_pPlayer->SetWalking(m_pKeyboard->Down(VK_SHIFT)); // set walking state before strafing
-            m_pPlayer->StrafeLeft();
-            m_pActivity->UpdatePos(m_pPlayer->GetPos());
-            playerpos = m_pPlayer->GetPos();
+            m_pWorld->m_pPlayer->SetWalking(m_pKeyboard->Down(VK_SHIFT)); // set walking state before strafing
+            m_pWorld->m_pPlayer->StrafeLeft();
+            m_pWorld->m_pActivity->UpdatePos(m_pWorld->m_pPlayer->GetPos());
+            playerpos = m_pWorld->m_pPlayer->GetPos();
         }
         if (m_pKeyboard->Down('F')) { // Farming
             if (!isNight) {
-                Vector2 playerPos = m_pPlayer->GetPos();
-                if (playerPos.x >= 2119 && playerPos.x <= 2333 && playerPos.y >= 330 && playerPos.y <= 570) {
-                    if (m_pPlayer->GetHungerCount() == 3) { // If player tries to farm with maxfood
+                if (m_bInZone[(UINT)eTrigger::Farm]) {
+                    if (m_pWorld->m_pPlayer->GetHungerCount() == 3) { // If player tries to farm with maxfood
                         if (m_pTimer->GetTime() - lastfoodMessageTime > 0.5f) {
                             maxfoodMessageElapsedTime = m_pTimer->GetTime();
                             showfoodMessage = true;
@@ -320,7 +721,7 @@ void CGame::KeyboardHandler() {
                           elapsedTime = m_pTimer->GetTime() - m_fKeyStartTime; // Calculate elapsed time
                           farming = true;
                           if (elapsedTime >= 5.0f) { // If 'F' has been held for 5 seconds
-                              m_pPlayer->SetHungerCount(m_pPlayer->GetHungerCount() + 1); // Increment HungerCount
+                              m_pWorld->m_pPlayer->SetHungerCount(m_pWorld->m_pPlayer->GetHungerCount() + 1); // Increment HungerCount
                               m_fKeyStartTime = 0.0f; // Reset the start time
                               farming = false;
                           }
@@ -334,8 +735,7 @@ void CGame::KeyboardHandler() {
               }
               else {
                   //make show message true for 5 seconds
-                  Vector2 playerPos = m_pPlayer->GetPos();
-                  if (playerPos.x >= 2119 && playerPos.x <= 2333 && playerPos.y >= 330 && playerPos.y <= 570) {
+                  if (m_bInZone[(UINT)eTrigger::Farm]) {
                       if (m_pTimer->GetTime() - lastMessageTime > 0.5f) {
                           messageElapsedTime = m_pTimer->GetTime();
                           showMessage = true;
@@ -354,38 +754,38 @@ void CGame::KeyboardHandler() {
 
       if (m_pKeyboard->Down('E')) { // Eating
           float currentTime = m_pTimer->GetTime(); // Get the current time
-          if (currentTime - lastEatTime >= 0.5f) { // Check if at least 1 second has passed
-              if (m_pPlayer && m_pPlayer->GetHealth() < 12 && m_pPlayer->GetHungerCount() > 0) {
-                  m_pPlayer->SetHealth(m_pPlayer->GetHealth() + 3); // Increment health
-                  m_pPlayer->SetHungerCount(m_pPlayer->GetHungerCount() - 1); // Decrement HungerCount
-                  lastEatTime = currentTime; // Update the last eat time
+          if (currentTime - m_fLastEatTime >= 0.5f) { // Check if at least 1 second has passed
+              if (m_pWorld->m_pPlayer && m_pWorld->m_pPlayer->GetHealth() < 12 && m_pWorld->m_pPlayer->GetHungerCount() > 0) {
+                  m_pWorld->m_pPlayer->SetHealth(m_pWorld->m_pPlayer->GetHealth() + 3); // Increment health
+                  m_pWorld->m_pPlayer->SetHungerCount(m_pWorld->m_pPlayer->GetHungerCount() - 1); // Decrement HungerCount
+                  m_fLastEatTime = currentTime; // Update the last eat time
               }
           }
       }
 
 
       if (m_pKeyboard->TriggerDown(VK_LBUTTON)){ //fire gun
-          //if (!m_pPlayer) {
+          //if (!m_pWorld->m_pPlayer) {
           //    cout << "here" << endl;
           //    if (mousePosNew.x >= 662 && mousePosNew.x <= 1257 && mousePosNew.y >= 496 && mousePosNew.y <= 600) {
           //        cout << "Pressed start button" << endl;
           //    }
           //}
           float currentTime = m_pTimer->GetTime(); // Get the current time
-          if (currentTime - m_fLastShotTime >= SHOT_COOLDOWN) { // Check if enough time has passed
-              m_pObjectManager->FireGun(m_pPlayer, eSprite::Bullet);
+          if (!m_pClient && currentTime - m_fLastShotTime >= m_pWorld->m_cTuning.m_fShotCooldown) { // Check if enough time has passed, the server fires for clients
+              m_pWorld->m_pObjectManager->FireGun(m_pWorld->m_pPlayer, eSprite::Bullet);
               m_fLastShotTime = currentTime; // Update the last shot time
-              m_pActivity->UpdatePos(m_pPlayer->GetPos());
+              m_pWorld->m_pActivity->UpdatePos(m_pWorld->m_pPlayer->GetPos());
           }
 
 
       }
       
       if (m_pKeyboard->TriggerDown('G')) { //toggle god mode
-          //m_bGodMode = !m_bGodMode;
+          //m_pWorld->m_bGodMode = !m_pWorld->m_bGodMode;
       }
       if (m_pKeyboard->Down('B')) {
-              if (playerpos.x >= 1396 && playerpos.x <= 1496 && playerpos.y >= 359 && playerpos.y <= 504 && isAbleToBuild && !radioOn) {
+              if (m_bInZone[(UINT)eTrigger::Workbench] && isAbleToBuild && !radioOn) {
                   building = true;
                   if (m_bKeyStartTime == 0.0f) { // If 'F' key is just pressed
                       m_bKeyStartTime = m_pTimer->GetTime(); // Record the start time
@@ -400,9 +800,9 @@ void CGame::KeyboardHandler() {
                               escapeMessageElapsedTime = m_pTimer->GetTime();
                               showEscapeMessage = true;
                           }
-                          gotBattery = false;
-                          gotAntenna = false;
-                          gotLogicBoard = false;
+                          m_pWorld->gotBattery = false;
+                          m_pWorld->gotAntenna = false;
+                          m_pWorld->gotLogicBoard = false;
                           building = false;
                       }
                   }
@@ -431,7 +831,7 @@ void CGame::MouseHandler() {
     m_pMouse->GetState();
     mousePos = m_pMouse->GetPosition();
 
-    if (!m_pPlayer) {
+    if (!m_pWorld->m_pPlayer) {
         //Make playPos the center of the screen
         Vector2 playerPos = Vector2(m_nWinWidth / 2, m_nWinHeight / 2);
 
@@ -449,8 +849,8 @@ void CGame::MouseHandler() {
         //std::cout << "Angle: " << angleInDegrees << std::endl;
     }
 
-    if (m_pPlayer) {
-        Vector2 playerPos = m_pPlayer->GetPos();
+    if (m_pWorld->m_pPlayer) {
+        Vector2 playerPos = m_pWorld->m_pPlayer->GetPos();
 
         // Get camera position
         Vector3 cameraPos3D = GetCameraPosition();
@@ -469,7 +869,8 @@ void CGame::MouseHandler() {
         float angleInDegrees = angleInRadians * (180.0f / M_PI);
 
         // Set the player's rotation
-        m_pPlayer->SetRotation(angleInDegrees - 2.0f);
+        m_pWorld->m_pPlayer->SetRotation(angleInDegrees - 2.0f);
+        m_fAimRotation = angleInDegrees - 2.0f; //for the co-op server
 
         // For debugging purposes
         //std::cout << "Mouse X: " << mousePos.x << " Mouse Y: " << mousePos.y << std::endl;
@@ -495,67 +896,26 @@ void CGame::ControllerHandler(){
 
   m_pController->GetState(); //get state of controller's controls 
   
-  if(m_pPlayer){ //safety
-    m_pPlayer->SetSpeed(100*m_pController->GetRTrigger());
-    m_pPlayer->SetRotSpeed(-2.0f*m_pController->GetRThumb().x);
+  if(m_pWorld->m_pPlayer){ //safety
+    m_pWorld->m_pPlayer->SetSpeed(100*m_pController->GetRTrigger());
+    m_pWorld->m_pPlayer->SetRotSpeed(-2.0f*m_pController->GetRThumb().x);
 
     if(m_pController->GetButtonRSToggle()) //fire gun
-      m_pObjectManager->FireGun(m_pPlayer, eSprite::Bullet);
+      m_pWorld->m_pObjectManager->FireGun(m_pWorld->m_pPlayer, eSprite::Bullet);
 
     if(m_pController->GetDPadRight()) //strafe right
-      m_pPlayer->StrafeRight();
+      m_pWorld->m_pPlayer->StrafeRight();
   
     if(m_pController->GetDPadLeft()) //strafe left
-      m_pPlayer->StrafeLeft();
+      m_pWorld->m_pPlayer->StrafeLeft();
 
     if(m_pController->GetDPadDown()) //strafe back
-      m_pPlayer->StrafeBack();
+      m_pWorld->m_pPlayer->StrafeBack();
   } //if
 } //ControllerHandler
 
-void CGame::DrawHunger() {
-    if (m_pPlayer) {
-        int hungerCount = m_pPlayer->GetHungerCount();
-        Vector3 cameraPos = m_pRenderer->GetCameraPos();
-
-        if (hungerCount == 1) {
-            LSpriteDesc2D desc;
-            desc.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc.m_vPos = Vector2(cameraPos.x - 730, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc);
-        }
-        if (hungerCount == 2) {
-            LSpriteDesc2D desc;
-            desc.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc.m_vPos = Vector2(cameraPos.x - 730, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc);
-
-            LSpriteDesc2D desc2;
-            desc2.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc2.m_vPos = Vector2(cameraPos.x - 715, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc2);
-        }
-        if (hungerCount == 3) {
-            LSpriteDesc2D desc;
-            desc.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc.m_vPos = Vector2(cameraPos.x - 730, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc);
-
-            LSpriteDesc2D desc2;
-            desc2.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc2.m_vPos = Vector2(cameraPos.x - 715, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc2);
-
-            LSpriteDesc2D desc3;
-            desc3.m_nSpriteIndex = (UINT)eSprite::Corn;
-            desc3.m_vPos = Vector2(cameraPos.x - 700, cameraPos.y - 470);
-            m_pRenderer->Draw(&desc3);
-        }
-    }
-}
-
 void CGame::DrawProgressBar() {
-    if (m_eGameState != eGameState::Title && farming && m_pPlayer->GetHungerCount() < 3 && !isNight) {
+    if (m_eGameState != eGameState::Title && farming && m_pWorld->m_pPlayer->GetHungerCount() < 3 && !isNight) {
         Vector3 cameraPos = m_pRenderer->GetCameraPos(); // Get the camera's position
 
         int offset = 38;
@@ -791,20 +1151,27 @@ void CGame::DrawBackground() {
     }
 }
 
-void CGame::DrawClock() {
-    static int currentDayIndex = 0; 
-    static bool hasIncrementedDay = false; // Add a flag to check if we've incremented the day for the current 12:00 AM minute
-    static bool hasSpawnedZombies = false;
-    int zombieCount = 6;
+/// Advance the game clock. This increments the day at midnight, spawns the
+/// radio parts, zombies, and turrets at the appropriate times, and updates
+/// the day/night flag and the clock text.
+
+void CGame::UpdateClock() {
     if (m_eGameState != eGameState::Title && m_eGameState != eGameState::Victory && m_eGameState != eGameState::Tutorial) {
-        int gameMinutes = (static_cast<int>(m_fElapsedTime * 30) + 12 * 60) % (24 * 60); // Modulo to loop back to 0 at midnight, add 23 hours to start at 11 PM
+        int gameMinutes = CWorld::GetClockMinutes(m_fElapsedTime); // Minutes since midnight
 
         // Calculate game hours and minutes
         int gameHours = gameMinutes / 60;
         int gameMins = gameMinutes % 60;
+        m_nHourOfDay = gameHours;
+
+        if (m_nHourOfDay != m_nAutosaveHour) { //autosave every game hour
+            if (m_nAutosaveHour >= 0 && m_pWorld->m_pPlayer && !m_pClient)
+                SaveGame(SAVE_FILE);
+            m_nAutosaveHour = m_nHourOfDay;
+        }
 
         // Calculate game day (1 real day = 1 game week)
-        std::string daysOfWeek[] = { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday" };
+        static const char* daysOfWeek[] = { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday" };
 
         // Convert to 12-hour format and determine AM/PM
         std::string am_pm = (gameHours >= 12 && gameHours < 24) ? "PM" : "AM";
@@ -812,297 +1179,162 @@ void CGame::DrawClock() {
         gameHours = (gameHours == 0) ? 12 : gameHours; // Convert 0 hours to 12
 
         // If it's 12:00 AM and we haven't incremented the day yet, increment the day
-        if (gameHours == 12 && gameMins == 0 && am_pm == "AM" && !hasIncrementedDay) {
-            currentDayIndex = (currentDayIndex + 1) % 7;
-            hasIncrementedDay = true; // Set the flag to true so we don't increment the day again during this minute
-            // Increase the number of zombies by 10 each day until it reaches 70
+        if (gameHours == 12 && gameMins == 0 && am_pm == "AM" && !m_bIncrementedDay) {
+            m_nDayIndex = (m_nDayIndex + 1) % 7;
+            m_bIncrementedDay = true; // Set the flag to true so we don't increment the day again during this minute
             spawnedBattery = false;
             spawnedAntenna = false;
             spawnedLogic = false;
-            zombieCount = std::min(zombieCount + 10, 70);
         }
 
         // If it's past 12:00 AM, reset the flag so we can increment the day again the next time it hits 12:00 AM
         if (gameHours == 12 && gameMins != 0 && am_pm == "AM") {
-            hasIncrementedDay = false;
+            m_bIncrementedDay = false;
         }
 
-        std::string gameDay = daysOfWeek[currentDayIndex];
-
-        // Format game time string
-        std::string gameTime = gameDay + " - " + std::to_string(gameHours) + ":" + (gameMins < 10 ? "0" : "") + std::to_string(gameMins) + " " + am_pm;
+        // Format game time string, but only when the minute changes
+        const int clockKey = m_nDayIndex * 24 * 60 + gameMinutes;
 
-       // Draw Frame
-        LSpriteDesc2D desc;
-        desc.m_nSpriteIndex = (UINT)eSprite::Frame;
-        Vector3 cameraPos = m_pRenderer->GetCameraPos(); // Get the camera's position
-        desc.m_vPos = Vector2(cameraPos.x - 750, cameraPos.y + 487); 
-        desc.m_fXScale = 1.0f;
-        desc.m_fYScale = 1.0f; 
-        desc.m_fAlpha = 0.75f;
-        m_pRenderer->Draw(&desc);
-
-        const Vector2 pos(70.0f, 38.0f); //hard-coded position
-        if (gameDay == "Wednesday") {
-            //adjust position for Wednesday
-            m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x - 27 , pos.y });
-        }else if (gameDay == "Friday") {
-			//adjust position for Friday
-			m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x + 3, pos.y });
-		}else if (gameDay == "Tuesday") {
-            //adjust position for Tuesday
-            m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x - 10, pos.y });
-        }else if (gameDay == "Thursday") {
-            //adjust position for Thursday
-            m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x - 17, pos.y });
-        }else if (gameDay == "Saturday") {
-            //adjust position for Saturday
-            m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x - 20, pos.y });
-        }else if (gameDay == "Sunday") {
-            //adjust position for Sunday
-            m_pRenderer->DrawScreenText(gameTime.c_str(), { pos.x - 3, pos.y });
-        }
-        else {
-            m_pRenderer->DrawScreenText(gameTime.c_str(), pos);
+        if (clockKey != m_nClockKey) {
+            m_nClockKey = clockKey;
+            m_strClock = std::string(daysOfWeek[m_nDayIndex]) + " - " + std::to_string(gameHours) + ":" + (gameMins < 10 ? "0" : "") + std::to_string(gameMins) + " " + am_pm;
+            m_vClockPos = m_pTextCache->GetCenteredPos(m_strClock, Vector2(210.0f, 38.0f)); //center on clock frame
         }
-        desc.m_vPos = Vector2(cameraPos.x - 530, cameraPos.y + 487);
-        desc.m_fXScale = 1.0f;
-        desc.m_fYScale = 1.0f;
 
         //Update Game Hours
         m_nGameHours = gameHours;
         m_nAmPm = am_pm;
 
-        std::random_device rd;
-        std::mt19937 g(rd());
+        CRandom& g = m_pWorld->m_cRandom; //world's random number generator
         std::uniform_int_distribution<> distr(0, spawnCoords.size() - 1);
 
-        if (gameHours == 12 && gameMins == 0 && am_pm == "AM") {
-            if (!gotBattery && !gotAntenna && !gotLogicBoard && !spawnedBattery) {
+        if (gameHours == 12 && gameMins == 0 && am_pm == "AM" && !m_pClient) { // the server spawns things for clients
+            if (!m_pWorld->gotBattery && !m_pWorld->gotAntenna && !m_pWorld->gotLogicBoard && !spawnedBattery) {
                 Vector2 batteryPos = spawnCoords[distr(g)];
-                m_pObjectManager->create(eSprite::Battery, batteryPos);
+                m_pWorld->m_pObjectManager->create(eSprite::Battery, batteryPos);
                 spawnedBattery = true;
-                cout << "Spawned Battery at: " << batteryPos.x << ", " << batteryPos.y << endl;
+                LOG_INFO("Spawned battery at %.0f, %.0f.", batteryPos.x, batteryPos.y);
             }
-            else if (gotBattery && !gotAntenna && !gotLogicBoard && !spawnedAntenna) {
+            else if (m_pWorld->gotBattery && !m_pWorld->gotAntenna && !m_pWorld->gotLogicBoard && !spawnedAntenna) {
                 Vector2 antennaPos = spawnCoords[distr(g)];
-                m_pObjectManager->create(eSprite::Antenna, antennaPos);
+                m_pWorld->m_pObjectManager->create(eSprite::Antenna, antennaPos);
                 spawnedAntenna = true;
-                cout << "Spawned Antenna at: " << antennaPos.x << ", " << antennaPos.y << endl;
+                LOG_INFO("Spawned antenna at %.0f, %.0f.", antennaPos.x, antennaPos.y);
             }
-            else if (gotBattery && gotAntenna && !gotLogicBoard && !spawnedLogic) {
+            else if (m_pWorld->gotBattery && m_pWorld->gotAntenna && !m_pWorld->gotLogicBoard && !spawnedLogic) {
                 Vector2 logicPos = spawnCoords[distr(g)];
-                m_pObjectManager->create(eSprite::LogicBoard, logicPos);
+                m_pWorld->m_pObjectManager->create(eSprite::LogicBoard, logicPos);
                 spawnedLogic = true;
-                cout << "Spawned LogicBoard at: " << logicPos.x << ", " << logicPos.y << endl;
+                LOG_INFO("Spawned logic board at %.0f, %.0f.", logicPos.x, logicPos.y);
             }
             else {}
         }
         if (gameHours == 5 && gameMins == 0 && am_pm == "AM") {
-            m_pObjectManager->clearRadios();
+            m_pWorld->m_pObjectManager->clearRadios();
         }
 
         // If it's between 6:00 AM and 5:59 PM, draw the sun else draw the moon
-        if ((gameHours > 6 && gameHours < 12 && am_pm == "AM") ||
-            (gameHours < 6 && am_pm == "PM") ||
-            (gameHours == 6 && gameMins > 0 && am_pm == "AM") ||
-            (gameHours == 12 && am_pm == "PM")) {
-            desc.m_nSpriteIndex = (UINT)eSprite::Sun;
+        if (!CWorld::IsNight(gameMinutes)) {
             isNight = false;
-            hasSpawnedZombies = false; // Reset the flag so we can spawn the zombies again
+            m_bSpawnedZombies = false; // Reset the flag so we can spawn the zombies again
         }
         else {
-            desc.m_nSpriteIndex = (UINT)eSprite::Moon;
             isNight = true;
 
-            if (!hasSpawnedZombies) {
-                std::vector<Vector2> turretpos; //vector of turret positions
-                std::vector<Vector2> zombiepos;
-                Vector2 playerpos; //player positions
-                Vector2 acitvitypos;
-                Vector2 housepos;
-                Vector2 shoppos;
-                Vector2 radiotowerpos;
-                std::vector<Vector2> treepos;
-                acitvitypos = playerpos;
-                m_pTileManager->GetObjects(turretpos, playerpos, acitvitypos, housepos, treepos, zombiepos, shoppos, radiotowerpos); //get positions
-                std::random_device rd;
-                std::mt19937 g(rd());
-                std::shuffle(turretpos.begin(), turretpos.end(), g);
-                std::shuffle(zombiepos.begin(), zombiepos.end(), g);
-
-                for (int i = 0; i < zombieCount; i++) {
-                    m_pObjectManager->create(eSprite::Zombie2, zombiepos[i]);
-                    //m_pObjectManager->create(eSprite::Zombie2, zombiepos);
-                }
-                for (int i = 0; i < zombieCount; i++) {
-                    m_pObjectManager->create(eSprite::Turret, turretpos[i]);
-                }
-                hasSpawnedZombies = true; // Set the flag to true after spawning the zombies
+            if (!m_bSpawnedZombies && !m_pClient) { // the server spawns things for clients
+                m_pWorld->SpawnNight(); // more each night
+                m_bSpawnedZombies = true; // Set the flag to true after spawning the zombies
             }
         }
-        m_pRenderer->Draw(&desc);  
     }
 }
 
-bool CGame::getIsNight() {
-    return isNight;
-
-}
-void CGame::DrawHealthBar() {
-    if (m_eGameState != eGameState::Title && m_eGameState != eGameState::Victory && m_eGameState != eGameState::Tutorial) { // Only draw the health bar if the game is not in the title state
-        // Draw Frame
-        LSpriteDesc2D frame;
-        frame.m_nSpriteIndex = (UINT)eSprite::Frame;
-        Vector3 cameraPos = m_pRenderer->GetCameraPos(); // Get the camera's position
-        frame.m_vPos = Vector2(cameraPos.x - 845, cameraPos.y - 470);
-        frame.m_fXScale = 0.5f;
-        frame.m_fYScale = 1.0f;
-        frame.m_fAlpha = 0.75f;
-        m_pRenderer->Draw(&frame);
-        
-        LSpriteDesc2D desc;
-        // Get the player's health
-        int health = m_pPlayer->GetHealth();
+/// Draw the clock text over the clock frame, which is part of the HUD.
 
-        // Set the sprite index based on the player's health
-        if (health == 12) {
-            desc.m_nSpriteIndex = (UINT)eSprite::HealthBar;
-        }
-        else if (health == 9) {
-            desc.m_nSpriteIndex = (UINT)eSprite::HealthBar60;
-        }
-        else if (health == 6) {
-            desc.m_nSpriteIndex = (UINT)eSprite::HealthBar40;
-        }
-        else if (health == 3) {
-            desc.m_nSpriteIndex = (UINT)eSprite::HealthBar20;
-        }
-        else {
-            desc.m_nSpriteIndex = (UINT)eSprite::HealthBar0;
-        }
-        desc.m_vPos = Vector2(cameraPos.x - 850, cameraPos.y - 470); // Adjust the health bar's position based on the camera's position
-
-        desc.m_fXScale = 1.0f;
-        desc.m_fYScale = 1.0f; 
-        m_pRenderer->Draw(&desc);
-    }
+void CGame::DrawClock() {
+    if (m_eGameState != eGameState::Title && m_eGameState != eGameState::Victory && m_eGameState != eGameState::Tutorial)
+        m_pRenderer->DrawScreenText(m_strClock.c_str(), m_vClockPos);
 }
 
-void CGame::DrawInstructions() {
-    Vector3 cameraPos = m_pRenderer->GetCameraPos(); // Get the camera's position
-    if (isAbleToFarm && !isAbleToEat) {
-        LSpriteDesc2D instruct;
-        instruct.m_nSpriteIndex = (UINT)eSprite::PressToFarm;
-        // Add an offset of 10 to raise the frame above the player's head
-        instruct.m_vPos = Vector2(cameraPos.x + 770, cameraPos.y - 460);
-
-        m_pRenderer->Draw(&instruct);
-    }
-    if (isAbleToEat && !isAbleToFarm) {
-		LSpriteDesc2D instruct;
-		instruct.m_nSpriteIndex = (UINT)eSprite::PressToEat;
-		// Add an offset of 10 to raise the frame above the player's head
-		instruct.m_vPos = Vector2(cameraPos.x + 770, cameraPos.y - 440);
-
-		m_pRenderer->Draw(&instruct);
-	}
-    if (isAbleToEat && isAbleToFarm) {
-		LSpriteDesc2D instruct, instruct2;
-		instruct.m_nSpriteIndex = (UINT)eSprite::PressToFarm;
-        instruct2.m_nSpriteIndex = (UINT)eSprite::PressToEat;
-		// Add an offset of 10 to raise the frame above the player's head
-		instruct2.m_vPos = Vector2(cameraPos.x + 770, cameraPos.y - 440);
-        instruct.m_vPos = Vector2(cameraPos.x + 770, cameraPos.y - 460);
-
-		m_pRenderer->Draw(&instruct);
-		m_pRenderer->Draw(&instruct2);
-	}
-    if (isAbleToBuild) {
-        LSpriteDesc2D instruct;
-        instruct.m_nSpriteIndex = (UINT)eSprite::PressToBuild;
-        // Add an offset of 10 to raise the frame above the player's head
-        instruct.m_vPos = Vector2(cameraPos.x + 773, cameraPos.y - 460);
-
-        m_pRenderer->Draw(&instruct);
-    }
-    if (isAbleToLeave && m_eGameState != eGameState::Victory) {
-        LSpriteDesc2D instruct;
-        instruct.m_nSpriteIndex = (UINT)eSprite::PressToLeave;
-        // Add an offset of 10 to raise the frame above the player's head
-        instruct.m_vPos = Vector2(cameraPos.x + 773, cameraPos.y - 460);
+bool CGame::getIsNight() {
+    return isNight;
 
-        m_pRenderer->Draw(&instruct);
-    }
 }
-
 void CGame::DrawPartsOnTable() {
 
 }
 
-void CGame::DrawParts() {
-    Vector3 cameraPos = m_pRenderer->GetCameraPos(); // Get the camera's position
-    if (m_eGameState != eGameState::Title && m_eGameState != eGameState::Victory && m_eGameState != eGameState::Tutorial) {
-		LSpriteDesc2D battery;
-        LSpriteDesc2D antenna;
-        LSpriteDesc2D logicboard;
-        LSpriteDesc2D radio;
-		battery.m_nSpriteIndex = (UINT)eSprite::Battery;
-        battery.m_vPos = Vector2(cameraPos.x - 830, cameraPos.y - 420);
-        antenna.m_nSpriteIndex = (UINT)eSprite::Antenna;
-        antenna.m_vPos = Vector2(cameraPos.x - 800, cameraPos.y - 420);
-        logicboard.m_nSpriteIndex = (UINT)eSprite::LogicBoard;
-        logicboard.m_vPos = Vector2(cameraPos.x - 770, cameraPos.y - 420);
-        radio.m_nSpriteIndex = (UINT)eSprite::Radio;
-        radio.m_vPos = Vector2(cameraPos.x - 920, cameraPos.y - 420);
-
-        //Tint the battery greyscale
-        if (!gotBattery)
-            battery.m_f4Tint = Vector4(0.5f, 0.5f, 0.5f, 1.0f);
-        if (!gotAntenna)
-            antenna.m_f4Tint = Vector4(0.5f, 0.5f, 0.5f, 1.0f);
-        if (!gotLogicBoard)
-            logicboard.m_f4Tint = Vector4(0.5f, 0.5f, 0.5f, 1.0f);
-
-        //Add transparency
-        if(!gotBattery)
-			battery.m_fAlpha = 0.50f;
-        else
-            battery.m_fAlpha = 1.0f;
-
-        if (!gotAntenna)
-            antenna.m_fAlpha = 0.50f;
-        else
-            antenna.m_fAlpha = 1.0f;
-
-        if (!gotLogicBoard)
-			logicboard.m_fAlpha = 0.50f;
-		else
-			logicboard.m_fAlpha = 1.0f;
-
-
-        if(radioOn)
-            m_pRenderer->Draw(&radio);
-		m_pRenderer->Draw(&battery);
-		m_pRenderer->Draw(&antenna);
-        m_pRenderer->Draw(&logicboard);
-	}
-
+/// Draw the retained heads-up display: the health bar, the clock frame with
+/// the sun or moon, the corn, the instructions, and the radio parts. The HUD
+/// only rebuilds its sprites when the state that it shows changes.
+
+void CGame::DrawHud() {
+    const bool bPlaying = m_eGameState != eGameState::Title &&
+        m_eGameState != eGameState::Victory && m_eGameState != eGameState::Tutorial;
+
+    CHudDesc d; //HUD descriptor
+    d.m_bPlaying = bPlaying;
+    d.m_nHealth = (bPlaying && m_pWorld->m_pPlayer)? m_pWorld->m_pPlayer->GetHealth(): 0;
+    d.m_nHunger = m_pWorld->m_pPlayer? m_pWorld->m_pPlayer->GetHungerCount(): 0;
+    d.m_bNight = isNight;
+    d.m_bBattery = m_pWorld->gotBattery;
+    d.m_bAntenna = m_pWorld->gotAntenna;
+    d.m_bLogicBoard = m_pWorld->gotLogicBoard;
+    d.m_bRadioOn = radioOn;
+    d.m_bFarm = isAbleToFarm;
+    d.m_bEat = isAbleToEat;
+    d.m_bBuild = isAbleToBuild;
+    d.m_bLeave = isAbleToLeave && m_eGameState != eGameState::Victory;
+
+    m_pHud->Draw(d);
 }
 
 void CGame::DrawFrameRateText(){
   const std::string s = std::to_string(m_pTimer->GetFPS()) + " fps"; //frame rate
   const Vector2 pos(m_nWinWidth - 128.0f, 30.0f); //hard-coded position
   m_pRenderer->DrawScreenText(s.c_str(), pos); //draw to screen
+
+  const std::string s2 = std::to_string(m_pWorld->m_pObjectManager->GetNumSpritesDrawn()) +
+    " drawn " + std::to_string(m_pWorld->m_pObjectManager->GetNumSpritesCulled()) +
+    " culled"; //culling stats
+  const Vector2 pos2(m_nWinWidth - 384.0f, 60.0f); //hard-coded position
+  m_pRenderer->DrawScreenText(s2.c_str(), pos2); //draw to screen
+
+  const std::string s3 = std::to_string(m_pDrawList->GetBatchBreaksBefore()) +
+    " -> " + std::to_string(m_pDrawList->GetBatchBreaksAfter()) +
+    " batch breaks"; //batching stats
+  const Vector2 pos3(m_nWinWidth - 384.0f, 90.0f); //hard-coded position
+  m_pRenderer->DrawScreenText(s3.c_str(), pos3); //draw to screen
+
+  #ifdef TRACK_ALLOCATIONS
+    for(UINT i=0; i<(UINT)eAlloc::Size; i++){ //live memory and allocations per tag
+      const CAllocStats a = CAllocTracker::GetStats((eAlloc)i); //allocation stats
+
+      const std::string s4 = std::string(CAllocTracker::GetName((eAlloc)i)) + " " +
+        std::to_string(a.m_nBytes/1024) + " KB " + std::to_string(a.m_nBlocks) +
+        " live " + std::to_string(a.m_nFrameAllocs) + "/frame"; //allocation text
+      const Vector2 pos4(m_nWinWidth - 384.0f, 120.0f + 30.0f*i); //hard-coded position
+      m_pRenderer->DrawScreenText(s4.c_str(), pos4); //draw to screen
+    } //for
+  #endif //TRACK_ALLOCATIONS
 } //DrawFrameRateText
 
+/// Respond to the player entering or leaving a trigger volume by setting the
+/// zone flag for that trigger type. The gameplay flags that depend on where
+/// the player is are computed from these instead of from the player's
+/// position.
+/// \param t Trigger type.
+/// \param bEnter true if entered, false if left.
+
+void CGame::OnTrigger(eTrigger t, bool bEnter){
+  m_bInZone[(UINT)t] = bEnter;
+} //OnTrigger
+
 /// Draw the god mode text to a hard-coded position in the window using the
 /// font specified in `gamesettings.xml`.
 
 void CGame::DrawGodModeText(){
-    Vector2 playerPos = m_pPlayer->GetPos();
-    if (playerPos.x >= 2119 && playerPos.x <= 2333 && playerPos.y >= 330 && playerPos.y <= 570) {
-        std::cout << "Player is in the farm" << std::endl;
+    if (m_bInZone[(UINT)eTrigger::Farm]) {
         const Vector2 pos(64.0f, 30.0f); //hard-coded position
         m_pRenderer->DrawScreenText("Farming..", pos); //draw to screen
     }
@@ -1129,44 +1361,43 @@ void CGame::DrawRadio() {
 /// pipelining jiggery-pokery.
 
 void CGame::RenderFrame(){
+  const CAllocScope scope(eAlloc::UI); //charge to the UI unless a subsystem says otherwise
   m_pRenderer->BeginFrame(); //required before rendering
 
   DrawBackground();
-  m_pObjectManager->draw(); //draw objects
-  m_pParticleEngine->Draw(); //draw particles
-  DrawHealthBar();
+  m_pWorld->m_pObjectManager->draw(); //draw objects and bullets
+  m_pWorld->m_pParticleEngine->Draw(); //draw particles
+  UpdateClock();
+  DrawHud();
   DrawClock();
-  DrawHunger();
   DrawProgressBar();
   DrawMessage("farmnight");
   DrawMessage("maxfood");
   DrawMessage("escapemessage");
-  DrawInstructions();
   DrawRadio();
-  DrawParts();
 
-  if (playerpos.x >= 2119 && playerpos.x <= 2333 && playerpos.y >= 330 && playerpos.y <= 570 && !isNight && m_pPlayer->GetHungerCount() < 3) {
+  if (m_bInZone[(UINT)eTrigger::Farm] && !isNight && m_pWorld->m_pPlayer->GetHungerCount() < 3) {
       isAbleToFarm = true;
   }
   else {
       isAbleToFarm = false;
   }
 
-  if (m_pPlayer->GetHungerCount() > 0 && m_pPlayer->GetHungerCount() <= 3 && m_pPlayer->GetHealth() < 12) {
+  if (m_pWorld->m_pPlayer->GetHungerCount() > 0 && m_pWorld->m_pPlayer->GetHungerCount() <= 3 && m_pWorld->m_pPlayer->GetHealth() < 12) {
       isAbleToEat = true;
   }
   else {
       isAbleToEat = false;
   }
-  //&& gotBattery && gotAntenna && gotLogicBoard
-  if (playerpos.x >= 1396 && playerpos.x <= 1496 && playerpos.y >= 359 && playerpos.y <= 504 && !radioOn && gotBattery && gotAntenna && gotLogicBoard) {
+  //&& m_pWorld->gotBattery && m_pWorld->gotAntenna && m_pWorld->gotLogicBoard
+  if (m_bInZone[(UINT)eTrigger::Workbench] && !radioOn && m_pWorld->gotBattery && m_pWorld->gotAntenna && m_pWorld->gotLogicBoard) {
       isAbleToBuild = true;
   }
   else {
 	  isAbleToBuild = false;
   }
   //
-  if (playerpos.x >= 962 && playerpos.x <= 1047 && playerpos.y >= 1172 && playerpos.y <= 1191 && radioOn) {
+  if (m_bInZone[(UINT)eTrigger::Exit] && radioOn) {
       isAbleToLeave = true;
   }
   else {
@@ -1188,8 +1419,9 @@ void CGame::RenderFrame(){
       showEscapeMessage = false;
   }
   
+  if(LoadingImages())DrawLoadingText(); //draw loading progress, if required
   if(m_bDrawFrameRate)DrawFrameRateText(); //draw frame rate, if required
-  if(m_bGodMode)DrawGodModeText(); //draw god mode text, if required
+  if(m_pWorld->m_bGodMode)DrawGodModeText(); //draw god mode text, if required
 
   m_pRenderer->EndFrame(); //required after rendering
 } //RenderFrame
@@ -1199,24 +1431,24 @@ void CGame::RenderFrame(){
 /// center everything.
 
 void CGame::FollowCamera() {
-    if (m_pPlayer == nullptr) return; //safety
+    if (m_pWorld->m_pPlayer == nullptr) return; //safety
 
-    Vector3 vCameraPos(m_pPlayer->GetPos()); //player position
+    Vector3 vCameraPos(m_pWorld->m_pPlayer->GetPos()); //player position
 
-    if (m_vWorldSize.x > m_nWinWidth) { //world wider than screen
+    if (m_pWorld->m_vWorldSize.x > m_nWinWidth) { //world wider than screen
         vCameraPos.x = std::max(vCameraPos.x, m_nWinWidth / 2.0f); //stay away from the left edge
-        vCameraPos.x = std::min(vCameraPos.x, m_vWorldSize.x - m_nWinWidth / 2.0f);  //stay away from the right edge
+        vCameraPos.x = std::min(vCameraPos.x, m_pWorld->m_vWorldSize.x - m_nWinWidth / 2.0f);  //stay away from the right edge
     }
     else {
-        vCameraPos.x = m_vWorldSize.x / 2.0f; //center horizontally.
+        vCameraPos.x = m_pWorld->m_vWorldSize.x / 2.0f; //center horizontally.
     }
 
-    if (m_vWorldSize.y > m_nWinHeight) { //world higher than screen
+    if (m_pWorld->m_vWorldSize.y > m_nWinHeight) { //world higher than screen
         vCameraPos.y = std::max(vCameraPos.y, m_nWinHeight / 2.0f);  //stay away from the bottom edge
-        vCameraPos.y = std::min(vCameraPos.y, m_vWorldSize.y - m_nWinHeight / 2.0f); //stay away from the top edge
+        vCameraPos.y = std::min(vCameraPos.y, m_pWorld->m_vWorldSize.y - m_nWinHeight / 2.0f); //stay away from the top edge
     }
     else {
-        vCameraPos.y = m_vWorldSize.y / 2.0f; //center vertically
+        vCameraPos.y = m_pWorld->m_vWorldSize.y / 2.0f; //center vertically
     }
 
     m_pRenderer->SetCameraPos(vCameraPos); //camera to player
@@ -1236,16 +1468,34 @@ Vector3 CGame::GetCameraPosition() {
 /// Move the game objects. Render a frame of animation. 
 
 void CGame::ProcessFrame(){
+  CAllocTracker::NewFrame(); //count this frame's allocations
   KeyboardHandler(); //handle keyboard input
   MouseHandler();
   ControllerHandler(); //handle controller input
-  m_pAudio->BeginFrame(); //notify audio player that frame has begun
+
+  if(SoundsLoaded()){ //the audio player is ours once the sounds are loaded
+    const CAllocScope scope(eAlloc::Audio); //charge to audio
+    m_pAudio->BeginFrame(); //notify audio player that frame has begun
+  } //if
+
+  LoadImages(m_nImagesPerFrame); //stream in some more images, if needed
   
   m_pTimer->Tick([&](){ //all time-dependent function calls should go here
-    m_fElapsedTime += m_pTimer->GetFrameTime(); //elapsed time in seconds
-    m_pObjectManager->move(); //move all objects
+    m_pWorld->m_fFrameTime = m_pTimer->GetFrameTime(); //simulation step for this world
+    m_fElapsedTime += m_pWorld->m_fFrameTime; //elapsed time in seconds
+
+    if(m_pClient && m_eGameState >= eGameState::Level1 && m_eGameState <= eGameState::Level7)
+      ClientStep(); //the server moves things
+
+    else{
+      m_pWorld->m_pObjectManager->move(); //move all objects
+      m_pWorld->m_pBulletManager->step(); //move bullets and resolve hits
+    } //else
+
     FollowCamera(); //make camera follow player
-    m_pParticleEngine->step(); //advance particle animation
+    if(m_pWorld->m_pPlayer)m_pTriggerManager->Update(m_pWorld->m_pPlayer->GetPos()); //check trigger volumes
+    m_pWorld->m_pParticleEngine->step(); //advance particle animation
+    RecordState(); //remember this tick
   });
   RenderFrame(); //render a frame of animation
   ProcessGameState(); //check for end of game
@@ -1255,6 +1505,14 @@ int CGame::GetGameHours(){
     return m_nGameHours;
 }
 
+/// Reader function for the game time in hours since midnight, which is
+/// easier to compare than the 12 hour clock.
+/// \return Hours since midnight, from 0 to 23.
+
+const int CGame::GetHourOfDay() const{
+  return m_nHourOfDay;
+} //GetHourOfDay
+
 std::string CGame::getAmPm() {
     	return m_nAmPm;
 }
@@ -1265,7 +1523,6 @@ std::string CGame::getAmPm() {
 /// state for longer than 3 seconds, then restart the game.
 
 void CGame::ProcessGameState() {
-    static float t = 0; // time at start of game
     switch (m_eGameState) {
     case eGameState::Title:
         if (mousePosNew.x >= 662 && mousePosNew.x <= 1257 && mousePosNew.y >= 496 && mousePosNew.y <= 600 && m_pKeyboard->TriggerDown(VK_LBUTTON)) {
@@ -1284,104 +1541,104 @@ void CGame::ProcessGameState() {
         }
         break;
     case eGameState::Level1:
-        //std::cout << "Zombie Count: " << m_pObjectManager->GetNumTurrets() << std::endl;
+        //std::cout << "Zombie Count: " << m_pWorld->m_pObjectManager->GetNumTurrets() << std::endl;
         
-        if (m_pPlayer == nullptr) {
-            gotBattery = false; gotAntenna = false; gotLogicBoard = false;
+        if (m_pWorld->m_pPlayer == nullptr && !m_pClient) { // a dead co-op player watches
+            m_pWorld->gotBattery = false; m_pWorld->gotAntenna = false; m_pWorld->gotLogicBoard = false;
             radioOn = false;
             m_eGameState = eGameState::Waiting1; // now waiting
-            t = m_pTimer->GetTime(); 
+            m_fWaitStart = m_pTimer->GetTime(); 
         }else if (helpCalled == true) {
             m_eGameState = eGameState::Victory;
-            m_pPlayer == nullptr;
-            m_pObjectManager->clear();
-            m_pParticleEngine->clear();
+            m_pWorld->m_pPlayer == nullptr;
+            m_pWorld->m_pObjectManager->clear();
+            m_pWorld->m_pParticleEngine->clear();
             //Stop sounds
             m_pAudio->stop(); //stop all  currently playing sounds
 
             BeginGame();
             
         }                                    // if
-        //else if (m_pObjectManager->GetNumTurrets() == 0) {
+        //else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
         //    m_eGameState = eGameState::Waiting2; // now waiting
-        //    t = m_pTimer->GetTime();             // start wait timer
+        //    m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         //}
         break;
     case eGameState::Victory:
-        t = m_pTimer->GetTime();
+        m_fWaitStart = m_pTimer->GetTime();
         if (m_pKeyboard->TriggerDown(VK_LBUTTON) || m_pKeyboard->TriggerDown(VK_SPACE)) {
             exit(0);
         }
-        if (m_pTimer->GetTime() - t > 3.0f) { // 3 seconds has elapsed since level end
+        if (m_pTimer->GetTime() - m_fWaitStart > 3.0f) { // 3 seconds has elapsed since level end
             m_eGameState = eGameState::Title;
             BeginGame();
         }              // if
         break;
     /*case eGameState::Level2:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting2; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        else if (m_pObjectManager->GetNumTurrets() == 0) {
+        else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting3; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }
         break;
     case eGameState::Level3:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting3; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        else if (m_pObjectManager->GetNumTurrets() == 0) {
+        else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting4; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }
         break;
     case eGameState::Level4:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting4; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        else if (m_pObjectManager->GetNumTurrets() == 0) {
+        else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting5; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }
         break;
     case eGameState::Level5:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting5; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        else if (m_pObjectManager->GetNumTurrets() == 0) {
+        else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting6; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }
         break;
     case eGameState::Level6:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting6; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        else if (m_pObjectManager->GetNumTurrets() == 0) {
+        else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting7; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }
         break;
     case eGameState::Level7:
-        if (m_pPlayer == nullptr) {
+        if (m_pWorld->m_pPlayer == nullptr) {
             m_eGameState = eGameState::Waiting7; // now waiting
-            t = m_pTimer->GetTime();             // start wait timer
+            m_fWaitStart = m_pTimer->GetTime();             // start wait timer
         }                                      // if
-        /*else if (m_pObjectManager->GetNumTurrets() == 0) {
+        /*else if (m_pWorld->m_pObjectManager->GetNumTurrets() == 0) {
             m_eGameState = eGameState::Waiting2; //now waiting
-            t = m_pTimer->GetTime(); //start wait timer
+            m_fWaitStart = m_pTimer->GetTime(); //start wait timer
         }*/
         //break;
     case eGameState::Waiting1:
         //m_pRenderer->DrawScreenText("Game Over", {0, 0});
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_nNextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level1;
             BeginGame(); // restart game
@@ -1390,45 +1647,45 @@ void CGame::ProcessGameState() {
     case eGameState::Waiting2:
         break;
     case eGameState::Waiting3:
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_n NextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level3;
             BeginGame(); // restart game
         }              // if
         break;
     case eGameState::Waiting4:
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_n NextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level4;
             BeginGame(); // restart game
         }              // if
         break;
     case eGameState::Waiting5:
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_n NextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level5;
             BeginGame(); // restart game
         }              // if
         break;
     case eGameState::Waiting6:
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_n NextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level6;
             BeginGame(); // restart game
         }              // if
         break;
     case eGameState::Waiting7:
-        if (m_pTimer->GetTime() - t >
+        if (m_pTimer->GetTime() - m_fWaitStart >
             3.0f) { // 3 seconds has elapsed since level end
-            // if(m_pObjectManager->GetNumTurrets() == 0) //player won
+            // if(m_pWorld->m_pObjectManager->GetNumTurrets() == 0) //player won
             // m_n NextLevel = (m_nNextLevel + 1) % 4; //note: 4 instead of 3
             m_eGameState = eGameState::Level7;
             BeginGame(); // restart game
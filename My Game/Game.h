@@ -10,7 +10,16 @@
 #include "Settings.h"
 #include "Player.h"
 #include "Mouse.h"
+#include "Hud.h"
+#include "TextCache.h"
+#include "TriggerManager.h"
+#include "SaveGame.h"
+#include "StateHistory.h"
+#include "World.h"
+#include "Client.h"
 #include <iostream>
+#include <future>
+#include <string>
 
 /// \brief The game class.
 ///
@@ -27,11 +36,25 @@ class CGame:
   public CCommon{ 
 
   private:
-    LMouse* m_pMouse;
+    CClient* m_pClient = nullptr; ///< Pointer to co-op client, if connected.
+    float m_fAimRotation = 0.0f; ///< Player orientation from the mouse, in degrees.
+    LMouse* m_pMouse = nullptr; ///< Pointer to mouse handler.
+    size_t m_nImagesLoaded = 0; ///< Number of images loaded so far.
+    const size_t m_nImagesPerFrame = 4; ///< Number of images streamed in per frame.
+    CHud* m_pHud = nullptr; ///< Pointer to heads-up display.
+    CTextCache* m_pTextCache = nullptr; ///< Pointer to text cache.
+    CTriggerManager* m_pTriggerManager = nullptr; ///< Pointer to trigger volumes.
+    CTileManager* m_pNextTileManager = nullptr; ///< Spare tile manager for prefetching maps.
+    std::future<void> m_futPrefetch; ///< Map prefetch in progress.
+    std::future<void> m_futSounds; ///< Sound loading in progress.
+    std::future<bool> m_futSave; ///< Save game write in progress.
+    std::string m_strPrefetched; ///< Name of map in spare tile manager.
+    bool m_bInZone[(UINT)eTrigger::Size] = {false}; ///< Player is in each trigger type.
     void NormalizeAngle(float& angle);
     float RadToDeg(float radians);
     bool m_bDrawFrameRate = false; ///< Draw the frame rate.
     eGameState m_eGameState = eGameState::Title; ///< Game state.
+    eGameState m_eSnapshotState = eGameState::Title; ///< Level in object manager's snapshot.
     int m_nNextLevel = 0; ///< Current level number.
     float m_fRotationSpeed = 0.05f;
     float m_fElapsedTime = 0.0f; // Elapsed time in seconds
@@ -39,6 +62,21 @@ class CGame:
     bool isNight = false;
     int m_nGameHours = 0; // Game time in hours
     std::string m_nAmPm = "";
+    std::string m_strClock; ///< Clock text.
+    int m_nClockKey = -1; ///< Day and minute that the clock text shows.
+    Vector2 m_vClockPos; ///< Clock text position.
+    int m_nHourOfDay = 12; ///< Game time in hours since midnight.
+    int m_nDayIndex = 0; ///< Day of the week, 0 is Monday.
+    bool m_bIncrementedDay = false; ///< Day already advanced this midnight.
+    bool m_bSpawnedZombies = false; ///< Zombies already spawned tonight.
+    int m_nAutosaveHour = -1; ///< Hour of day last autosaved, -1 for none.
+    std::vector<CSavedObject> m_vecSaved; ///< Saved objects buffer.
+    std::vector<CNetObject> m_vecNetObjects; ///< Networked objects buffer.
+    CStateHistory m_cHistory{300}; ///< Recent simulation states.
+    std::vector<char> m_vecState; ///< Simulation state buffer.
+    const size_t m_nRewindTicks = 120; ///< Number of ticks to go back when rewinding.
+    float m_fWaitStart = 0.0f; ///< Time the current wait started.
+    float m_fLastEatTime = 0.0f; ///< Time the player last ate.
     float m_fKeyStartTime = 0.0f; // Time the key was pressed
     bool farming = false;
     Vector2 playerpos; //player positions
@@ -51,7 +89,6 @@ class CGame:
     bool showfoodMessage = false;
     float lastfoodMessageTime = 0.0f; // Last time a message was drawn
     float m_fLastShotTime = 0.0f; // Last time a shot was fired
-    const float SHOT_COOLDOWN = 0.35f; // Minimum time interval between shots in seconds
     bool isAbleToFarm = false;
     bool isAbleToEat = false;
     bool isAbleToBuild = false;
@@ -65,6 +102,8 @@ class CGame:
     bool spawnedBattery = false;
     bool spawnedLogic = false;
     bool spawnedAntenna = false;
+    bool radioOn = false; ///< Radio has been built.
+    bool helpCalled = false; ///< Radio has been used to call for help.
 
     POINT mousePos, mousePosNew;
 
@@ -80,9 +119,27 @@ class CGame:
 
 
     
-    void LoadImages(); ///< Load images.
-    void LoadSounds(); ///< Load sounds.
+    void LoadImages(size_t); ///< Load some images.
+    const bool LoadingImages() const; ///< Are images still loading?
+    void DrawLoadingText(); ///< Draw image loading progress.
+    void LoadSounds(); ///< Start loading sounds.
+    const bool SoundsLoaded(); ///< Have the sounds finished loading?
+    void WaitForSounds(); ///< Wait for the sounds to finish loading.
     void BeginGame(); ///< Begin playing the game.
+    void PrefetchMap(const char*); ///< Read a map in the background.
+    void LoadMap(const char*); ///< Load a map, prefetched if possible.
+    void StartLevel(const char*, bool); ///< Start or restart a level.
+    const bool SaveGame(const char*); ///< Save the game.
+    const bool WaitForSave(); ///< Wait for a save to be written.
+    const bool LoadGame(const char*); ///< Load a saved game.
+    void GetSaveHeader(CSaveHeader&); ///< Fill in save header from game.
+    void SetSaveHeader(const CSaveHeader&); ///< Put save header into game.
+    void GetState(std::vector<char>&); ///< Get save header and objects in one buffer.
+    void RecordState(); ///< Record simulation state for this tick.
+    const bool Rewind(size_t); ///< Go back some ticks.
+    void StartNetwork(); ///< Connect to server, if asked to.
+    const UINT GetNetButtons(); ///< Get buttons to send to server.
+    void ClientStep(); ///< Exchange input and snapshot with server.
     void KeyboardHandler(); ///< The keyboard handler.
     void ControllerHandler(); ///< The controller handler.
     void RenderFrame(); ///< Render an animation frame.
@@ -90,18 +147,17 @@ class CGame:
     void DrawGodModeText(); ///< Draw god mode text if in god mode.
     void CreateObjects(); ///< Create game objects.
     void FollowCamera(); ///< Make camera follow player character.
+    void OnTrigger(eTrigger, bool); ///< Respond to trigger volume event.
     void ProcessGameState(); ///< Process game state.
     void MouseHandler();
-    void DrawHealthBar();
-    void DrawClock();
-    void DrawHunger();
+    void UpdateClock(); ///< Advance the game clock.
+    void DrawHud(); ///< Draw the heads-up display.
+    void DrawClock(); ///< Draw the clock text.
     void DrawProgressBar();
     void DrawMessage(std::string message);
     void DrawBackground();
     void DrawRadio();
     Vector3 GetCameraPosition();
-    void DrawInstructions();
-    void DrawParts();
     void DrawPartsOnTable();
     
 
@@ -112,6 +168,7 @@ class CGame:
     void ProcessFrame(); ///< Process an animation frame.
     void Release(); ///< Release the renderer.
     int GetGameHours(); ///< Get the game time.
+    const int GetHourOfDay() const; ///< Get the game time on a 24 hour clock.
     bool getIsNight();
     std::string getAmPm();
 }; //CGame
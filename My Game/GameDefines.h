@@ -28,6 +28,64 @@ enum class eSound: UINT{
   Size  //MUST BE LAST
 }; //eSound
 
+/// \brief Object type enumerated type.
+///
+/// An enumerated type for the categories that the object manager indexes
+/// objects under, which will be cast to an unsigned integer and used for the
+/// index of the corresponding per-type list. `Size` must be last.
+
+enum class eObjectType: UINT{
+  Zombie, Turret, Radio, Static, Other,
+  Size  //MUST BE LAST
+}; //eObjectType
+
+/// \brief Draw layer enumerated type.
+///
+/// An enumerated type for the layers of the draw list, which will be cast to
+/// an unsigned integer and used for the top bits of the sort key. Layers are
+/// drawn in order, so later layers are drawn over earlier ones. `Size` must
+/// be last.
+
+enum class eDrawLayer: UINT{
+  Ground, Object, Bullet,
+  Size  //MUST BE LAST
+}; //eDrawLayer
+
+/// \brief Trigger type enumerated type.
+///
+/// An enumerated type for the kinds of trigger volume that the player can
+/// walk into, which will be cast to an unsigned integer and used as an index.
+/// The names used in map zone files are listed in `CTileManager`. `Size`
+/// must be last.
+
+enum class eTrigger: UINT{
+  Farm, Workbench, Exit,
+  Size  //MUST BE LAST
+}; //eTrigger
+
+/// \brief Allocation tag enumerated type.
+///
+/// An enumerated type for the subsystems that heap allocations are charged
+/// to, which will be cast to an unsigned integer and used as an index into
+/// the allocation tracker's counters. Allocations made outside of any
+/// allocation scope are charged to `Other`. `Size` must be last.
+
+enum class eAlloc: UINT{
+  Other, Objects, Map, Particles, UI, Audio,
+  Size  //MUST BE LAST
+}; //eAlloc
+
+/// \brief Log level enumerated type.
+///
+/// An enumerated type for how important a log message is, in increasing
+/// order. The numbers must match the ones that `LOG_LEVEL` is compared
+/// against in `Log.h`. `Size` must be last.
+
+enum class eLogLevel: UINT{
+  Debug, Info, Warning, Error,
+  Size  //MUST BE LAST
+}; //eLogLevel
+
 /// \brief Game state enumerated type.
 ///
 /// An enumerated type for the game state, which can be either playing or
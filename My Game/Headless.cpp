@@ -0,0 +1,245 @@
+/// \file Headless.cpp
+/// \brief Code for the headless runner CHeadless.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Headless.h"
+#include "AssetPack.h"
+#include "AllocTracker.h"
+#include "ObjectManager.h"
+#include "BulletManager.h"
+#include "TileManager.h"
+#include "World.h"
+#include "Player.h"
+#include "Server.h"
+#include "BalanceSim.h"
+#include "DrawTest.h"
+#include "Helpers.h"
+#include "Log.h"
+
+static const char* SERVER_MAP = "Media\\Maps\\map1.txt"; ///< Map for co-op sessions.
+static const UINT SOAK_TICKS = 300; ///< Ticks played per level start in the soak test.
+
+std::atomic<bool> CHeadless::m_bStop(false);
+
+/// Whether the command line asks for something that is done headless.
+/// \return true if it does.
+
+const bool CHeadless::IsRequested(){
+  std::istringstream args(GetCommandLineA()); //command line arguments
+  std::string arg; //current argument
+
+  while(args >> arg)
+    if(arg == "-server" || arg == "-soak" || arg == "-balance" || arg == "-drawtest")
+      return true;
+
+  return false;
+} //IsRequested
+
+/// Stop when the console is closed or sent Ctrl+C or Ctrl+Break. Which of
+/// those it was doesn't matter, so the event isn't named.
+/// \return TRUE, since the event has been handled.
+
+BOOL WINAPI CHeadless::OnConsoleEvent(DWORD){
+  m_bStop = true;
+  return TRUE;
+} //OnConsoleEvent
+
+/// Do what the command line asks for. The console that started the program,
+/// if any, is used for output and for the log, and the asset pack is opened,
+/// but there is no window, renderer, or sound.
+/// \return Exit code, 0 for success.
+
+const int CHeadless::Run(){
+  if(AttachConsole(ATTACH_PARENT_PROCESS)){ //write to the console
+    FILE* f = nullptr; //reopened stream
+    freopen_s(&f, "CONOUT$", "w", stdout);
+  } //if
+
+  SetConsoleCtrlHandler(OnConsoleEvent, TRUE);
+
+  std::istringstream args(GetCommandLineA()); //command line arguments
+  std::string arg; //current argument
+  UINT port = NET_PORT; //server port
+  UINT rounds = 0; //number of soak test rounds
+  bool bBalance = false; //whether to run the balance harness
+  bool bDrawTest = false; //whether to run the draw test
+
+  while(args >> arg)
+    if(arg == "-port")args >> port;
+    else if(arg == "-soak")args >> rounds;
+    else if(arg == "-balance")bBalance = true;
+    else if(arg == "-drawtest")bDrawTest = true;
+
+  CLog::Start(bBalance? "balance.log": bDrawTest? "drawtest.log":
+    rounds > 0? "soak.log": "server.log"); //write log messages in the background
+
+  m_pAssetPack = new CAssetPack; //set up the asset pack
+  m_pAssetPack->Open("Media\\media.pack"); //use loose files if there's no pack
+
+  int code = 0; //exit code
+
+  if(bBalance)code = CBalanceSim(GetCommandLineA()).Run(m_bStop);
+  else if(bDrawTest)code = CDrawTest().Run();
+  else if(rounds > 0)code = Soak(rounds);
+  else code = Serve((uint16_t)port);
+
+  delete m_pAssetPack;
+  m_pAssetPack = nullptr;
+  CLog::Stop();
+
+  return code;
+} //Run
+
+/// Serve co-op sessions until asked to stop, writing the number of sessions
+/// and players to the console whenever it changes.
+/// \param port Port to serve on.
+/// \return Exit code, 0 for success.
+
+const int CHeadless::Serve(uint16_t port){
+  CServer server; //co-op server
+
+  if(!server.Start(port, SERVER_MAP)){
+    LOG_ERROR("Cannot serve on port %u.", (UINT)port);
+    return 1;
+  } //if
+
+  printf("Serving on port %u.\n", (UINT)port);
+  size_t sessions = 0, players = 0; //last numbers written
+
+  while(!m_bStop){
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const size_t s = server.GetNumSessions(); //number of sessions
+    const size_t p = server.GetNumClients(); //number of players
+
+    if(s != sessions || p != players){
+      printf("Serving %zu sessions, %zu players.\n", s, p);
+      fflush(stdout);
+      sessions = s;
+      players = p;
+    } //if
+  } //while
+
+  server.Stop();
+  printf("Stopped serving.\n");
+  return 0;
+} //Serve
+
+/// Run the allocation soak test. Each round starts level 1, restarts it,
+/// starts level 2 and restarts that, and plays a few seconds of each in a
+/// world of its own, spawning zombies and firing at them so that objects and
+/// bullets come and go. The world has no particle engine, since there is no
+/// renderer. If the zombies kill the player, the level is restarted. The
+/// first two rounds let buffers grow to their working sizes.
+/// After that, the live bytes charged to each allocation tag at the end of a
+/// round must be no more than at the end of round 2. The figures for each
+/// round are written to `soak.txt`.
+/// \param rounds Number of rounds, at least 3.
+/// \return Exit code, 0 if nothing grew and 1 if something did or if
+/// allocation tracking isn't compiled in.
+
+const int CHeadless::Soak(UINT rounds){
+  #ifdef TRACK_ALLOCATIONS
+    const bool bTracking = true; //allocation tracking is compiled in
+  #else
+    const bool bTracking = false; //allocation tracking is compiled out
+  #endif //TRACK_ALLOCATIONS
+
+  if(!bTracking){
+    LOG_ERROR("The soak test needs allocation tracking, which isn't compiled in.");
+    return 1;
+  } //if
+
+  rounds = std::max(rounds, 3U); //need rounds after the warm-up to check
+
+  FILE* output = nullptr; //report file
+  fopen_s(&output, "soak.txt", "wt");
+
+  const char* maps[] = {"Media\\Maps\\map1.txt", "Media\\Maps\\map1.txt",
+    "Media\\Maps\\map2.txt", "Media\\Maps\\map2.txt"}; //start and restart each level
+
+  CAllocStats baseline[(UINT)eAlloc::Size]; //live allocations after warm-up
+  bool bGrew = false; //whether anything grew since the warm-up
+
+  CWorld world((size_t)GetSpriteSize(eSprite::Tile).x, nullptr, 1); //the world played in
+  m_pWorld = &world;
+  m_pWorld->m_fFrameTime = 1.0f/60.0f;
+  m_pWorld->m_bMute = true;
+
+  std::string level; //map of the level started last
+
+  for(UINT round=1; round<=rounds && !m_bStop; round++){
+    for(const char* map: maps){
+      m_pWorld->m_pBulletManager->clear();
+
+      if(level == map) //restart
+        m_pWorld->RestoreLevel();
+
+      else{ //start
+        m_pWorld->m_pObjectManager->clear();
+        m_pWorld->m_pTileManager->LoadMap(map);
+        m_pWorld->CreateLevel(true);
+        level = map;
+      } //else
+
+      for(UINT t=0; t<SOAK_TICKS; t++){
+        if(m_pWorld->m_pPlayer == nullptr){ //the zombies got the player
+          m_pWorld->m_pBulletManager->clear();
+          m_pWorld->RestoreLevel();
+        } //if
+
+        if(t%30 == 0){ //zombie at some distance from the player
+          const float a = t*0.1f; //angle
+          m_pWorld->m_pObjectManager->create(eSprite::Zombie2,
+            m_pWorld->m_pPlayer->GetPos() + 320.0f*Vector2(cosf(a), sinf(a)));
+        } //if
+
+        if(t%10 == 0){ //sweep the gun around
+          m_pWorld->m_pPlayer->SetRotation(t*12.0f);
+          m_pWorld->m_pObjectManager->FireGun(m_pWorld->m_pPlayer, eSprite::Bullet);
+        } //if
+
+        m_pWorld->m_pObjectManager->move();
+        m_pWorld->m_pBulletManager->step();
+      } //for
+    } //for
+
+    if(output)fprintf(output, "round %u:", round);
+
+    for(UINT i=0; i<(UINT)eAlloc::Size; i++){
+      const CAllocStats s = CAllocTracker::GetStats((eAlloc)i); //live now
+      const char* name = CAllocTracker::GetName((eAlloc)i); //tag name
+
+      if(round == 2)baseline[i] = s;
+
+      else if(round > 2 && s.m_nBytes > baseline[i].m_nBytes){
+        bGrew = true;
+
+        if(output)fprintf(output, " [%s grew by %zu bytes]", name,
+          s.m_nBytes - baseline[i].m_nBytes);
+      } //else if
+
+      if(output)fprintf(output, " %s %zu bytes in %zu blocks;", name,
+        s.m_nBytes, s.m_nBlocks);
+    } //for
+
+    if(output)fprintf(output, "\n");
+    printf("Soak test round %u of %u done.\n", round, rounds);
+  } //for
+
+  m_pWorld = nullptr;
+
+  if(output){
+    fprintf(output, bGrew? "FAILED\n": "passed\n");
+    fclose(output);
+  } //if
+
+  printf(bGrew? "Soak test FAILED, see soak.txt.\n": "Soak test passed.\n");
+  return bGrew? 1: 0;
+} //Soak
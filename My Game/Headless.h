@@ -0,0 +1,39 @@
+/// \file Headless.h
+/// \brief Interface for the headless runner CHeadless.
+
+#ifndef __L4RC_GAME_HEADLESS_H__
+#define __L4RC_GAME_HEADLESS_H__
+
+#include <atomic>
+
+#include "Common.h"
+
+/// \brief The headless runner.
+///
+/// Some of the things that the game can be asked to do on the command line
+/// need no window, renderer, or sound, so they are done without creating
+/// any. `-server` serves co-op sessions on the default port, or the one
+/// given by `-port`, until the console is closed or sent Ctrl+C. `-soak`
+/// followed by a number of rounds runs the allocation soak test, `-balance`
+/// followed by a number of games runs the balance harness `CBalanceSim`, and
+/// `-drawtest` runs the draw test `CDrawTest`. The asset pack is opened so
+/// that maps can be read, and sprite sizes come from the generated sprite
+/// size table, so worlds run without a renderer and have no particle engine.
+/// Output goes to the console that started the program, if there is one.
+
+class CHeadless:
+  public CCommon
+{
+  private:
+    static std::atomic<bool> m_bStop; ///< Asked to stop.
+
+    static BOOL WINAPI OnConsoleEvent(DWORD); ///< Console event handler.
+    const int Serve(uint16_t); ///< Serve co-op sessions.
+    const int Soak(UINT); ///< Run the allocation soak test.
+
+  public:
+    static const bool IsRequested(); ///< Whether the command line asks for this.
+    const int Run(); ///< Do what the command line asks for.
+}; //CHeadless
+
+#endif //__L4RC_GAME_HEADLESS_H__
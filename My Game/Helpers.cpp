@@ -2,6 +2,11 @@
 /// \brief Code for helper functions.
 
 #include "Helpers.h"
+#include "SpriteSizes.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <vector>
 
 /// Compute a unit vector at an angle measured in radians counterclockwise
 /// from the positive X-axis. If \f$\vec{v} = [v_x, v_y]\f$
@@ -45,3 +50,152 @@ void NormalizeAngle(float& theta){
   while(theta < -XM_PI)theta += XM_2PI;
   while(theta >  XM_PI)theta -= XM_2PI;
 } //NormalizeAngle
+
+/// Get the width and height of a sprite from the sprite size table that
+/// AtlasBuilder generates, which is what the renderer reports for it once it
+/// is loaded. This lets the simulation run without a renderer. The table is
+/// put into sprite order the first time this is called.
+/// \param t Sprite type.
+/// \return Width and height in pixels, or zero if the sprite isn't in the table.
+
+const Vector2 GetSpriteSize(eSprite t){
+  static const std::vector<Vector2> sizes = [](){ //sizes in sprite order
+    std::vector<Vector2> v((size_t)eSprite::Size, Vector2::Zero);
+
+    for(const SpriteSize& s: SPRITE_SIZES)
+      v[(size_t)s.m_eSprite] = Vector2((float)s.m_nWidth, (float)s.m_nHeight);
+
+    return v;
+  }(); //sizes
+
+  return (size_t)t < sizes.size()? sizes[(size_t)t]: Vector2::Zero;
+} //GetSpriteSize
+
+/// Find the earliest time at which a circle moving along a line segment
+/// touches an AABB. The AABB is expanded by the circle radius and the segment
+/// is clipped against it one axis at a time (the slab method). If the point
+/// of entry is beyond a corner of the original AABB, then the expanded box's
+/// square corner is not really part of it, and the segment is tested against
+/// a circle of the same radius at that corner instead, so that circles
+/// passing close to a corner are neither missed nor stopped early. A circle
+/// that already overlaps the AABB at the start of the segment touches it at
+/// time zero.
+/// \param p Circle center at the start of the segment.
+/// \param v Displacement of the circle center along the segment.
+/// \param r Circle radius.
+/// \param aabb Axially aligned bounding box.
+/// \param t [out] Fraction of v at first contact, in \f$[0, 1]\f$.
+/// \param norm [out] Collision normal pointing out of the AABB.
+/// \return true if the circle touches the AABB along the segment.
+
+const bool SweepCircleVsAABB(const Vector2& p, const Vector2& v, float r,
+  const BoundingBox& aabb, float& t, Vector2& norm)
+{
+  const float lo[2] = {aabb.Center.x - aabb.Extents.x, aabb.Center.y - aabb.Extents.y};
+  const float hi[2] = {aabb.Center.x + aabb.Extents.x, aabb.Center.y + aabb.Extents.y};
+  const float pos[2] = {p.x, p.y}; //start position
+  const float vel[2] = {v.x, v.y}; //displacement
+
+  //overlapping at start
+
+  const Vector2 q(std::min(std::max(p.x, lo[0]), hi[0]),
+    std::min(std::max(p.y, lo[1]), hi[1])); //closest point of AABB
+  Vector2 d = p - q; //from closest point to center
+
+  if(d.Dot(d) <= r*r){
+    t = 0;
+    norm = (d.Dot(d) > 0.0f)? d: -v;
+    norm.Normalize();
+    return true;
+  } //if
+
+  //clip against the expanded AABB
+
+  float tEnter = -FLT_MAX; //latest entry time over both axes
+  float tExit = 1.0f; //earliest exit time over both axes
+  int nAxis = -1; //axis of latest entry
+
+  for(int i=0; i<2; i++){ //for each axis
+    if(vel[i] == 0.0f){ //moving parallel to this slab
+      if(pos[i] < lo[i] - r || pos[i] > hi[i] + r)
+        return false; //outside the slab and never enters it
+    } //if
+
+    else{
+      float t0 = (lo[i] - r - pos[i])/vel[i]; //time of crossing low side
+      float t1 = (hi[i] + r - pos[i])/vel[i]; //time of crossing high side
+      if(t0 > t1)std::swap(t0, t1);
+
+      if(t0 > tEnter){
+        tEnter = t0;
+        nAxis = i;
+      } //if
+
+      tExit = std::min(tExit, t1);
+
+      if(tEnter > tExit || tExit < 0.0f)
+        return false; //slabs do not overlap on the segment
+    } //else
+  } //for
+
+  if(nAxis < 0)return false; //not moving
+
+  //test the corner instead if the entry point is beyond one
+
+  const float t0 = std::max(tEnter, 0.0f); //time of entry into expanded AABB
+  const Vector2 c = p + t0*v; //point of entry
+  const bool bBeyondX = c.x < lo[0] || c.x > hi[0]; //beyond the AABB horizontally
+  const bool bBeyondY = c.y < lo[1] || c.y > hi[1]; //beyond the AABB vertically
+
+  if(bBeyondX && bBeyondY){
+    const Vector2 corner(c.x < lo[0]? lo[0]: hi[0], c.y < lo[1]? lo[1]: hi[1]);
+    if(!SweepCircleVsCircle(p, v, r, corner, 0.0f, t))return false;
+    norm = p + t*v - corner;
+    norm.Normalize();
+    return true;
+  } //if
+
+  t = t0;
+  norm = (nAxis == 0)? Vector2(vel[0] > 0? -1.0f: 1.0f, 0.0f):
+    Vector2(0.0f, vel[1] > 0? -1.0f: 1.0f);
+
+  return true;
+} //SweepCircleVsAABB
+
+/// Find the earliest time at which a circle moving along a line segment
+/// touches a stationary circle. This is a ray cast against a circle whose
+/// radius is the sum of the two radii. A circle that already overlaps the
+/// stationary circle at the start of the segment touches it at time zero.
+/// \param p Moving circle center at the start of the segment.
+/// \param v Displacement of the moving circle center along the segment.
+/// \param r Moving circle radius.
+/// \param c Stationary circle center.
+/// \param rc Stationary circle radius.
+/// \param t [out] Fraction of v at first contact, in \f$[0, 1]\f$.
+/// \return true if the circles touch along the segment.
+
+const bool SweepCircleVsCircle(const Vector2& p, const Vector2& v, float r,
+  const Vector2& c, float rc, float& t)
+{
+  const Vector2 m = p - c; //from stationary center to start position
+  const float R = r + rc; //combined radius
+  const float cc = m.Dot(m) - R*R; //negative if overlapping at start
+
+  if(cc <= 0.0f){ //already overlapping at start
+    t = 0;
+    return true;
+  } //if
+
+  const float b = m.Dot(v);
+  if(b >= 0.0f)return false; //moving away
+
+  const float a = v.Dot(v);
+  const float disc = b*b - a*cc; //discriminant
+  if(disc < 0.0f)return false; //line misses
+
+  const float t0 = (-b - sqrtf(disc))/a; //first root
+  if(t0 > 1.0f)return false; //hit is beyond end of segment
+
+  t = t0;
+  return true;
+} //SweepCircleVsCircle
@@ -9,5 +9,11 @@
 const Vector2 AngleToVector(const float theta); ///< Convert angle to vector.
 const Vector2 VectorNormalCC(const Vector2& v); ///< Counterclockwise normal.
 void NormalizeAngle(float& theta); ///< Normalize angle to \f$\pm\pi\f$.
+const Vector2 GetSpriteSize(eSprite); ///< Get sprite width and height.
+
+const bool SweepCircleVsAABB(const Vector2&, const Vector2&, float,
+  const BoundingBox&, float&, Vector2&); ///< Moving circle vs AABB.
+const bool SweepCircleVsCircle(const Vector2&, const Vector2&, float,
+  const Vector2&, float, float&); ///< Moving circle vs circle.
 
 #endif //__L4RC_GAME_HELPERS_H__
\ No newline at end of file
@@ -12,7 +12,7 @@ protected:
         CObject* = nullptr); ///< Collision response.
 
 public:
-    CHouse(eSprite t, const Vector2& p); ///< Constructor.
+    CHouse(CWorld* pWorld, eSprite t, const Vector2& p); ///< Constructor.
 }; //CBullet
 
 #endif
\ No newline at end of file
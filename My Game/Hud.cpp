@@ -0,0 +1,134 @@
+/// \file Hud.cpp
+/// \brief Code for the heads-up display CHud.
+
+#include "Hud.h"
+#include "SpriteRenderer.h"
+
+/// Test whether two HUD descriptors would produce the same sprites.
+/// \param d HUD descriptor to compare against.
+/// \return true if they are the same.
+
+const bool CHudDesc::operator==(const CHudDesc& d) const{
+  return m_bPlaying == d.m_bPlaying && m_nHealth == d.m_nHealth &&
+    m_nHunger == d.m_nHunger && m_bNight == d.m_bNight &&
+    m_bBattery == d.m_bBattery && m_bAntenna == d.m_bAntenna &&
+    m_bLogicBoard == d.m_bLogicBoard && m_bRadioOn == d.m_bRadioOn &&
+    m_bFarm == d.m_bFarm && m_bEat == d.m_bEat &&
+    m_bBuild == d.m_bBuild && m_bLeave == d.m_bLeave;
+} //operator==
+
+/// Reserve space for all of the HUD sprites.
+
+CHud::CHud(){
+  m_vecSprites.reserve(32);
+} //constructor
+
+/// Append a sprite to the cached sprites.
+/// \param t Sprite type.
+/// \param pos World position.
+/// \return Reference to the new sprite descriptor.
+
+LSpriteDesc2D& CHud::Add(eSprite t, const Vector2& pos){
+  m_vecSprites.emplace_back();
+  LSpriteDesc2D& desc = m_vecSprites.back(); //shorthand
+  desc.m_nSpriteIndex = (UINT)t;
+  desc.m_vPos = pos;
+  return desc;
+} //Add
+
+/// Rebuild the cached sprites from the current HUD descriptor. The offsets
+/// from the camera position are the HUD layout.
+/// \param c Camera position.
+
+void CHud::Rebuild(const Vector2& c){
+  const CHudDesc& d = m_cDesc; //shorthand
+  m_vecSprites.clear();
+  m_nRebuilds++;
+
+  if(d.m_bPlaying){ //health bar and clock frame
+    LSpriteDesc2D& frame = Add(eSprite::Frame, c + Vector2(-845, -470));
+    frame.m_fXScale = 0.5f;
+    frame.m_fAlpha = 0.75f;
+
+    eSprite t = eSprite::HealthBar0; //health bar sprite
+
+    switch(d.m_nHealth){
+      case 12: t = eSprite::HealthBar;   break;
+      case 9:  t = eSprite::HealthBar60; break;
+      case 6:  t = eSprite::HealthBar40; break;
+      case 3:  t = eSprite::HealthBar20; break;
+    } //switch
+
+    Add(t, c + Vector2(-850, -470));
+    Add(eSprite::Frame, c + Vector2(-750, 487)).m_fAlpha = 0.75f;
+    Add(d.m_bNight? eSprite::Moon: eSprite::Sun, c + Vector2(-530, 487)).m_fAlpha = 0.75f;
+  } //if
+
+  for(int i=0; i<std::min(d.m_nHunger, 3); i++) //one corn per hunger point
+    Add(eSprite::Corn, c + Vector2(-730.0f + 15*i, -470));
+
+  //instructions
+
+  if(d.m_bFarm)Add(eSprite::PressToFarm, c + Vector2(770, -460));
+  if(d.m_bEat)Add(eSprite::PressToEat, c + Vector2(770, -440));
+  if(d.m_bBuild)Add(eSprite::PressToBuild, c + Vector2(773, -460));
+  if(d.m_bLeave)Add(eSprite::PressToLeave, c + Vector2(773, -460));
+
+  if(d.m_bPlaying){ //radio parts, greyed out if not collected
+    if(d.m_bRadioOn)
+      Add(eSprite::Radio, c + Vector2(-920, -420));
+
+    const eSprite part[3] = {eSprite::Battery, eSprite::Antenna, eSprite::LogicBoard};
+    const bool got[3] = {d.m_bBattery, d.m_bAntenna, d.m_bLogicBoard};
+
+    for(int i=0; i<3; i++){
+      LSpriteDesc2D& desc = Add(part[i], c + Vector2(-830.0f + 30*i, -420));
+
+      if(!got[i]){
+        desc.m_f4Tint = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
+        desc.m_fAlpha = 0.5f;
+      } //if
+    } //for
+  } //if
+
+  m_vCameraPos = c;
+  m_bValid = true;
+} //Rebuild
+
+/// Draw the HUD. The cached sprites are rebuilt if the HUD descriptor has
+/// changed, otherwise they are moved with the camera if it has moved.
+/// \param d HUD descriptor.
+
+void CHud::Draw(const CHudDesc& d){
+  const Vector2 c = (Vector2)m_pRenderer->GetCameraPos(); //camera position
+
+  if(!m_bValid || !(d == m_cDesc)){ //rebuild
+    m_cDesc = d;
+    Rebuild(c);
+  } //if
+
+  else if(c != m_vCameraPos){ //follow camera
+    const Vector2 delta = c - m_vCameraPos; //camera motion
+
+    for(LSpriteDesc2D& desc: m_vecSprites)
+      desc.m_vPos += delta;
+
+    m_vCameraPos = c;
+  } //else if
+
+  for(const LSpriteDesc2D& desc: m_vecSprites)
+    m_pRenderer->Draw(&desc);
+} //Draw
+
+/// Force the sprites to be rebuilt on the next draw.
+
+void CHud::Invalidate(){
+  m_bValid = false;
+} //Invalidate
+
+/// Reader function for the number of rebuilds.
+/// \return Number of times the sprites have been rebuilt.
+
+const size_t CHud::GetNumRebuilds() const{
+  return m_nRebuilds;
+} //GetNumRebuilds
@@ -0,0 +1,67 @@
+/// \file Hud.h
+/// \brief Interface for the heads-up display CHud.
+
+#ifndef __L4RC_GAME_HUD_H__
+#define __L4RC_GAME_HUD_H__
+
+#include <vector>
+
+#include "Common.h"
+#include "SpriteDesc.h"
+#include "GameDefines.h"
+
+/// \brief HUD descriptor.
+///
+/// The game state that the heads-up display depends on. The HUD is only
+/// rebuilt when this changes.
+
+class CHudDesc{
+  public:
+    bool m_bPlaying = false; ///< Draw the health bar, clock frame, and parts.
+    UINT m_nHealth = 0; ///< Player health.
+    int m_nHunger = 0; ///< Number of corn held.
+    bool m_bNight = false; ///< Draw the moon instead of the sun.
+
+    bool m_bBattery = false; ///< Got the battery.
+    bool m_bAntenna = false; ///< Got the antenna.
+    bool m_bLogicBoard = false; ///< Got the logic board.
+    bool m_bRadioOn = false; ///< Radio has been built.
+
+    bool m_bFarm = false; ///< Can farm.
+    bool m_bEat = false; ///< Can eat.
+    bool m_bBuild = false; ///< Can build the radio.
+    bool m_bLeave = false; ///< Can leave.
+
+    const bool operator==(const CHudDesc&) const; ///< Equality test.
+}; //CHudDesc
+
+/// \brief The heads-up display.
+///
+/// The HUD sprites are retained between frames. Their positions are kept
+/// relative to the camera, and they are only rebuilt when the HUD descriptor
+/// changes. When the camera moves the cached sprites are shifted by the
+/// amount that it moved, so most frames just submit the cached sprites.
+
+class CHud:
+  public CCommon
+{
+  private:
+    CHudDesc m_cDesc; ///< Descriptor the sprites were built from.
+    bool m_bValid = false; ///< Whether the sprites have been built.
+    std::vector<LSpriteDesc2D> m_vecSprites; ///< Cached sprites in world space.
+    Vector2 m_vCameraPos; ///< Camera position the sprites were placed for.
+    size_t m_nRebuilds = 0; ///< Number of times the sprites were rebuilt.
+
+    void Rebuild(const Vector2&); ///< Rebuild the sprites.
+    LSpriteDesc2D& Add(eSprite, const Vector2&); ///< Add a sprite.
+
+  public:
+    CHud(); ///< Constructor.
+
+    void Draw(const CHudDesc&); ///< Draw the HUD.
+    void Invalidate(); ///< Force a rebuild on next draw.
+
+    const size_t GetNumRebuilds() const; ///< Get number of rebuilds.
+}; //CHud
+
+#endif //__L4RC_GAME_HUD_H__
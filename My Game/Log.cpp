@@ -0,0 +1,231 @@
+/// \file Log.cpp
+/// \brief Code for the log CLog.
+
+#include "Log.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+CLog::CRecord CLog::m_cQueue[CLog::QUEUE_SIZE];
+std::atomic<size_t> CLog::m_nHead{0};
+size_t CLog::m_nTail = 0;
+std::atomic<size_t> CLog::m_nDropped{0};
+
+std::thread CLog::m_cThread;
+std::atomic<bool> CLog::m_bRunning{false};
+FILE* CLog::m_pFile = nullptr;
+
+/// Get the steady clock time.
+/// \return Time in milliseconds.
+
+static int64_t GetLogTime(){
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+} //GetLogTime
+
+static const int64_t g_nLogStart = GetLogTime(); ///< Time that times are logged from.
+
+/// Get the name of a log level.
+/// \param level Log level.
+/// \return Name.
+
+static const char* GetLevelName(eLogLevel level){
+  switch(level){
+    case eLogLevel::Debug:   return "debug";
+    case eLogLevel::Info:    return "info";
+    case eLogLevel::Warning: return "warning";
+    default:                 return "error";
+  } //switch
+} //GetLevelName
+
+/// Log a message, unless its call site has already logged too many this
+/// second. This never blocks and never allocates. It can be called from any
+/// thread, and before `Start()`, in which case the message waits in the
+/// queue. The queue is the bounded multi-producer queue in which each slot's
+/// sequence number says whether it is ready to be pushed to or popped from.
+/// The sequence numbers are stored minus the slot index, so that a queue
+/// that is all zeros is empty and ready, and no constructor has to run first.
+/// \param site Call site.
+/// \param level Log level.
+/// \param format Format string like `printf()`.
+
+void CLog::Write(CLogSite& site, eLogLevel level, const char* format, ...){
+  const int64_t now = GetLogTime(); //current time
+  const uint32_t second = (uint32_t)(now/1000); //current second
+
+  //count against the call site, starting a new count each second
+
+  if(site.m_nSecond.load(std::memory_order_relaxed) != second){
+    site.m_nSecond.store(second, std::memory_order_relaxed);
+    site.m_nCount.store(0, std::memory_order_relaxed);
+  } //if
+
+  if(site.m_nCount.fetch_add(1, std::memory_order_relaxed) >= SITE_LIMIT){
+    site.m_nSuppressed.fetch_add(1, std::memory_order_relaxed);
+    return; //too many this second
+  } //if
+
+  //claim a slot
+
+  const size_t mask = QUEUE_SIZE - 1; //slot index mask
+  size_t pos = m_nHead.load(std::memory_order_relaxed); //slot to claim
+  CRecord* r = nullptr; //claimed slot
+
+  for(;;){
+    CRecord& slot = m_cQueue[pos & mask]; //candidate slot
+    const size_t seq = slot.m_nSeq.load(std::memory_order_acquire) + (pos & mask); //its sequence number
+    const intptr_t d = (intptr_t)seq - (intptr_t)pos; //0 if free, negative if full
+
+    if(d == 0){
+      if(m_nHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+        r = &slot;
+        break;
+      } //if
+    } //if
+
+    else if(d < 0){ //queue full, so drop the message rather than wait
+      m_nDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } //else if
+
+    else pos = m_nHead.load(std::memory_order_relaxed); //another thread got it
+  } //for
+
+  //fill it in and hand it to the writer
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(r->m_chText, TEXT_SIZE, format, args);
+  va_end(args);
+
+  r->m_eLevel = level;
+  r->m_nTime = now;
+  r->m_nSuppressed = site.m_nSuppressed.exchange(0, std::memory_order_relaxed);
+  r->m_nSeq.store(pos + 1 - (pos & mask), std::memory_order_release);
+} //Write
+
+/// Pop the oldest message off the queue. Only the writer thread calls this.
+/// \param r [out] Message.
+/// \return true if there was one.
+
+const bool CLog::Pop(CRecord& r){
+  const size_t mask = QUEUE_SIZE - 1; //slot index mask
+  CRecord& slot = m_cQueue[m_nTail & mask]; //oldest slot
+
+  if(slot.m_nSeq.load(std::memory_order_acquire) + (m_nTail & mask) != m_nTail + 1)
+    return false; //empty
+
+  r.m_eLevel = slot.m_eLevel;
+  r.m_nSuppressed = slot.m_nSuppressed;
+  r.m_nTime = slot.m_nTime;
+  memcpy(r.m_chText, slot.m_chText, TEXT_SIZE);
+
+  slot.m_nSeq.store(m_nTail + QUEUE_SIZE - (m_nTail & mask), std::memory_order_release);
+  m_nTail++;
+  return true;
+} //Pop
+
+/// Writer thread. Write the messages to the console and the log file as they
+/// arrive, holding back identical messages in a row and writing how many
+/// there were when a different one arrives or a second goes by. It finishes
+/// writing what is queued when asked to stop.
+
+void CLog::Run(){
+  CRecord r; //current message
+  char last[TEXT_SIZE] = {0}; //previous message text
+  eLogLevel eLastLevel = eLogLevel::Size; //previous message level
+  uint32_t repeats = 0; //repeats of the previous message held back
+  int64_t tRepeat = 0; //time of first repeat held back
+
+  auto Output = [](const char* s){ //write a line
+    std::cout << s << '\n';
+
+    if(m_pFile){
+      fputs(s, m_pFile);
+      fputc('\n', m_pFile);
+    } //if
+  }; //Output
+
+  auto FlushRepeats = [&](){ //write the number of repeats held back
+    if(repeats == 0)return;
+    char s[64]; //line
+    snprintf(s, sizeof(s), "  (last message repeated %u times)", repeats);
+    Output(s);
+    repeats = 0;
+  }; //FlushRepeats
+
+  for(;;){
+    const bool bRunning = m_bRunning.load(std::memory_order_acquire); //check before popping
+    bool bWrote = false; //whether anything was written
+
+    while(Pop(r)){
+      if(r.m_eLevel == eLastLevel && r.m_nSuppressed == 0 && !strcmp(r.m_chText, last)){
+        if(repeats++ == 0)tRepeat = r.m_nTime;
+        continue; //same as the last one
+      } //if
+
+      FlushRepeats();
+
+      char s[TEXT_SIZE + 96]; //line
+
+      const int n = snprintf(s, sizeof(s), "[%9.3f] %s: %s", (r.m_nTime - g_nLogStart)/1000.0f,
+        GetLevelName(r.m_eLevel), r.m_chText);
+
+      if(r.m_nSuppressed > 0 && n > 0 && (size_t)n < sizeof(s))
+        snprintf(s + n, sizeof(s) - n, " (%u similar messages suppressed)", r.m_nSuppressed);
+
+      Output(s);
+      bWrote = true;
+
+      memcpy(last, r.m_chText, TEXT_SIZE);
+      eLastLevel = r.m_eLevel;
+    } //while
+
+    if(repeats > 0 && (!bRunning || GetLogTime() - tRepeat > 1000))
+      FlushRepeats(); //don't hold repeats back for long
+
+    const size_t dropped = m_nDropped.exchange(0, std::memory_order_relaxed); //dropped when full
+
+    if(dropped > 0){
+      char s[64]; //line
+      snprintf(s, sizeof(s), "  (%zu messages dropped, log queue full)", dropped);
+      Output(s);
+      bWrote = true;
+    } //if
+
+    if(bWrote && m_pFile)fflush(m_pFile);
+    if(!bRunning)break; //everything pushed before stopping has been written
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  } //for
+} //Run
+
+/// Start the writer thread, if it isn't already running, and stop it at
+/// exit, even if that's by way of `exit()`.
+/// \param filename Name of the log file, or `nullptr` for the console only.
+
+void CLog::Start(const char* filename){
+  if(m_bRunning.exchange(true))return; //already running
+
+  if(filename)
+    fopen_s(&m_pFile, filename, "wt");
+
+  m_cThread = std::thread(Run);
+  std::atexit(Stop);
+} //Start
+
+/// Stop the writer thread after it has written everything queued so far,
+/// and close the log file. It is safe to call this more than once.
+
+void CLog::Stop(){
+  if(!m_bRunning.exchange(false))return; //not running
+  if(m_cThread.joinable())m_cThread.join();
+
+  if(m_pFile){
+    fclose(m_pFile);
+    m_pFile = nullptr;
+  } //if
+} //Stop
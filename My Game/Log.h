@@ -0,0 +1,117 @@
+/// \file Log.h
+/// \brief Interface for the log CLog and the logging macros.
+
+#ifndef __L4RC_GAME_LOG_H__
+#define __L4RC_GAME_LOG_H__
+
+#include "GameDefines.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+/// Lowest level of message compiled in: 0 debug, 1 info, 2 warning, 3 error.
+/// Define it before this is included, or in the project settings, to change it.
+
+#ifndef LOG_LEVEL
+  #ifdef _DEBUG
+    #define LOG_LEVEL 0
+  #else
+    #define LOG_LEVEL 2
+  #endif //_DEBUG
+#endif //LOG_LEVEL
+
+/// \brief A place in the code that logs messages.
+///
+/// Each logging macro has one of these, so that a call site that fires too
+/// often, such as one inside a per-frame loop, can be throttled without
+/// affecting any other. It is all atomics, so it is constant-initialized and
+/// can be shared by any number of threads without locking.
+
+struct CLogSite{
+  std::atomic<uint32_t> m_nSecond{0}; ///< Second being counted.
+  std::atomic<uint32_t> m_nCount{0}; ///< Messages so far in that second.
+  std::atomic<uint32_t> m_nSuppressed{0}; ///< Messages dropped since one got through.
+}; //CLogSite
+
+/// \brief The log.
+///
+/// Logging a message formats it into a fixed-size record on the calling
+/// thread and pushes it onto a bounded lock-free queue, so that a thread
+/// that logs, such as the render loop or a co-op session, never waits for
+/// the console or a file. A background thread pops the records and writes
+/// them to the console and to a log file. Each call site can log only a few
+/// messages per second, and the number that it dropped is added to the next
+/// one that gets through. The writer collapses identical messages in a row
+/// into a count. If the queue is full then the message is dropped and
+/// counted rather than blocking. Messages below `LOG_LEVEL` are compiled out.
+
+class CLog{
+  private:
+    static const size_t QUEUE_SIZE = 256; ///< Queue slots, a power of 2.
+    static const size_t TEXT_SIZE = 200; ///< Longest message, including the null.
+    static const uint32_t SITE_LIMIT = 5; ///< Messages per second per call site.
+
+    /// \brief A queued message.
+
+    struct CRecord{
+      std::atomic<size_t> m_nSeq{0}; ///< Sequence number, relative to slot index.
+      eLogLevel m_eLevel = eLogLevel::Info; ///< Level.
+      uint32_t m_nSuppressed = 0; ///< Messages dropped at the call site before this one.
+      int64_t m_nTime = 0; ///< Steady clock time in milliseconds.
+      char m_chText[TEXT_SIZE] = {0}; ///< Message text.
+    }; //CRecord
+
+    static CRecord m_cQueue[QUEUE_SIZE]; ///< Message queue, a ring.
+    static std::atomic<size_t> m_nHead; ///< Next slot to push to.
+    static size_t m_nTail; ///< Next slot to pop from, writer thread only.
+    static std::atomic<size_t> m_nDropped; ///< Messages dropped because the queue was full.
+
+    static std::thread m_cThread; ///< Writer thread.
+    static std::atomic<bool> m_bRunning; ///< Writer thread is running.
+    static FILE* m_pFile; ///< Log file, or `nullptr` for the console only.
+
+    static const bool Pop(CRecord&); ///< Pop a message.
+    static void Run(); ///< Writer thread.
+
+  public:
+    static void Start(const char*); ///< Start the writer thread.
+    static void Stop(); ///< Write what is queued and stop.
+
+    static void Write(CLogSite&, eLogLevel, const char*, ...); ///< Log a message.
+}; //CLog
+
+/// Log a message from a call site of its own, given a level and a format
+/// string with arguments like `printf()`.
+
+#define LOG_AT(level, ...) do{ \
+  static CLogSite site; \
+  CLog::Write(site, level, __VA_ARGS__); \
+}while(0)
+
+#if LOG_LEVEL <= 0
+  #define LOG_DEBUG(...) LOG_AT(eLogLevel::Debug, __VA_ARGS__)
+#else
+  #define LOG_DEBUG(...) ((void)0)
+#endif //LOG_LEVEL
+
+#if LOG_LEVEL <= 1
+  #define LOG_INFO(...) LOG_AT(eLogLevel::Info, __VA_ARGS__)
+#else
+  #define LOG_INFO(...) ((void)0)
+#endif //LOG_LEVEL
+
+#if LOG_LEVEL <= 2
+  #define LOG_WARNING(...) LOG_AT(eLogLevel::Warning, __VA_ARGS__)
+#else
+  #define LOG_WARNING(...) ((void)0)
+#endif //LOG_LEVEL
+
+#if LOG_LEVEL <= 3
+  #define LOG_ERROR(...) LOG_AT(eLogLevel::Error, __VA_ARGS__)
+#else
+  #define LOG_ERROR(...) ((void)0)
+#endif //LOG_LEVEL
+
+#endif //__L4RC_GAME_LOG_H__
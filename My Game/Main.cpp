@@ -2,6 +2,7 @@
 /// \brief Every program has to have a main.
 
 #include "Game.h"
+#include "Headless.h"
 #include "Window.h"
 
 //#define USE_DEBUG_CONSOLE ///< Define to use a console window for debug messages.
@@ -15,7 +16,9 @@ static CGame g_cGame; ///< The game class.
 
 /// \brief The main entry point for this application.  
 ///
-/// The main entry point for this application. 
+/// The main entry point for this application. If the command line asks for
+/// something that needs no window, such as serving co-op sessions, then that
+/// is done without creating the window or the renderer.
 /// \param hInstance Handle to the current instance of this application.
 /// \param hPrevInstance Unused.
 /// \param lpCmdLine Unused.
@@ -28,6 +31,9 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
   UNREFERENCED_PARAMETER(hPrevInstance);
   UNREFERENCED_PARAMETER(lpCmdLine);
   UNREFERENCED_PARAMETER(nCmdShow);
+
+  if(CHeadless::IsRequested())
+    return CHeadless().Run();
   
   #ifdef USE_DEBUG_CONSOLE
     const bool console = true;
@@ -0,0 +1,168 @@
+/// \file Net.cpp
+/// \brief Code for the UDP socket CUdpSocket.
+
+#include <winsock2.h> //must be before windows.h
+#include <ws2tcpip.h>
+
+#include "Net.h"
+
+/// Equality test.
+/// \param a Another address.
+/// \return true if the addresses are the same.
+
+const bool CNetAddress::operator==(const CNetAddress& a) const{
+  return m_nIP == a.m_nIP && m_nPort == a.m_nPort;
+} //operator==
+
+/// Destructor.
+
+CUdpSocket::~CUdpSocket(){
+  Close();
+} //destructor
+
+/// Open a non-blocking UDP socket. Winsock counts the calls to `WSAStartup()`
+/// and `WSACleanup()`, so each socket starts it and stops it.
+/// \param port Port to receive on, or 0 for any free port.
+/// \return true if the socket was opened.
+
+const bool CUdpSocket::Open(uint16_t port){
+  Close();
+
+  WSADATA wsa;
+  if(WSAStartup(MAKEWORD(2, 2), &wsa) != 0)return false;
+
+  SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP); //socket handle
+
+  if(s == INVALID_SOCKET){
+    WSACleanup();
+    return false;
+  } //if
+
+  sockaddr_in addr = {}; //local address
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  u_long nonblocking = 1; //ioctl argument
+  int size = 1 << 20; //socket buffer size, enough for a burst of snapshots
+
+  if(bind(s, (const sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+    ioctlsocket(s, FIONBIO, &nonblocking) == SOCKET_ERROR)
+  {
+    closesocket(s);
+    WSACleanup();
+    return false;
+  } //if
+
+  setsockopt(s, SOL_SOCKET, SO_RCVBUF, (const char*)&size, sizeof(size));
+  setsockopt(s, SOL_SOCKET, SO_SNDBUF, (const char*)&size, sizeof(size));
+
+  m_hSocket = (uintptr_t)s;
+  return true;
+} //Open
+
+/// Close the socket, if it is open.
+
+void CUdpSocket::Close(){
+  if(!IsOpen())return;
+
+  closesocket((SOCKET)m_hSocket);
+  WSACleanup();
+  m_hSocket = ~(uintptr_t)0;
+} //Close
+
+/// Reader function for whether the socket is open.
+/// \return true if the socket is open.
+
+const bool CUdpSocket::IsOpen() const{
+  return m_hSocket != ~(uintptr_t)0;
+} //IsOpen
+
+/// Send a packet. UDP gives no guarantee that it arrives.
+/// \param to Address to send to.
+/// \param p Pointer to packet.
+/// \param n Size of packet in bytes.
+/// \return true if the packet was sent.
+
+const bool CUdpSocket::SendTo(const CNetAddress& to, const void* p, size_t n){
+  if(!IsOpen() || n > NET_MAX_PACKET)return false;
+
+  sockaddr_in addr = {}; //remote address
+  addr.sin_family = AF_INET;
+  addr.sin_port = to.m_nPort;
+  addr.sin_addr.s_addr = to.m_nIP;
+
+  return sendto((SOCKET)m_hSocket, (const char*)p, (int)n, 0,
+    (const sockaddr*)&addr, sizeof(addr)) == (int)n;
+} //SendTo
+
+/// Receive a packet, if there is one waiting. A reset from an address that
+/// we sent to and that has gone away is reported by Winsock as an error on
+/// the next receive, and is skipped.
+/// \param from [out] Address the packet came from.
+/// \param p Pointer to buffer.
+/// \param n Size of buffer in bytes.
+/// \return Size of packet in bytes, or -1 if there isn't one.
+
+const int CUdpSocket::RecvFrom(CNetAddress& from, void* p, size_t n){
+  if(!IsOpen())return -1;
+
+  for(;;){
+    sockaddr_in addr = {}; //remote address
+    int len = sizeof(addr); //size of remote address
+
+    const int result = recvfrom((SOCKET)m_hSocket, (char*)p, (int)n, 0,
+      (sockaddr*)&addr, &len);
+
+    if(result >= 0){
+      from.m_nIP = addr.sin_addr.s_addr;
+      from.m_nPort = addr.sin_port;
+      return result;
+    } //if
+
+    if(WSAGetLastError() != WSAECONNRESET)
+      return -1;
+  } //for
+} //RecvFrom
+
+/// Wait until there is a packet to receive or a time limit passes.
+/// \param ms Time limit in milliseconds.
+/// \return true if there is a packet waiting.
+
+const bool CUdpSocket::Wait(UINT ms){
+  if(!IsOpen())return false;
+
+  fd_set set; //sockets to wait on
+  FD_ZERO(&set);
+  FD_SET((SOCKET)m_hSocket, &set);
+
+  timeval tv; //time limit
+  tv.tv_sec = ms/1000;
+  tv.tv_usec = (ms%1000)*1000;
+
+  return select(0, &set, nullptr, nullptr, &tv) > 0;
+} //Wait
+
+/// Look up the address of a host. Winsock must be started, which it is
+/// while any socket is open.
+/// \param host Host name or dotted IP address.
+/// \param port Port.
+/// \param a [out] Address.
+/// \return true if the host was found.
+
+const bool CUdpSocket::Resolve(const char* host, uint16_t port, CNetAddress& a){
+  addrinfo hints = {}; //what to look for
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_protocol = IPPROTO_UDP;
+
+  addrinfo* result = nullptr; //what was found
+  if(getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr)
+    return false;
+
+  a.m_nIP = ((const sockaddr_in*)result->ai_addr)->sin_addr.s_addr;
+  a.m_nPort = htons(port);
+  freeaddrinfo(result);
+
+  return true;
+} //Resolve
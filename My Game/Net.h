@@ -0,0 +1,101 @@
+/// \file Net.h
+/// \brief Interface for the UDP socket CUdpSocket, and the network packets.
+
+#ifndef __L4RC_GAME_NET_H__
+#define __L4RC_GAME_NET_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Defines.h"
+#include "SnapshotCodec.h"
+
+/// \brief Network address.
+///
+/// An IPv4 address and port, both in network byte order.
+
+struct CNetAddress{
+  uint32_t m_nIP = 0; ///< IP address.
+  uint16_t m_nPort = 0; ///< Port.
+
+  const bool operator==(const CNetAddress&) const; ///< Equality test.
+}; //CNetAddress
+
+/// \brief UDP socket.
+///
+/// A thin wrapper over a non-blocking Winsock UDP socket. Winsock is started
+/// by the first socket to be opened and stopped by the last to be closed.
+
+class CUdpSocket{
+  private:
+    uintptr_t m_hSocket = ~(uintptr_t)0; ///< Socket handle.
+
+  public:
+    ~CUdpSocket(); ///< Destructor.
+
+    const bool Open(uint16_t); ///< Open socket on a port.
+    void Close(); ///< Close socket.
+    const bool IsOpen() const; ///< Whether socket is open.
+
+    const bool SendTo(const CNetAddress&, const void*, size_t); ///< Send a packet.
+    const int RecvFrom(CNetAddress&, void*, size_t); ///< Receive a packet.
+    const bool Wait(UINT); ///< Wait for a packet.
+
+    static const bool Resolve(const char*, uint16_t, CNetAddress&); ///< Look up address.
+}; //CUdpSocket
+
+/// \brief Network packet type.
+
+enum class eNetPacket: UINT{
+  Input, Snapshot
+}; //eNetPacket
+
+/// \brief Client input packet.
+///
+/// Sent by a client every frame. The first input that the server receives
+/// from an address joins that client to the session, creating the session
+/// if it doesn't exist yet.
+
+struct CNetInput{
+  char m_chMagic[4]; ///< Packet signature.
+  eNetPacket m_eType; ///< Packet type, which is `eNetPacket::Input`.
+  UINT m_nSession; ///< Session to play in.
+  UINT m_nSequence; ///< Input number, counting up from 1.
+  UINT m_nSnapshot; ///< Tick of newest snapshot received, or 0 if none.
+  UINT m_nButtons; ///< Buttons held down, a combination of the `NET_*` flags.
+  float m_fRotation; ///< Player orientation in degrees.
+  UINT m_nViewWidth; ///< Client window width in pixels.
+  UINT m_nViewHeight; ///< Client window height in pixels.
+}; //CNetInput
+
+/// \brief Server snapshot packet header.
+///
+/// Sent by the server to each client every tick, followed by the objects
+/// near the client's view chosen by `CSnapshotFilter` and encoded by
+/// `CSnapshotCodec` against the snapshot for tick `m_nBaseline`, which is the
+/// newest one that the client said it had received.
+
+struct CNetSnapshot{
+  char m_chMagic[4]; ///< Packet signature.
+  eNetPacket m_eType; ///< Packet type, which is `eNetPacket::Snapshot`.
+  UINT m_nSession; ///< Session.
+  UINT m_nTick; ///< Server tick, counting up from 1.
+  UINT m_nBaseline; ///< Tick of baseline snapshot, or 0 if none.
+  UINT m_nAck; ///< Latest input sequence number received from this client.
+  UINT m_nPlayer; ///< Network identifier of this client's player, or 0 if dead.
+}; //CNetSnapshot
+
+static const char NET_MAGIC[4] = {'L', '4', 'N', 'T'}; ///< Packet signature.
+static const uint16_t NET_PORT = 27015; ///< Default server port.
+static const size_t NET_MAX_PACKET = 65507; ///< Largest UDP payload.
+static const size_t NET_HISTORY = 32; ///< Number of snapshots kept for baselines.
+static const UINT NET_MAX_VIEW = 4096; ///< Largest client window width or height.
+
+static const UINT NET_FORWARD = 1; ///< Move forward button.
+static const UINT NET_BACK = 2; ///< Move back button.
+static const UINT NET_LEFT = 4; ///< Strafe left button.
+static const UINT NET_RIGHT = 8; ///< Strafe right button.
+static const UINT NET_WALK = 16; ///< Walk button.
+static const UINT NET_FIRE = 32; ///< Fire button.
+
+#endif //__L4RC_GAME_NET_H__
@@ -7,26 +7,28 @@
 #include "Particle.h"
 #include "ParticleEngine.h"
 #include "Helpers.h"
+#include "ObjectManager.h"
+#include "DrawList.h"
+#include "World.h"
 
 /// Create and initialize an object given its sprite type and initial position.
+/// The bounding circle is taken from the sprite size table rather than the
+/// renderer, so that objects can be created in a world that isn't drawn.
+/// \param pWorld Pointer to the world the object is part of.
 /// \param t Type of sprite.
 /// \param p Initial position of object.
 
-CObject::CObject(eSprite t, const Vector2& p):
-  LBaseObject(t, p)
+CObject::CObject(CWorld* pWorld, eSprite t, const Vector2& p):
+  CCommon(pWorld), LBaseObject(t, p)
 { 
   m_fRoll = XM_PIDIV2; //facing upwards
   m_bIsTarget = false; //not a target
 
-  const float w = m_pRenderer->GetWidth(t); //sprite width
-  const float h = m_pRenderer->GetHeight(t); //sprite height
-  m_fRadius = std::max(w, h)/2; //bounding circle radius
+  const Vector2 size = GetSpriteSize(t); //sprite width and height
+  m_fRadius = std::max(size.x, size.y)/2; //bounding circle radius
 
   if (t == eSprite::Battery || t == eSprite::LogicBoard || t == eSprite::Antenna)
       m_bIsRadio = true;
-
-
-  m_pGunFireEvent = new LEventTimer(1.0f); //timer for firing gun
 } //constructor
 
 eSprite CObject::getSpriteType() {
@@ -37,28 +39,31 @@ void CObject::setSpriteType(eSprite es) {
     spriteType = es;
 }
 
-/// Destructor.
+/// Destructor. The object removes itself from the object manager's per-type
+/// list here because the object list culls and deletes dead objects itself.
 
 CObject::~CObject(){
-  delete m_pGunFireEvent;
+  if(m_pWorld->m_pObjectManager){
+    m_pWorld->m_pObjectManager->Unlink(this); //remove from per-type list
+    m_pWorld->m_pObjectManager->Forget(this); //remove from level snapshot
+  } //if
 } //destructor
 
 /// Move object an amount that depends on its velocity and the frame time.
 
 void CObject::move(){
   if(!m_bDead && !m_bStatic)
-    m_vPos += m_vVelocity*m_pTimer->GetFrameTime();
+    m_vPos += m_vVelocity*m_pWorld->m_fFrameTime;
 } //move
 
 /// Ask the renderer to draw the sprite described in the sprite descriptor.
 /// Note that `CObject` is derived from `LBaseObject` which is inherited from
-/// `LSpriteDesc2D`. Therefore `LSpriteRenderer::Draw(const LSpriteDesc2D*)`
-/// will accept `this` as a parameter, automatically down-casting it from
-/// `CObject*` to `LSpriteDesc2D*`, effectively drawing the object from its
-/// sprite descriptor.
+/// `LSpriteDesc2D`. Therefore `CDrawList::Add(eDrawLayer, const LSpriteDesc2D&)`
+/// will accept `*this` as a parameter, copying the object's sprite descriptor
+/// into the draw list to be drawn when the draw list is flushed.
 
 void CObject::draw(){ 
-  m_pRenderer->Draw(this);
+  m_pDrawList->Add(eDrawLayer::Object, *this);
 } //draw
 
 /// Response to collision. Move back the overlap distance along the collision
@@ -98,6 +103,14 @@ void CObject::DeathFX(){
  //stub
 } //DeathFX
 
+/// Response to being hit by a bullet. This function is a stub intended to be
+/// overridden by object classes that can be damaged.
+/// \param norm Collision normal.
+
+void CObject::TakeHit(const Vector2& norm){
+ //stub
+} //TakeHit
+
 /// Compute the view vector from the object orientation.
 /// \return The view vector
 
@@ -122,4 +135,12 @@ const bool CObject::isActivity() const {
 
 const bool CObject::isRadio() const {
     return m_bIsRadio;
-} //isActivity
\ No newline at end of file
+} //isActivity
+
+/// Reader function for the network identifier, which is unique among the
+/// objects created by the object manager.
+/// \return Network identifier.
+
+const UINT CObject::GetNetId() const{
+  return m_nNetId;
+} //GetNetId
\ No newline at end of file
@@ -10,7 +10,6 @@
 #include "Component.h"
 #include "SpriteDesc.h"
 #include "BaseObject.h"
-#include "EventTimer.h"
 
 /// \brief The game object. 
 ///
@@ -25,6 +24,8 @@ class CObject:
   public LBaseObject
 {
   friend class CObjectManager; ///< Object manager needs access so it can manage.
+  friend class CBulletManager; ///< Bullet manager needs access to hit objects.
+  friend class CSpatialGrid; ///< Spatial grid needs access to object bounds.
 
   protected:
     float m_fRadius = 0; ///< Bounding circle radius.
@@ -43,18 +44,24 @@ class CObject:
     eSprite spriteType = eSprite::Background;
     bool m_bIsShop = false;
 
-    LEventTimer* m_pGunFireEvent = nullptr; ///< Gun fire event.
+    eObjectType m_eObjectType = eObjectType::Other; ///< Per-type list this object is in.
+    CObject* m_pPrevOfType = nullptr; ///< Previous object in per-type list.
+    CObject* m_pNextOfType = nullptr; ///< Next object in per-type list.
+    int m_nSnapshot = -1; ///< Index in level snapshot, or -1 if not in it.
+    eSprite m_eCreateSprite = eSprite::Size; ///< Sprite type object was created with.
+    UINT m_nNetId = 0; ///< Network identifier.
     
     virtual void CollisionResponse(const Vector2&, float,
       CObject* = nullptr); ///< Collision response.
     virtual void ActiveCollisionResponse(const Vector2&, float,
         CObject* = nullptr); ///< Collision response.
     virtual void DeathFX(); ///< Death special effects.
+    virtual void TakeHit(const Vector2&); ///< Response to being shot.
 
     const Vector2 GetViewVector() const; ///< Compute view vector.
 
   public:
-    CObject(eSprite, const Vector2&); ///< Constructor.
+    CObject(CWorld*, eSprite, const Vector2&); ///< Constructor.
     virtual ~CObject(); ///< Destructor.
 
     void move(); ///< Move object.
@@ -64,6 +71,7 @@ class CObject:
     const bool isTurret() const; ///< Is a turret.
     const bool isActivity() const;
     const bool isRadio() const;
+    const UINT GetNetId() const; ///< Get network identifier.
 
     eSprite getSpriteType();
     void setSpriteType(eSprite es);
@@ -6,59 +6,574 @@
 
 #include "Player.h"
 #include "Turret.h"
-#include "Bullet.h"
+#include "BulletManager.h"
 #include "Zombie.h"
 #include "ParticleEngine.h"
 #include "Helpers.h"
 #include "GameDefines.h"
 #include "TileManager.h"
+#include "DrawList.h"
 #include "Activity.h"
+#include "PositionHistory.h"
+#include "AllocTracker.h"
+#include "World.h"
+
+#include <algorithm>
+
+/// Constructor.
+/// \param pWorld Pointer to the world the object manager is part of.
+
+CObjectManager::CObjectManager(CWorld* pWorld): CCommon(pWorld){
+} //constructor
+
+/// Destructor. Delete the objects while the per-type lists still exist,
+/// since each object unlinks itself from them when it is deleted.
+
+CObjectManager::~CObjectManager(){
+  clear();
+} //destructor
 
 /// Create an object and put a pointer to it at the back of the object list
-/// `m_stdObjectList`, which it inherits from `LBaseObjectManager`.
+/// `m_stdObjectList`, which it inherits from `LBaseObjectManager`, and at the
+/// front of the per-type list for its object type.
 /// \param t Sprite type.
 /// \param pos Initial position.
 /// \return Pointer to the object created.
 
 CObject* CObjectManager::create(eSprite t, const Vector2& pos){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
   CObject* pObj = nullptr;
 
   switch(t){ //create object of type t
-    case eSprite::Player:  pObj = new CPlayer(pos); break;
-    case eSprite::Turret:  pObj = new CTurret(pos); break;
-    case eSprite::Zombie2:  pObj = new CZombie(pos); break;
-    case eSprite::Bullet:  pObj = new CBullet(eSprite::Bullet,  pos); break;
-    case eSprite::Bullet2: pObj = new CBullet(eSprite::Bullet2, pos); break;
-    case eSprite::Activity:pObj = new CActivity(eSprite::Activity, pos); break;
-    case eSprite::Battery: pObj = new CObject(eSprite::Battery, pos); pObj->setSpriteType(eSprite::Battery); break;
-    case eSprite::Antenna: pObj = new CObject(eSprite::Antenna, pos); pObj->setSpriteType(eSprite::Antenna); break;
-    case eSprite::LogicBoard: pObj = new CObject(eSprite::LogicBoard, pos); pObj->setSpriteType(eSprite::LogicBoard); break;
-    //case eSprite::Radio1: pObj = new CObject(eSprite::Radio1, pos); pObj->setSpriteType(eSprite::Radio1); break;
-    default: pObj = new CObject(t, pos);
+    case eSprite::Player:  pObj = new CPlayer(m_pWorld, pos); break;
+    case eSprite::Turret:  pObj = new CTurret(m_pWorld, pos); break;
+    case eSprite::Zombie2:  pObj = new CZombie(m_pWorld, pos); break;
+    case eSprite::Activity:pObj = new CActivity(m_pWorld, eSprite::Activity, pos); break;
+    case eSprite::Battery: pObj = new CObject(m_pWorld, eSprite::Battery, pos); pObj->setSpriteType(eSprite::Battery); break;
+    case eSprite::Antenna: pObj = new CObject(m_pWorld, eSprite::Antenna, pos); pObj->setSpriteType(eSprite::Antenna); break;
+    case eSprite::LogicBoard: pObj = new CObject(m_pWorld, eSprite::LogicBoard, pos); pObj->setSpriteType(eSprite::LogicBoard); break;
+    //case eSprite::Radio1: pObj = new CObject(m_pWorld, eSprite::Radio1, pos); pObj->setSpriteType(eSprite::Radio1); break;
+    default: pObj = new CObject(m_pWorld, t, pos);
   } //switch
   
   m_stdObjectList.push_back(pObj); //push pointer onto object list
+  pObj->m_eCreateSprite = t;
+  pObj->m_nNetId = ++m_nLastNetId;
+  pObj->m_eObjectType = GetObjectType(t, pObj);
+  Link(pObj); //push pointer onto per-type list
+  m_bGridDirty = true; //grid doesn't have this object yet
   return pObj; //return pointer to created object
 } //create
 
-void CObjectManager::clearRadios() {
-    for (CObject* pObj : m_stdObjectList) //for each object
-        if (pObj->m_bIsRadio) { //if the object is an elixir
-            pObj->m_bDead = true;
-        }
-}
+/// Delete all objects, emptying the spatial grid first so that it doesn't
+/// hold dangling pointers. The level snapshot goes too.
 
-/// Draw the tiled background and the objects in the object list.
+void CObjectManager::clear(){
+  DiscardSnapshot();
+  m_cGrid.clear();
+  m_bGridDirty = true;
+  LBaseObjectManager::clear();
+} //clear
 
-void CObjectManager::draw(){
-  m_pTileManager->Draw(eSprite::Tile); //draw tiled background
+/// Take a snapshot of all of the objects, which should be done just after
+/// the objects for a level have been created.
+
+void CObjectManager::Snapshot(){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
+  DiscardSnapshot();
+  m_vecSnapshot.reserve(m_stdObjectList.size());
+
+  for(CObject* p: m_stdObjectList){
+    CObjectBlueprint b; //blueprint for this object
+
+    b.m_eSprite = p->m_eCreateSprite;
+    b.m_cDesc = *p;
+    b.m_vVelocity = p->m_vVelocity;
+    b.m_fSpeed = p->m_fSpeed;
+    b.m_fRotSpeed = p->m_fRotSpeed;
+    b.m_bStatic = p->m_bStatic;
+    b.m_pObj = p;
+
+    p->m_nSnapshot = (int)m_vecSnapshot.size();
+    m_vecSnapshot.push_back(b);
+  } //for
+} //Snapshot
+
+/// Put the objects back the way they were when the snapshot was taken.
+/// Objects created since then are deleted. Static objects such as the trees
+/// and buildings have no state other than their sprite and motion, so if
+/// they still exist they are reset in place. The others, such as the player,
+/// have state of their own, so they are deleted and created again, as are
+/// any static objects that were deleted since the snapshot. Typically that is
+/// a handful of objects out of a couple of hundred.
+
+void CObjectManager::RestoreSnapshot(){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
+  DeleteDynamic();
+
+  //create the missing objects and reset them all
+
+  for(UINT i=0; i<m_vecSnapshot.size(); i++){
+    CObjectBlueprint& b = m_vecSnapshot[i]; //shorthand
+
+    if(b.m_pObj == nullptr){ //deleted, so create it again
+      b.m_pObj = create(b.m_eSprite, b.m_cDesc.m_vPos);
+      b.m_pObj->m_nSnapshot = (int)i;
+    } //if
+
+    CObject* p = b.m_pObj; //shorthand
+
+    (LSpriteDesc2D&)*p = b.m_cDesc;
+    p->m_vVelocity = b.m_vVelocity;
+    p->m_fSpeed = b.m_fSpeed;
+    p->m_fRotSpeed = b.m_fRotSpeed;
+    p->m_bDead = false;
+  } //for
+} //RestoreSnapshot
+
+/// Delete the objects that can't be reset in place from the level snapshot,
+/// which are those that aren't static or aren't in the snapshot at all.
+
+void CObjectManager::DeleteDynamic(){
+  m_cGrid.clear();
+  m_bGridDirty = true;
+
+  for(auto i=m_stdObjectList.begin(); i!=m_stdObjectList.end();){
+    CObject* p = *i; //shorthand
+
+    if(p->m_nSnapshot < 0 || !m_vecSnapshot[p->m_nSnapshot].m_bStatic){
+      delete p; //this takes it out of the snapshot too
+      i = m_stdObjectList.erase(i);
+    } //if
+
+    else i++;
+  } //for
+} //DeleteDynamic
+
+/// Get the state of the objects that need saving, which are the live objects
+/// other than the static ones in the level snapshot, since those come from
+/// the map and never change. This is a single pass over the object list that
+/// copies fields into a flat array, with no virtual function calls.
+/// \param objects [out] Saved object records.
+
+void CObjectManager::Save(std::vector<CSavedObject>& objects) const{
+  objects.clear();
+  objects.reserve(m_stdObjectList.size());
+
+  for(CObject* p: m_stdObjectList){
+    if(p->m_bDead || (p->m_nSnapshot >= 0 && m_vecSnapshot[p->m_nSnapshot].m_bStatic))
+      continue; //dying, or comes from the map
+
+    CSavedObject s; //saved object
+
+    s.m_eCreateSprite = p->m_eCreateSprite;
+    s.m_nSpriteIndex = p->m_nSpriteIndex;
+    s.m_nCurrentFrame = p->m_nCurrentFrame;
+    s.m_vPos = p->m_vPos;
+    s.m_fRoll = p->m_fRoll;
+    s.m_vVelocity = p->m_vVelocity;
+    s.m_fSpeed = p->m_fSpeed;
+    s.m_fRotSpeed = p->m_fRotSpeed;
+
+    switch(p->m_eCreateSprite){
+      case eSprite::Player:  s.m_nHealth = ((CPlayer*)p)->m_nHealth; break;
+      case eSprite::Zombie2: s.m_nHealth = ((CZombie*)p)->m_nHealth; break;
+      case eSprite::Turret:  s.m_nHealth = ((CTurret*)p)->m_nHealth; break;
+      default: s.m_nHealth = 0;
+    } //switch
+
+    objects.push_back(s);
+  } //for
+} //Save
+
+/// Get the state of an object that clients need to draw it. Clients only
+/// need the objects that `Save()` saves, since they draw the static objects
+/// from the map from their own copy of the map.
+/// \param p Pointer to an object.
+/// \param s [out] Networked object.
+/// \return true if the object is one that clients need.
+
+const bool CObjectManager::GetNetObject(const CObject* p, CNetObject& s) const{
+  if(p->m_bDead || (p->m_nSnapshot >= 0 && m_vecSnapshot[p->m_nSnapshot].m_bStatic))
+    return false; //dying, or comes from the map
+
+  s.m_nId = p->m_nNetId;
+  s.m_nType = (uint32_t)p->m_eCreateSprite;
+  s.m_nSprite = p->m_nSpriteIndex;
+  s.m_fX = p->m_vPos.x;
+  s.m_fY = p->m_vPos.y;
+  s.m_fRoll = p->m_fRoll;
+
+  switch(p->m_eCreateSprite){
+    case eSprite::Player:  s.m_nHealth = ((CPlayer*)p)->m_nHealth; break;
+    case eSprite::Zombie2: s.m_nHealth = ((CZombie*)p)->m_nHealth; break;
+    case eSprite::Turret:  s.m_nHealth = ((CTurret*)p)->m_nHealth; break;
+    default: s.m_nHealth = 0;
+  } //switch
+
+  return true;
+} //GetNetObject
+
+/// Get the state of the objects in a rectangle that clients need to draw.
+/// The objects are found with the spatial grid, so this only touches the
+/// objects near the rectangle.
+/// \param lo Bottom left corner of rectangle.
+/// \param hi Top right corner of rectangle.
+/// \param objects [out] Networked objects, in no particular order.
+
+void CObjectManager::GetNetObjects(const Vector2& lo, const Vector2& hi,
+  std::vector<CNetObject>& objects)
+{
+  objects.clear();
+  m_vecFound.clear();
+  Query(lo, hi, m_vecFound);
+
+  CNetObject s; //networked object
+
+  for(UINT i: m_vecFound)
+    if(GetNetObject(m_cGrid.GetAt(i), s))
+      objects.push_back(s);
+} //GetNetObjects
+
+/// Record the positions of the zombies and turrets, which are the moving
+/// objects that bullets can hit, for lag compensation. Only their per-type
+/// lists are walked.
+/// \param history Position history.
+/// \param tick Tick to record them for.
+
+void CObjectManager::RecordHistory(CPositionHistory& history, UINT tick) const{
+  history.Begin(tick);
+
+  for(eObjectType t: {eObjectType::Zombie, eObjectType::Turret})
+    for(const CObject* p=m_pTypeHead[(UINT)t]; p; p=p->m_pNextOfType)
+      if(!p->m_bDead)
+        history.Record(p->m_nNetId, p->m_vPos.x, p->m_vPos.y);
+
+  history.End();
+} //RecordHistory
+
+/// Replace the objects that `Save()` would save with saved ones. The level
+/// must have just been started, so that the static objects from the map are
+/// in place. The player and activity pointers are set to the new objects.
+/// \param objects Saved object records.
+/// \param n Number of saved object records.
+
+void CObjectManager::Load(const CSavedObject* objects, size_t n){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
+  DeleteDynamic();
+  m_pWorld->m_pPlayer = nullptr; //deleted, and set again if there is a saved one
+  m_pWorld->m_pActivity = nullptr;
+
+  for(size_t i=0; i<n; i++){
+    const CSavedObject& s = objects[i]; //shorthand
+    CObject* p = create(s.m_eCreateSprite, s.m_vPos);
+
+    p->m_nSpriteIndex = s.m_nSpriteIndex;
+    p->m_nCurrentFrame = s.m_nCurrentFrame;
+    p->m_fRoll = s.m_fRoll;
+    p->m_vVelocity = s.m_vVelocity;
+    p->m_fSpeed = s.m_fSpeed;
+    p->m_fRotSpeed = s.m_fRotSpeed;
+
+    switch(s.m_eCreateSprite){
+      case eSprite::Player:
+        ((CPlayer*)p)->m_nHealth = s.m_nHealth;
+        m_pWorld->m_pPlayer = (CPlayer*)p;
+      break;
+
+      case eSprite::Activity: m_pWorld->m_pActivity = (CActivity*)p; break;
+      case eSprite::Zombie2: ((CZombie*)p)->m_nHealth = s.m_nHealth; break;
+      case eSprite::Turret:  ((CTurret*)p)->m_nHealth = s.m_nHealth; break;
+      default: break;
+    } //switch
+  } //for
+} //Load
+
+/// Make the objects that `Save()` would save match a snapshot from a co-op
+/// server. Objects are matched to the snapshot by network identifier, since
+/// a replicated object takes the server's identifier for its own. An object
+/// that is in the snapshot is updated in place, so that it keeps its
+/// animation and any other state of its own. Objects are created only for
+/// the records that have no match, and deleted only if they aren't in the
+/// snapshot. The player pointer is set to the object with the client's
+/// player identifier, and the activity pointer to the activity.
+/// \param objects Networked objects.
+/// \param player Network identifier of the client's player, or 0 if none.
+
+void CObjectManager::Replicate(const std::vector<CNetObject>& objects, UINT player){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
+  m_mapNetIds.clear();
+
+  for(CObject* p: m_stdObjectList) //the objects that could be replicated
+    if(p->m_nSnapshot < 0 || !m_vecSnapshot[p->m_nSnapshot].m_bStatic)
+      m_mapNetIds[p->m_nNetId] = p;
+
+  m_pWorld->m_pPlayer = nullptr;
+  m_pWorld->m_pActivity = nullptr;
+
+  for(const CNetObject& s: objects){
+    const eSprite t = (eSprite)s.m_nType; //sprite type created with
+    const Vector2 pos(s.m_fX, s.m_fY); //position
+    CObject* p = nullptr; //object for this record
+
+    auto i = m_mapNetIds.find(s.m_nId); //object with this identifier
+
+    if(i != m_mapNetIds.end() && i->second->m_eCreateSprite == t){ //update it
+      p = i->second;
+      p->m_vPos = pos;
+      m_mapNetIds.erase(i); //so it isn't deleted
+    } //if
+
+    else{ //new, or its identifier has been reused for something else
+      p = create(t, pos);
+      p->m_nNetId = s.m_nId;
+    } //else
+
+    p->m_nSpriteIndex = s.m_nSprite;
+    p->m_fRoll = s.m_fRoll;
+
+    switch(t){
+      case eSprite::Player:
+        ((CPlayer*)p)->m_nHealth = s.m_nHealth;
+        if(s.m_nId == player)m_pWorld->m_pPlayer = (CPlayer*)p;
+      break;
+
+      case eSprite::Activity: m_pWorld->m_pActivity = (CActivity*)p; break;
+      case eSprite::Zombie2: ((CZombie*)p)->m_nHealth = s.m_nHealth; break;
+      case eSprite::Turret:  ((CTurret*)p)->m_nHealth = s.m_nHealth; break;
+      default: break;
+    } //switch
+  } //for
+
+  //delete the objects that weren't in the snapshot, which are those left in the map
+
+  if(!m_mapNetIds.empty())
+    for(auto i=m_stdObjectList.begin(); i!=m_stdObjectList.end();){
+      auto j = m_mapNetIds.find((*i)->m_nNetId); //unmatched object with this identifier
+
+      if(j != m_mapNetIds.end() && j->second == *i){
+        delete *i;
+        i = m_stdObjectList.erase(i);
+      } //if
+
+      else i++;
+    } //for
 
-  if(m_bDrawAABBs)
-    m_pTileManager->DrawBoundingBoxes(eSprite::Line); //draw AABBs
+  m_bGridDirty = true; //objects have moved
+} //Replicate
 
-  LBaseObjectManager::draw();
+/// Check that saved object records from a file or the network can be loaded,
+/// that is, that the sprites that they are created with and drawn with are
+/// ones that exist. Without this a damaged record would make `create()`
+/// build an object with a sprite that the renderer doesn't have.
+/// \param objects Saved object records.
+/// \param n Number of saved object records.
+/// \return true if every record can be loaded.
+
+const bool CObjectManager::IsValid(const CSavedObject* objects, size_t n){
+  for(size_t i=0; i<n; i++)
+    if((UINT)objects[i].m_eCreateSprite >= (UINT)eSprite::Size ||
+       objects[i].m_nSpriteIndex >= (UINT)eSprite::Size)
+      return false;
+
+  return true;
+} //IsValid
+
+/// Check that networked objects from a co-op server can be replicated, in
+/// the same way as `IsValid()` checks saved object records. The bit widths
+/// in the snapshot format allow sprite types that don't exist.
+/// \param objects Networked objects.
+/// \return true if every object can be replicated.
+
+const bool CObjectManager::IsValid(const std::vector<CNetObject>& objects){
+  for(const CNetObject& s: objects)
+    if(s.m_nType >= (UINT)eSprite::Size || s.m_nSprite >= (UINT)eSprite::Size)
+      return false;
+
+  return true;
+} //IsValid
+
+/// Discard the level snapshot, making sure that no object still thinks it is
+/// in it.
+
+void CObjectManager::DiscardSnapshot(){
+  for(const CObjectBlueprint& b: m_vecSnapshot)
+    if(b.m_pObj)
+      b.m_pObj->m_nSnapshot = -1;
+
+  m_vecSnapshot.clear();
+} //DiscardSnapshot
+
+/// Remove an object from the level snapshot, leaving its blueprint behind so
+/// that it can be created again. This is called from the object destructor.
+/// \param pObj Pointer to the object.
+
+void CObjectManager::Forget(CObject* pObj){
+  if(pObj->m_nSnapshot >= 0 && pObj->m_nSnapshot < (int)m_vecSnapshot.size())
+    m_vecSnapshot[pObj->m_nSnapshot].m_pObj = nullptr;
+
+  pObj->m_nSnapshot = -1;
+} //Forget
+
+/// Reader function for whether there is a level snapshot.
+/// \return true if there is a level snapshot.
+
+const bool CObjectManager::HasSnapshot() const{
+  return !m_vecSnapshot.empty();
+} //HasSnapshot
+
+/// Reader function for an object in the level snapshot.
+/// \param i Index of the object, which is its position in the object list
+/// when the snapshot was taken.
+/// \return Pointer to the object, or nullptr if it doesn't exist.
+
+CObject* CObjectManager::GetSnapshotObject(UINT i) const{
+  return i < m_vecSnapshot.size()? m_vecSnapshot[i].m_pObj: nullptr;
+} //GetSnapshotObject
+
+/// Move all objects, which also does collision detection and response and
+/// culls dead objects, then rebuild the spatial grid from the survivors.
+
+void CObjectManager::move(){
+  const CAllocScope scope(eAlloc::Objects); //charge to objects
+  LBaseObjectManager::move();
+  m_cGrid.Build(m_stdObjectList, m_pWorld->m_vWorldSize);
+  m_bGridDirty = false;
+} //move
+
+/// Find the live objects whose sprite bounds overlap a rectangle. The spatial
+/// grid is rebuilt first if objects have been created or deleted since it was
+/// last built.
+/// \param lo Bottom left corner of rectangle.
+/// \param hi Top right corner of rectangle.
+/// \param result [out] Indices of the objects found are appended to this.
+/// Use `GetQueryResult()` to get the objects themselves.
+
+void CObjectManager::Query(const Vector2& lo, const Vector2& hi,
+  std::vector<UINT>& result)
+{
+  if(m_bGridDirty){ //grid is out of date
+    m_cGrid.Build(m_stdObjectList, m_pWorld->m_vWorldSize);
+    m_bGridDirty = false;
+  } //if
+
+  m_cGrid.Query(lo, hi, result);
+} //Query
+
+/// Reader function for an object found by `Query()`.
+/// \param i Index reported by `Query()`.
+/// \return Pointer to the object.
+
+CObject* CObjectManager::GetQueryResult(UINT i) const{
+  return m_cGrid.GetAt(i);
+} //GetQueryResult
+
+/// Decide which per-type list an object belongs in. This must be called after
+/// the object is constructed since the derived class constructors set the
+/// flags that it depends on.
+/// \param t Sprite type the object was created with.
+/// \param pObj Pointer to the object.
+/// \return Object type.
+
+const eObjectType CObjectManager::GetObjectType(eSprite t, const CObject* pObj) const{
+  if(t == eSprite::Zombie2)return eObjectType::Zombie;
+  if(t == eSprite::Turret)return eObjectType::Turret;
+  if(pObj->m_bIsRadio)return eObjectType::Radio;
+  if(pObj->m_bStatic)return eObjectType::Static;
+  return eObjectType::Other;
+} //GetObjectType
+
+/// Push an object onto the front of the per-type list for its object type
+/// and increment the live count for that type.
+/// \param pObj Pointer to the object.
+
+void CObjectManager::Link(CObject* pObj){
+  const UINT n = (UINT)pObj->m_eObjectType; //per-type list index
+
+  pObj->m_pPrevOfType = nullptr;
+  pObj->m_pNextOfType = m_pTypeHead[n];
+
+  if(m_pTypeHead[n])
+    m_pTypeHead[n]->m_pPrevOfType = pObj;
+
+  m_pTypeHead[n] = pObj;
+  m_nTypeCount[n]++;
+} //Link
+
+/// Remove an object from the per-type list for its object type and decrement
+/// the live count for that type. This is called from the object destructor,
+/// so it must do nothing for an object that was never linked.
+/// \param pObj Pointer to the object.
+
+void CObjectManager::Unlink(CObject* pObj){
+  const UINT n = (UINT)pObj->m_eObjectType; //per-type list index
+
+  if(pObj->m_pPrevOfType)
+    pObj->m_pPrevOfType->m_pNextOfType = pObj->m_pNextOfType;
+  else if(m_pTypeHead[n] == pObj)
+    m_pTypeHead[n] = pObj->m_pNextOfType;
+  else return; //not linked
+
+  if(pObj->m_pNextOfType)
+    pObj->m_pNextOfType->m_pPrevOfType = pObj->m_pPrevOfType;
+
+  pObj->m_pPrevOfType = pObj->m_pNextOfType = nullptr;
+  m_nTypeCount[n]--;
+} //Unlink
+
+/// Mark all radio parts for deletion. Only the radio part list is walked.
+
+void CObjectManager::clearRadios(){
+  for(CObject* p=m_pTypeHead[(UINT)eObjectType::Radio]; p; p=p->m_pNextOfType)
+    p->m_bDead = true;
+} //clearRadios
+
+/// Draw the tiled background and the objects in the object list that are
+/// visible in the window.
+
+void CObjectManager::draw(){
+  Vector2 lo, hi; //corners of view rectangle
+  m_pWorld->m_pTileManager->GetViewRect(lo, hi);
+  DrawView(lo, hi);
 } //draw
 
+/// Draw the tiled background and the objects in the object list that are
+/// in a rectangle of the world. The objects are found from the spatial grid
+/// and sorted back into object list order so that objects with the same
+/// sprite overlap each other the same way that they would if the whole list
+/// were drawn. The tiles, objects, and bullets go into the draw list, which
+/// is flushed here so that they are batched by sprite. The AABBs, if
+/// required, go over the tiles and under the objects, so the tiles are
+/// flushed on their own first when they are drawn.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+
+void CObjectManager::DrawView(const Vector2& lo, const Vector2& hi){
+  m_pDrawList->BeginFrame();
+  m_pWorld->m_pTileManager->Draw(eSprite::Tile, lo, hi); //draw tiled background
+
+  m_nSpritesDrawn = m_nSpritesCulled = 0;
+
+  if(m_bDrawAABBs){ //draw AABBs
+    m_pDrawList->Flush(); //tiles go under them
+    m_pWorld->m_pTileManager->DrawBoundingBoxes(eSprite::Line, lo, hi,
+      m_nSpritesDrawn, m_nSpritesCulled);
+  } //if
+
+  m_vecVisible.clear();
+  Query(lo, hi, m_vecVisible);
+  std::sort(m_vecVisible.begin(), m_vecVisible.end()); //object list order
+
+  for(UINT i: m_vecVisible)
+    m_cGrid.GetAt(i)->draw();
+
+  m_nSpritesDrawn += m_vecVisible.size();
+  m_nSpritesCulled += m_cGrid.GetSize() - m_vecVisible.size();
+
+  m_pWorld->m_pBulletManager->Draw(); //bullets go over objects
+  m_pDrawList->Flush(); //sort and draw objects and bullets, and tiles if still there
+} //DrawView
+
 /// Perform collision detection and response for each object with the world
 /// edges and for all objects with another object, making sure that each pair
 /// of objects is processed only once.
@@ -75,7 +590,7 @@ void CObjectManager::BroadPhase(){
         float d = 0; //overlap distance
         BoundingSphere s(Vector3(pObj->m_vPos), pObj->m_fRadius);
         
-        if(m_pTileManager->CollideWithWall(s, norm, d)) //collide with wall
+        if(m_pWorld->m_pTileManager->CollideWithWall(s, norm, d)) //collide with wall
           pObj->CollisionResponse(norm, d); //respond 
       } //for
   } //for
@@ -83,11 +598,14 @@ void CObjectManager::BroadPhase(){
 
 /// Perform collision detection and response for a pair of objects. Makes
 /// use of the helper function Identify() because this function may be called
-/// with the objects in an arbitrary order.
+/// with the objects in an arbitrary order. Objects that have already died
+/// this frame are skipped so that they don't get to respond twice.
 /// \param p0 Pointer to the first object.
 /// \param p1 Pointer to the second object.
 
 void CObjectManager::NarrowPhase(CObject* p0, CObject* p1){
+  if(p0->m_bDead || p1->m_bDead)return; //dead objects don't collide
+
   Vector2 vSep = p0->m_vPos - p1->m_vPos; //vector from *p1 to *p0
   const float d = p0->m_fRadius + p1->m_fRadius - vSep.Length(); //overlap
 
@@ -99,33 +617,34 @@ void CObjectManager::NarrowPhase(CObject* p0, CObject* p1){
   } //if
 } //NarrowPhase
 
-/// Create a bullet object and a flash particle effect. It is assumed that the
-/// object is round and that the bullet appears at the edge of the object in
-/// the direction that it is facing and continues moving in that direction.
+/// Create a bullet in the bullet manager and a flash particle effect. It is
+/// assumed that the object is round and that the bullet appears at the edge
+/// of the object in the direction that it is facing and continues moving in
+/// that direction.
 /// \param pObj Pointer to an object.
 /// \param bullet Sprite type of bullet.
 
 void CObjectManager::FireGun(CObject* pObj, eSprite bullet){
-  m_pAudio->play(eSound::Gun);
+  if(!m_pWorld->m_bMute)m_pAudio->play(eSound::Gun);
 
   const Vector2 view = pObj->GetViewVector(); //firing object view vector
-  const float w0 = 0.5f*m_pRenderer->GetWidth(pObj->m_nSpriteIndex); //firing object width
-  const float w1 = m_pRenderer->GetWidth(bullet); //bullet width
+  const float w0 = 0.5f*GetSpriteSize((eSprite)pObj->m_nSpriteIndex).x; //firing object width
+  const float w1 = GetSpriteSize(bullet).x; //bullet width
   const Vector2 pos = pObj->m_vPos + (w0 + w1)*view; //bullet initial position
 
-  //create bullet object
+  //create bullet
 
-  CObject* pBullet = create(bullet, pos); //create bullet
-  
   const Vector2 norm = VectorNormalCC(view); //normal to view direction
-  const float m = 2.0f*m_pRandom->randf() - 1.0f; //random deflection magnitude
+  const float m = 2.0f*m_pWorld->m_cRandom.randf() - 1.0f; //random deflection magnitude
   const Vector2 deflection = 0.01f*m*norm; //random deflection
+  const Vector2 vel = pObj->m_vVelocity + 450.0f*(view + deflection); //bullet velocity
 
-  pBullet->m_vVelocity = pObj->m_vVelocity + 450.0f*(view + deflection);
-  pBullet->m_fRoll = pObj->m_fRoll; 
+  m_pWorld->m_pBulletManager->create(bullet, pos, vel, pObj->m_fRoll);
 
   //particle effect for gun fire
-  
+
+  if(m_pWorld->m_pParticleEngine == nullptr)return; //nobody to see it
+  const CAllocScope scope(eAlloc::Particles); //charge to particles
   LParticleDesc2D d;
 
   d.m_nSpriteIndex = (UINT)eSprite::Spark;
@@ -137,18 +656,80 @@ void CObjectManager::FireGun(CObject* pObj, eSprite bullet){
   d.m_fMaxScale = 0.5f;
   d.m_f4Tint = XMFLOAT4(Colors::Yellow);
   
-  m_pParticleEngine->create(d);
+  m_pWorld->m_pParticleEngine->create(d);
 } //FireGun
 
-/// Reader function for the number of turrets. 
+/// Find a live object by its network identifier. Something that needs to
+/// refer to an object that might be deleted, such as a co-op client's
+/// player, should keep its network identifier and look it up here, since a
+/// pointer to a deleted object can't be checked, and the address might have
+/// been reused by a new object.
+/// \param id Network identifier.
+/// \return Pointer to the object, or `nullptr` if there is no live object
+/// with that identifier.
+
+CObject* CObjectManager::Find(UINT id) const{
+  if(id == 0)return nullptr; //no object has identifier 0
+
+  for(CObject* p: m_stdObjectList)
+    if(p->m_nNetId == id)
+      return p->m_bDead? nullptr: p;
+
+  return nullptr;
+} //Find
+
+/// Kill an object. It is deleted the next time the objects are moved.
+/// \param pObj Pointer to the object.
+
+void CObjectManager::Kill(CObject* pObj){
+  pObj->m_bDead = true;
+} //Kill
+
+/// Reader function for the number of turrets. Zombies also have the turret
+/// flag set, so they are included in the count.
 /// \return Number of turrets in the object list.
 
 const size_t CObjectManager::GetNumTurrets() const{
-  size_t n = 0; //number of turrets
-  
-  for(CObject* pObj: m_stdObjectList) //for each object
-    if(pObj->isTurret())
-      n++;
+  return GetCount(eObjectType::Turret) + GetCount(eObjectType::Zombie);
+} //GetNumTurrets
+
+/// Reader function for the number of zombies.
+/// \return Number of zombies in the object list.
+
+const size_t CObjectManager::GetNumZombies() const{
+  return GetCount(eObjectType::Zombie);
+} //GetNumZombies
+
+/// Reader function for the number of objects of a given type. This includes
+/// objects that have died this frame but have not yet been culled.
+/// \param t Object type.
+/// \return Number of objects of that type in the object list.
+
+const size_t CObjectManager::GetCount(eObjectType t) const{
+  return m_nTypeCount[(UINT)t];
+} //GetCount
+
+/// Reader function for the head of a per-type list. The rest of the list can
+/// be reached by following `m_pNextOfType`.
+/// \param t Object type.
+/// \return Pointer to the first object of that type, or `nullptr` if none.
+
+CObject* CObjectManager::GetFirst(eObjectType t) const{
+  return m_pTypeHead[(UINT)t];
+} //GetFirst
+
+/// Reader function for the number of sprites submitted to the renderer by
+/// the last call to `draw()`, including bounding box sprites.
+/// \return Number of sprites drawn.
+
+const size_t CObjectManager::GetNumSpritesDrawn() const{
+  return m_nSpritesDrawn;
+} //GetNumSpritesDrawn
+
+/// Reader function for the number of sprites skipped by the last call to
+/// `draw()` because they were off screen, including bounding box sprites.
+/// \return Number of sprites culled.
 
-  return n;
-} //GetNumTurrets
\ No newline at end of file
+const size_t CObjectManager::GetNumSpritesCulled() const{
+  return m_nSpritesCulled;
+} //GetNumSpritesCulled
\ No newline at end of file
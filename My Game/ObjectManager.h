@@ -7,28 +7,112 @@
 #include "BaseObjectManager.h"
 #include "Object.h"
 #include "Common.h"
+#include "SpatialGrid.h"
+#include "SaveGame.h"
+#include "SnapshotCodec.h"
+
+#include <unordered_map>
+
+class CPositionHistory;
+
+/// \brief Level snapshot entry.
+///
+/// What is needed to put an object back the way it was at the start of a
+/// level: the sprite type to create it with, its sprite state, and its
+/// motion. If the object still exists, it is pointed to here so that it can
+/// be reset rather than created again.
+
+struct CObjectBlueprint{
+  eSprite m_eSprite = eSprite::Size; ///< Sprite type to create object with.
+  LSpriteDesc2D m_cDesc; ///< Sprite state.
+  Vector2 m_vVelocity; ///< Velocity.
+  float m_fSpeed = 0; ///< Speed.
+  float m_fRotSpeed = 0; ///< Rotational speed.
+  bool m_bStatic = true; ///< Is static, which means it has no other state.
+  CObject* m_pObj = nullptr; ///< The object, or nullptr if it was deleted.
+}; //CObjectBlueprint
 
 /// \brief The object manager.
 ///
-/// A collection of all of the game objects.
+/// A collection of all of the game objects. In addition to the object list
+/// inherited from `LBaseObjectManager`, each object is threaded onto an
+/// intrusive list for its `eObjectType` so that type-specific queries only
+/// touch the objects of that type, and a live count is kept for each type.
+/// A spatial grid of the live objects is rebuilt once per frame after the
+/// objects move, and is used to cull objects that are off screen, to find the
+/// objects that bullets might hit, and to find the objects near each network
+/// client. A snapshot of the objects can be
+/// taken at the start of a level so that restarting the level only has to
+/// reset them, not rebuild them.
 
 class CObjectManager: 
   public LBaseObjectManager<CObject>,
   public CCommon
 {
+  friend class CObject; ///< Objects unlink themselves when deleted.
+
   private:
+    CObject* m_pTypeHead[(UINT)eObjectType::Size] = {nullptr}; ///< Per-type list heads.
+    size_t m_nTypeCount[(UINT)eObjectType::Size] = {0}; ///< Per-type live counts.
+
+    CSpatialGrid m_cGrid; ///< Spatial grid of live objects.
+    bool m_bGridDirty = true; ///< Objects created or deleted since grid built.
+    std::vector<UINT> m_vecVisible; ///< Indices of visible objects.
+    std::vector<UINT> m_vecFound; ///< Indices of objects found for a client.
+    std::unordered_map<UINT, CObject*> m_mapNetIds; ///< Objects by network identifier.
+    std::vector<CObjectBlueprint> m_vecSnapshot; ///< Objects at start of level.
+
+    size_t m_nSpritesDrawn = 0; ///< Number of sprites submitted last frame.
+    size_t m_nSpritesCulled = 0; ///< Number of sprites culled last frame.
+    UINT m_nLastNetId = 0; ///< Network identifier of newest object.
+
     void BroadPhase(); ///< Broad phase collision detection and response.
     void NarrowPhase(CObject*, CObject*); ///< Narrow phase collision detection and response.
 
+    const bool GetNetObject(const CObject*, CNetObject&) const; ///< Get object to send.
+    const eObjectType GetObjectType(eSprite, const CObject*) const; ///< Classify object.
+    void Link(CObject*); ///< Add object to its per-type list.
+    void Unlink(CObject*); ///< Remove object from its per-type list.
+    void Forget(CObject*); ///< Remove object from level snapshot.
+    void DiscardSnapshot(); ///< Discard level snapshot.
+    void DeleteDynamic(); ///< Delete objects not reset by snapshot.
+
   public:
+    CObjectManager(CWorld*); ///< Constructor.
+    ~CObjectManager(); ///< Destructor.
+
     CObject* create(eSprite, const Vector2&); ///< Create new object.
+    void clear(); ///< Delete all objects.
+    void Snapshot(); ///< Take level snapshot.
+    void RestoreSnapshot(); ///< Restore objects from level snapshot.
+    const bool HasSnapshot() const; ///< Whether there is a level snapshot.
+    CObject* GetSnapshotObject(UINT) const; ///< Get object in level snapshot.
+    void Save(std::vector<CSavedObject>&) const; ///< Get objects to save.
+    void GetNetObjects(const Vector2&, const Vector2&,
+      std::vector<CNetObject>&); ///< Get objects in rectangle to send.
+    void RecordHistory(CPositionHistory&, UINT) const; ///< Record positions of targets.
+    void Load(const CSavedObject*, size_t); ///< Replace objects with saved ones.
+    void Replicate(const std::vector<CNetObject>&, UINT); ///< Match objects to server snapshot.
+    static const bool IsValid(const CSavedObject*, size_t); ///< Check saved objects.
+    static const bool IsValid(const std::vector<CNetObject>&); ///< Check networked objects.
+    CObject* Find(UINT) const; ///< Find live object by network identifier.
+    void Kill(CObject*); ///< Kill an object.
+    void move(); ///< Move all objects.
     
     virtual void draw(); ///< Draw all objects.
+    void DrawView(const Vector2&, const Vector2&); ///< Draw objects in rectangle.
+    void Query(const Vector2&, const Vector2&, std::vector<UINT>&); ///< Find objects in rectangle.
+    CObject* GetQueryResult(UINT) const; ///< Get object found by Query().
 
-    void clearRadios();
+    void clearRadios(); ///< Kill all radio parts.
 
     void FireGun(CObject*, eSprite); ///< Fire object's gun.
     const size_t GetNumTurrets() const; ///< Get number of turrets in object list.
+    const size_t GetNumZombies() const; ///< Get number of zombies in object list.
+    const size_t GetCount(eObjectType) const; ///< Get number of objects of a type.
+    CObject* GetFirst(eObjectType) const; ///< Get head of per-type list.
+    const size_t GetNumSpritesDrawn() const; ///< Get number of sprites drawn.
+    const size_t GetNumSpritesCulled() const; ///< Get number of sprites culled.
 }; //CObjectManager
 
 #endif //__L4RC_GAME_OBJECTMANAGER_H__
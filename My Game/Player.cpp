@@ -7,12 +7,15 @@
 #include "Particle.h"
 #include "ParticleEngine.h"
 #include "ObjectManager.h"
+#include "AllocTracker.h"
+#include "World.h"
 #include <iostream>
 
 /// Create and initialize an player object given its initial position.
+/// \param pWorld Pointer to the world the object is part of.
 /// \param p Initial position of player.
 
-CPlayer::CPlayer(const Vector2& p): CObject(eSprite::Player, p){ 
+CPlayer::CPlayer(CWorld* pWorld, const Vector2& p): CObject(pWorld, eSprite::Player, p){ 
   m_bIsTarget = true;
   m_bStatic = false;
   m_bIsActivity = false;
@@ -22,7 +25,7 @@ CPlayer::CPlayer(const Vector2& p): CObject(eSprite::Player, p){
 /// rotation speed is proportional to the frame time.
 
 void CPlayer::move() {
-    const float t = m_pTimer->GetFrameTime(); // time
+    const float t = m_pWorld->m_fFrameTime; // time
 
     // Move forwards or backwards based on m_fSpeed. 
     // Positive m_fSpeed moves upwards, negative moves downwards
@@ -52,11 +55,11 @@ void CPlayer::move() {
     m_frameCounter++;
     if ((m_fSpeed != 0.0f || m_bStrafeRight == true || m_bStrafeLeft == true) && m_frameCounter % 25 == 0) {
         if (m_bIsAlternateSprite) {
-            m_pPlayer->m_nSpriteIndex = (UINT)eSprite::Player; // walking sprite 1
+            m_nSpriteIndex = (UINT)eSprite::Player; // walking sprite 1
             m_bIsAlternateSprite = false;
         }
         else {
-            m_pPlayer->m_nSpriteIndex = (UINT)eSprite::Player2; // walking sprite 2
+            m_nSpriteIndex = (UINT)eSprite::Player2; // walking sprite 2
             m_bIsAlternateSprite = true;
         }
     }
@@ -73,7 +76,7 @@ void CPlayer::SetWalking(bool isWalking) {
 //Get the player's health
 UINT CPlayer::GetHealth() const {
     //If nullptr is returned, then the player is dead, so return 0
-    if (m_pPlayer == nullptr) {
+    if (m_pWorld->m_pPlayer == nullptr) {
 		return 0;
 	}
 	return m_nHealth;
@@ -83,7 +86,7 @@ UINT CPlayer::GetHealth() const {
 void CPlayer::SetHealth(UINT health) {
 	//If the health is set to 0, then the player is dead, so set the common player pointer to nullptr
     if (health == 0) {
-		m_pPlayer = nullptr;
+		m_pWorld->m_pPlayer = nullptr;
 	}
     if (health > m_nMaxHealth) {
 		m_nHealth = m_nMaxHealth;
@@ -92,7 +95,7 @@ void CPlayer::SetHealth(UINT health) {
 }
 
 int CPlayer::GetHungerCount() const {
-    if (m_pPlayer == nullptr) {
+    if (m_pWorld->m_pPlayer == nullptr) {
         return 0;
     }
     return m_nHungerCount;
@@ -137,7 +140,7 @@ void CPlayer::CollisionResponse(const Vector2& norm, float d, CObject* pObj) {
             if (m_nHealth > healthDecreaseAmount) {
                 m_nHealth -= healthDecreaseAmount; // Decrease health by the specified amount
                 // Play a sound
-                m_pAudio->play(eSound::Grunt);
+                if (!m_pWorld->m_bMute) m_pAudio->play(eSound::Grunt);
             }
             else {
                 m_nHealth = 0; // Ensure health doesn't go negative
@@ -152,26 +155,26 @@ void CPlayer::CollisionResponse(const Vector2& norm, float d, CObject* pObj) {
             m_vKnockbackVelocity = norm * pushbackSpeed; // Store the pushback velocity
 
             if (m_nHealth == 0) { // Player dies when health reaches zero
-                m_pAudio->play(eSound::Boom); // Explosion sound
+                if (!m_pWorld->m_bMute) m_pAudio->play(eSound::Boom); // Explosion sound
                 m_bDead = true; // Flag for deletion from object list
                 DeathFX(); // Particle effects
-                m_pPlayer = nullptr; // Clear common player pointer
+                if (m_pWorld->m_pPlayer == this) m_pWorld->m_pPlayer = nullptr; // Clear common player pointer
             }
         }
         
         else if (pObj->isRadio()) {
             //insert code for what you want to happen when the radio piece is picked up
             if (pObj->getSpriteType() == eSprite::Battery) {
-                gotBattery = true;
-                m_pObjectManager->clearRadios();
+                m_pWorld->gotBattery = true;
+                m_pWorld->m_pObjectManager->clearRadios();
             }
             if (pObj->getSpriteType() == eSprite::Antenna) {
-                gotAntenna = true;
-                m_pObjectManager->clearRadios();
+                m_pWorld->gotAntenna = true;
+                m_pWorld->m_pObjectManager->clearRadios();
             }
             if (pObj->getSpriteType() == eSprite::LogicBoard) {
-                gotLogicBoard = true;
-                m_pObjectManager->clearRadios();
+                m_pWorld->gotLogicBoard = true;
+                m_pWorld->m_pObjectManager->clearRadios();
             }
         }   
     }
@@ -183,6 +186,8 @@ void CPlayer::CollisionResponse(const Vector2& norm, float d, CObject* pObj) {
 /// Perform a particle effect to mark the death of the player.
 
 void CPlayer::DeathFX(){
+  if(m_pWorld->m_pParticleEngine == nullptr)return; //nobody to see it
+  const CAllocScope scope(eAlloc::Particles); //charge to particles
   LParticleDesc2D d; //particle descriptor
   d.m_vPos = m_vPos; //center particle at player center
 
@@ -192,7 +197,7 @@ void CPlayer::DeathFX(){
   d.m_fScaleInFrac = 0.5f;
   d.m_fFadeOutFrac = 0.8f;
   d.m_fScaleOutFrac = 0;
-  m_pParticleEngine->create(d);
+  m_pWorld->m_pParticleEngine->create(d);
 
   d.m_nSpriteIndex = (UINT)eSprite::Spark;
   d.m_fLifeSpan = 0.5f;
@@ -201,7 +206,7 @@ void CPlayer::DeathFX(){
   d.m_fScaleOutFrac = 0.3f;
   d.m_fFadeOutFrac = 0.5f;
   d.m_f4Tint = XMFLOAT4(Colors::OrangeRed);
-  m_pParticleEngine->create(d);
+  m_pWorld->m_pParticleEngine->create(d);
 } //DeathFX
 
 /// Set the strafe left flag. This function will be called in response to
@@ -12,6 +12,8 @@
 /// the other objects in the game in that it moves in respond to device inputs.
 
 class CPlayer: public CObject{
+  friend class CObjectManager; ///< Object manager saves and loads health.
+
   protected:  
     const UINT m_nMaxHealth = 12; ///< Maximum health.
     UINT m_nHealth = m_nMaxHealth; ///< Current health.
@@ -27,7 +29,7 @@ class CPlayer: public CObject{
     virtual void DeathFX(); ///< Death special effects.
 
   public:
-    CPlayer(const Vector2& p); ///< Constructor.
+    CPlayer(CWorld* pWorld, const Vector2& p); ///< Constructor.
     int m_frameCounter = 0;
     bool m_bIsAlternateSprite = false;
 
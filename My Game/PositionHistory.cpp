@@ -0,0 +1,176 @@
+/// \file PositionHistory.cpp
+/// \brief Code for the position history CPositionHistory.
+
+#include "PositionHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// Constructor.
+/// \param depth Number of ticks to keep, which is rounded up to a power of 2.
+
+CPositionHistory::CPositionHistory(size_t depth){
+  m_nDepth = 2;
+
+  while(m_nDepth < depth)
+    m_nDepth *= 2;
+
+  m_vecDrift.assign(m_nDepth, 0.0f);
+} //constructor
+
+/// Start recording the positions for a tick. Ticks must be recorded in
+/// order, and if one is skipped then everything before it is forgotten.
+/// \param tick Tick, which must not be 0.
+
+void CPositionHistory::Begin(uint32_t tick){
+  if(m_nTick != 0 && tick != m_nTick + 1)
+    clear();
+
+  m_nTick = tick;
+  m_fDrift = 0.0f;
+} //Begin
+
+/// Record an object's position for the tick being recorded. An object that
+/// hasn't been seen before gets a free slot.
+/// \param id Network identifier.
+/// \param x X coordinate.
+/// \param y Y coordinate.
+
+void CPositionHistory::Record(uint32_t id, float x, float y){
+  const size_t mask = m_nDepth - 1; //ring index mask
+  auto i = m_mapSlot.find(id); //slot lookup
+  uint32_t slot = 0; //slot
+
+  if(i == m_mapSlot.end()){ //new object
+    if(m_vecFree.empty()){
+      slot = (uint32_t)m_vecId.size();
+      m_vecId.push_back(id);
+      m_vecBorn.push_back(m_nTick);
+      m_vecSeen.push_back(m_nTick);
+      m_vecX.resize(m_vecX.size() + m_nDepth);
+      m_vecY.resize(m_vecY.size() + m_nDepth);
+    } //if
+
+    else{
+      slot = m_vecFree.back();
+      m_vecFree.pop_back();
+      m_vecId[slot] = id;
+      m_vecBorn[slot] = m_nTick;
+    } //else
+
+    m_mapSlot[id] = slot;
+  } //if
+
+  else{ //seen before
+    slot = i->second;
+
+    if(m_vecSeen[slot] + 1 == m_nTick){ //moved since last tick
+      const size_t j = slot*m_nDepth + ((m_nTick - 1) & mask); //previous position
+      const float dx = x - m_vecX[j], dy = y - m_vecY[j];
+      m_fDrift = std::max(m_fDrift, std::sqrt(dx*dx + dy*dy));
+    } //if
+  } //else
+
+  const size_t j = slot*m_nDepth + (m_nTick & mask); //position for this tick
+  m_vecX[j] = x;
+  m_vecY[j] = y;
+  m_vecSeen[slot] = m_nTick;
+} //Record
+
+/// Finish recording a tick. The slots of objects that weren't recorded this
+/// tick are freed, since those objects are gone.
+
+void CPositionHistory::End(){
+  for(uint32_t slot=0; slot<(uint32_t)m_vecId.size(); slot++)
+    if(m_vecBorn[slot] != 0 && m_vecSeen[slot] != m_nTick){
+      m_mapSlot.erase(m_vecId[slot]);
+      m_vecBorn[slot] = 0;
+      m_vecFree.push_back(slot);
+    } //if
+
+  m_vecDrift[m_nTick & (m_nDepth - 1)] = m_fDrift;
+} //End
+
+/// Forget all positions, but keep the memory for reuse.
+
+void CPositionHistory::clear(){
+  m_nTick = 0;
+  m_vecFree.clear();
+
+  for(uint32_t slot=0; slot<(uint32_t)m_vecId.size(); slot++){
+    m_vecBorn[slot] = 0;
+    m_vecFree.push_back(slot);
+  } //for
+
+  m_mapSlot.clear();
+  std::fill(m_vecDrift.begin(), m_vecDrift.end(), 0.0f);
+} //clear
+
+/// Get where an object was at the end of a tick.
+/// \param id Network identifier.
+/// \param tick Tick.
+/// \param x [out] X coordinate.
+/// \param y [out] Y coordinate.
+/// \return true if the object's position at that tick is known.
+
+const bool CPositionHistory::GetPos(uint32_t id, uint32_t tick, float& x,
+  float& y) const
+{
+  if(tick < GetOldest() || tick > m_nTick)return false; //out of range
+
+  const auto i = m_mapSlot.find(id); //slot lookup
+  if(i == m_mapSlot.end() || tick < m_vecBorn[i->second])return false;
+
+  const size_t j = i->second*m_nDepth + (tick & (m_nDepth - 1)); //position index
+  x = m_vecX[j];
+  y = m_vecY[j];
+  return true;
+} //GetPos
+
+/// Get the most that any object can have moved since a tick, which is the
+/// sum of the most that any object moved in each tick since then.
+/// \param tick Tick.
+/// \return Distance.
+
+const float CPositionHistory::GetDrift(uint32_t tick) const{
+  float d = 0; //distance
+
+  for(uint32_t t=std::max(tick, GetOldest()) + 1; t<=m_nTick; t++)
+    d += m_vecDrift[t & (m_nDepth - 1)];
+
+  return d;
+} //GetDrift
+
+/// Reader function for the newest tick recorded.
+/// \return Newest tick, or 0 if none.
+
+const uint32_t CPositionHistory::GetNewest() const{
+  return m_nTick;
+} //GetNewest
+
+/// Reader function for the oldest tick whose positions are still kept.
+/// \return Oldest tick, or 0 if none.
+
+const uint32_t CPositionHistory::GetOldest() const{
+  if(m_nTick == 0)return 0;
+  return m_nTick >= m_nDepth? m_nTick - (uint32_t)m_nDepth + 1: 1;
+} //GetOldest
+
+/// Reader function for the number of objects recorded.
+/// \return Number of objects.
+
+const size_t CPositionHistory::GetNumObjects() const{
+  return m_mapSlot.size();
+} //GetNumObjects
+
+/// Get the memory used, counting the hash table's nodes and buckets
+/// roughly.
+/// \return Number of bytes.
+
+const size_t CPositionHistory::GetBytes() const{
+  return sizeof(float)*(m_vecX.capacity() + m_vecY.capacity() + m_vecDrift.capacity()) +
+    sizeof(uint32_t)*(m_vecId.capacity() + m_vecBorn.capacity() +
+      m_vecSeen.capacity() + m_vecFree.capacity()) +
+    m_mapSlot.bucket_count()*sizeof(void*) +
+    m_mapSlot.size()*(sizeof(std::pair<uint32_t, uint32_t>) + 2*sizeof(void*));
+} //GetBytes
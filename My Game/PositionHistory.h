@@ -0,0 +1,56 @@
+/// \file PositionHistory.h
+/// \brief Interface for the position history CPositionHistory.
+
+#ifndef __L4RC_GAME_POSITIONHISTORY_H__
+#define __L4RC_GAME_POSITIONHISTORY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// \brief Recent positions of moving objects.
+///
+/// A server uses this to find out where an object was when a client fired
+/// at it, since the client was looking at a snapshot that was a few ticks
+/// old by the time its input arrived. Each object has a slot, which holds a
+/// ring buffer of its positions for the most recent ticks. The coordinates
+/// are kept in separate arrays with each slot's ring contiguous, so an
+/// object costs a fixed number of bytes however long it lives, and the slots
+/// of objects that are gone are reused. Objects are identified by their
+/// network identifiers. The most that any object moved in each tick is
+/// kept too, so that a caller can grow a spatial query around current
+/// positions far enough to catch everything that was there in the past.
+
+class CPositionHistory{
+  private:
+    size_t m_nDepth = 0; ///< Ticks kept, a power of 2.
+    uint32_t m_nTick = 0; ///< Newest tick recorded, or 0 if none.
+    float m_fDrift = 0; ///< Most any object has moved in the tick being recorded.
+
+    std::vector<float> m_vecX; ///< X coordinates, a ring of m_nDepth per slot.
+    std::vector<float> m_vecY; ///< Y coordinates, a ring of m_nDepth per slot.
+    std::vector<uint32_t> m_vecId; ///< Network identifier in each slot.
+    std::vector<uint32_t> m_vecBorn; ///< First tick recorded in each slot, or 0 if free.
+    std::vector<uint32_t> m_vecSeen; ///< Last tick recorded in each slot.
+    std::vector<float> m_vecDrift; ///< Most any object moved in each tick, a ring.
+    std::vector<uint32_t> m_vecFree; ///< Free slots.
+    std::unordered_map<uint32_t, uint32_t> m_mapSlot; ///< Slot of each identifier.
+
+  public:
+    CPositionHistory(size_t); ///< Constructor.
+
+    void Begin(uint32_t); ///< Start recording a tick.
+    void Record(uint32_t, float, float); ///< Record an object's position.
+    void End(); ///< Finish recording a tick.
+    void clear(); ///< Forget everything.
+
+    const bool GetPos(uint32_t, uint32_t, float&, float&) const; ///< Get past position.
+    const float GetDrift(uint32_t) const; ///< Get most movement since a tick.
+    const uint32_t GetNewest() const; ///< Get newest tick recorded.
+    const uint32_t GetOldest() const; ///< Get oldest tick kept.
+    const size_t GetNumObjects() const; ///< Get number of objects.
+    const size_t GetBytes() const; ///< Get memory used.
+}; //CPositionHistory
+
+#endif //__L4RC_GAME_POSITIONHISTORY_H__
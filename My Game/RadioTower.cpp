@@ -5,10 +5,11 @@
 #include "Helpers.h"
 
 /// Create and initialize a bullet object given its initial position.
+/// \param pWorld Pointer to the world the object is part of.
 /// \param t Sprite type of bullet.
 /// \param p Initial position of bullet.
 
-CRadioTower::CRadioTower(eSprite t, const Vector2& p) : CObject(t, p) {
+CRadioTower::CRadioTower(CWorld* pWorld, eSprite t, const Vector2& p) : CObject(pWorld, t, p) {
     m_bIsBullet = false;
     m_bStatic = true;
     m_bIsTarget = false;
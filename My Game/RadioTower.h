@@ -12,7 +12,7 @@ protected:
         CObject* = nullptr); ///< Collision response.
 
 public:
-    CRadioTower(eSprite t, const Vector2& p); ///< Constructor.
+    CRadioTower(CWorld* pWorld, eSprite t, const Vector2& p); ///< Constructor.
 }; //CBullet
 
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+/// \file Random.cpp
+/// \brief Code for the pseudo-random number generator CRandom.
+
+#include "Random.h"
+#include "Helpers.h"
+
+/// Constructor.
+/// \param seed Seed.
+
+CRandom::CRandom(uint32_t seed): m_stdGenerator(seed){
+} //constructor
+
+/// Seed the generator, which starts its sequence again.
+/// \param seed Seed.
+
+void CRandom::srand(uint32_t seed){
+  m_stdGenerator.seed(seed);
+} //srand
+
+/// Get a random number uniformly distributed in [0, 1).
+/// \return Random number.
+
+const float CRandom::randf(){
+  return std::uniform_real_distribution<float>(0.0f, 1.0f)(m_stdGenerator);
+} //randf
+
+/// Get a random integer uniformly distributed in a range.
+/// \param i Least value.
+/// \param j Greatest value.
+/// \return Random integer from i to j inclusive.
+
+const int CRandom::randn(int i, int j){
+  return std::uniform_int_distribution<int>(i, j)(m_stdGenerator);
+} //randn
+
+/// Get a unit vector pointing in a random direction.
+/// \return Random unit vector.
+
+const Vector2 CRandom::randv(){
+  return AngleToVector(XM_2PI*randf());
+} //randv
+
+/// Get the next number in the sequence, which is what `std::shuffle()` and
+/// the standard distributions use.
+/// \return Random 32-bit number.
+
+CRandom::result_type CRandom::operator()(){
+  return m_stdGenerator();
+} //operator()
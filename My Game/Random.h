@@ -0,0 +1,39 @@
+/// \file Random.h
+/// \brief Interface for the pseudo-random number generator CRandom.
+
+#ifndef __L4RC_GAME_RANDOM_H__
+#define __L4RC_GAME_RANDOM_H__
+
+#include <cstdint>
+#include <random>
+
+#include "GameDefines.h"
+
+/// \brief A pseudo-random number generator.
+///
+/// Each world has one of these, so that worlds running at the same time on
+/// different threads don't share a generator, and a world started from a
+/// given seed makes the same choices every time it is run. It meets the
+/// requirements of a uniform random bit generator, so it can be passed to
+/// `std::shuffle()`.
+
+class CRandom{
+  private:
+    std::mt19937 m_stdGenerator; ///< Mersenne twister.
+
+  public:
+    using result_type = std::mt19937::result_type; ///< Type of number generated.
+
+    CRandom(uint32_t = 0); ///< Constructor.
+
+    void srand(uint32_t); ///< Seed the generator.
+    const float randf(); ///< Get a random number in [0, 1).
+    const int randn(int, int); ///< Get a random integer in a range.
+    const Vector2 randv(); ///< Get a random unit vector.
+
+    result_type operator()(); ///< Get a random 32-bit number.
+    static constexpr result_type min(){return std::mt19937::min();} ///< Least number generated.
+    static constexpr result_type max(){return std::mt19937::max();} ///< Greatest number generated.
+}; //CRandom
+
+#endif //__L4RC_GAME_RANDOM_H__
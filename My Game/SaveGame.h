@@ -0,0 +1,59 @@
+/// \file SaveGame.h
+/// \brief The save game file format.
+
+#ifndef __L4RC_GAME_SAVEGAME_H__
+#define __L4RC_GAME_SAVEGAME_H__
+
+#include "Defines.h"
+#include "GameDefines.h"
+
+/// \brief Save game file header.
+///
+/// A save game file is this header followed by `m_nNumObjects` saved object
+/// records. Both are plain data, so saving is two writes and loading is two
+/// reads. The version must be bumped whenever either struct changes.
+
+struct CSaveHeader{
+  char m_chMagic[4]; ///< File signature.
+  UINT m_nVersion; ///< Format version.
+  UINT m_nNumObjects; ///< Number of saved objects.
+  eGameState m_eGameState; ///< Level being played.
+
+  float m_fElapsedTime; ///< Game time in seconds since level start.
+  int m_nDayIndex; ///< Day of the week.
+  bool m_bIncrementedDay; ///< Day already advanced this midnight.
+  bool m_bSpawnedZombies; ///< Zombies already spawned tonight.
+  UINT m_nNights; ///< Nights that zombies have come out, which sets how many come.
+
+  bool m_bGotBattery; ///< Player has the battery.
+  bool m_bGotAntenna; ///< Player has the antenna.
+  bool m_bGotLogicBoard; ///< Player has the logic board.
+  bool m_bSpawnedBattery; ///< Battery has been spawned today.
+  bool m_bSpawnedAntenna; ///< Antenna has been spawned today.
+  bool m_bSpawnedLogic; ///< Logic board has been spawned today.
+  bool m_bRadioOn; ///< Radio has been built.
+
+  int m_nHungerCount; ///< Player hunger.
+}; //CSaveHeader
+
+/// \brief Saved object.
+///
+/// The state of one object. Objects that come from the map and never change,
+/// such as the trees and buildings, are not saved.
+
+struct CSavedObject{
+  eSprite m_eCreateSprite; ///< Sprite type the object was created with.
+  UINT m_nSpriteIndex; ///< Current sprite.
+  UINT m_nCurrentFrame; ///< Current animation frame.
+  Vector2 m_vPos; ///< Position.
+  float m_fRoll; ///< Orientation.
+  Vector2 m_vVelocity; ///< Velocity.
+  float m_fSpeed; ///< Speed.
+  float m_fRotSpeed; ///< Rotational speed.
+  UINT m_nHealth; ///< Health, for objects that have it.
+}; //CSavedObject
+
+static const char SAVE_MAGIC[4] = {'L', '4', 'S', 'V'}; ///< Save game signature.
+static const UINT SAVE_VERSION = 2; ///< Save game format version.
+
+#endif //__L4RC_GAME_SAVEGAME_H__
@@ -0,0 +1,478 @@
+/// \file Server.cpp
+/// \brief Code for the co-op server CServer and its sessions CSession.
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "Server.h"
+#include "ComponentIncludes.h"
+#include "ParticleEngine.h"
+#include "ObjectManager.h"
+#include "BulletManager.h"
+#include "TileManager.h"
+#include "World.h"
+#include "Player.h"
+#include "Activity.h"
+#include "Helpers.h"
+#include "Log.h"
+
+/// Constructor. The session thread isn't started until `Start()` is called,
+/// so that the session can be given its first client beforehand.
+/// \param id Session identifier.
+/// \param source IP address of the client that started the session.
+/// \param map Map file name.
+/// \param socket Server socket to send snapshots on.
+
+CSession::CSession(UINT id, uint32_t source, const char* map, CUdpSocket& socket):
+  m_nId(id), m_nSource(source), m_strMap(map), m_cSocket(socket),
+  m_cCodec(GetSpriteSize(eSprite::Tile).x, (uint32_t)eSprite::Size),
+  m_bRunning(true), m_nNumClients(0){
+} //constructor
+
+/// Stop the session thread and wait for it to finish.
+
+CSession::~CSession(){
+  m_bRunning = false;
+  if(m_cThread.joinable())m_cThread.join();
+} //destructor
+
+/// Start the session thread.
+
+void CSession::Start(){
+  m_cThread = std::thread(&CSession::Run, this);
+} //Start
+
+/// Take an input packet from a client. A client that the session hasn't heard
+/// from before joins it, and gets a player on the next tick. Inputs that
+/// arrive out of order are ignored.
+/// \param from Client address.
+/// \param input Input packet.
+
+void CSession::Receive(const CNetAddress& from, const CNetInput& input){
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto i = std::find_if(m_vecClients.begin(), m_vecClients.end(),
+    [&](const CNetClient& c){return c.m_cAddress == from;}); //client
+
+  if(i == m_vecClients.end()){ //new client
+    CNetClient c; //client
+    c.m_cAddress = from;
+    m_vecClients.push_back(c);
+    i = m_vecClients.end() - 1;
+    m_nNumClients = m_vecClients.size();
+  } //if
+
+  if(input.m_nSequence > i->m_cInput.m_nSequence){
+    i->m_cInput = input;
+    i->m_fLastHeard = m_nTick*m_fTickTime;
+  } //if
+} //Receive
+
+/// Create the level objects from the map, the same way that the game does,
+/// together with the zombies and turrets that come out at night. There are
+/// no players until clients join. The level objects are snapshotted before
+/// the zombies and turrets are created, so that the static ones aren't sent.
+
+void CSession::CreateObjects(){
+  m_vStart = m_pWorld->CreateLevel(false); //static objects, which aren't sent
+
+  std::vector<Vector2> turretpos; //turret positions
+  std::vector<Vector2> treepos; //tree positions
+  std::vector<Vector2> zombiepos; //zombie positions
+  Vector2 start, activitypos, housepos, shoppos, radiotowerpos; //other positions
+
+  m_pWorld->m_pTileManager->GetObjects(turretpos, start, activitypos, housepos,
+    treepos, zombiepos, shoppos, radiotowerpos);
+
+  for(const Vector2& pos: zombiepos)
+    m_pWorld->m_pObjectManager->create(eSprite::Zombie2, pos);
+
+  for(const Vector2& pos: turretpos)
+    m_pWorld->m_pObjectManager->create(eSprite::Turret, pos);
+} //CreateObjects
+
+/// Get a client's player, which is looked up by its network identifier so
+/// that a player that has been deleted is never touched. A client whose
+/// player has gone is marked as dead.
+/// \param c Client.
+/// \return Pointer to the client's player, or `nullptr` if it is dead.
+
+CPlayer* CSession::GetPlayer(CNetClient& c) const{
+  CPlayer* p = (CPlayer*)m_pWorld->m_pObjectManager->Find(c.m_nPlayer); //player
+  if(p == nullptr)c.m_nPlayer = 0; //player was killed
+  return p;
+} //GetPlayer
+
+/// Apply a client's latest input to its player, the same way that
+/// `CGame::KeyboardHandler()` applies the keyboard. A shot is lag
+/// compensated by catching the bullet up from the snapshot that the client
+/// was looking at when it fired, as long as that was no more than
+/// `m_nMaxRewind` ticks ago.
+/// \param c Client.
+
+void CSession::ApplyInput(CNetClient& c){
+  CPlayer* p = GetPlayer(c); //client's player
+  if(p == nullptr)return; //dead
+
+  const UINT b = c.m_cInput.m_nButtons; //shorthand
+  const bool bWalk = (b & NET_WALK) != 0; //whether walking
+  const float speed = bWalk? 17.5f: 35.0f; //forward speed
+
+  if(b & NET_FORWARD)p->SetSpeed(speed);
+  else if(b & NET_BACK)p->SetSpeed(-speed);
+  else p->SetSpeed(0.0f);
+
+  if(b & NET_RIGHT){
+    p->SetWalking(bWalk);
+    p->StrafeRight();
+  } //if
+
+  if(b & NET_LEFT){
+    p->SetWalking(bWalk);
+    p->StrafeLeft();
+  } //if
+
+  p->SetRotation(c.m_cInput.m_fRotation);
+
+  const float t = m_nTick*m_fTickTime; //session time
+
+  if((b & NET_FIRE) && t - c.m_fLastShot >= m_pWorld->m_cTuning.m_fShotCooldown){
+    m_pWorld->m_pObjectManager->FireGun(p, eSprite::Bullet);
+    c.m_fLastShot = t;
+
+    const UINT seen = c.m_cInput.m_nSnapshot; //tick the client was looking at
+    const UINT newest = m_cHistory.GetNewest(); //newest tick recorded
+
+    if(seen != 0) //rewind, but not too far
+      m_pWorld->m_pBulletManager->CatchUp(m_cHistory,
+        std::max(seen, newest > m_nMaxRewind? newest - m_nMaxRewind: 1));
+  } //if
+
+  if(p == m_pWorld->m_pPlayer && m_pWorld->m_pActivity){ //the activity follows the lead player
+    if(b & (NET_FORWARD | NET_BACK | NET_LEFT | NET_RIGHT | NET_FIRE))
+      m_pWorld->m_pActivity->UpdatePos(p->GetPos());
+    else m_pWorld->m_pActivity->HideActivity();
+  } //if
+} //ApplyInput
+
+/// Get the part of the world that a client can see, which is its window
+/// centered on its camera, grown by half the width of the largest moving
+/// sprite so that objects poking into the window count as being in it. The
+/// camera follows the client's player and is clamped to the world the same
+/// way that `CGame::FollowCamera()` clamps it, and stays where it is while
+/// the client is dead.
+/// \param c Client.
+/// \return View rectangle.
+
+const CNetRect CSession::GetView(CNetClient& c) const{
+  const float w = (float)std::min(std::max(c.m_cInput.m_nViewWidth, 1U), NET_MAX_VIEW); //view width
+  const float h = (float)std::min(std::max(c.m_cInput.m_nViewHeight, 1U), NET_MAX_VIEW); //view height
+
+  const CPlayer* p = GetPlayer(c); //client's player
+
+  if(p){ //follow player
+    const Vector2 pos = p->GetPos(); //player position
+
+    c.m_vCamera.x = m_pWorld->m_vWorldSize.x > w?
+      std::min(std::max(pos.x, w/2), m_pWorld->m_vWorldSize.x - w/2): m_pWorld->m_vWorldSize.x/2;
+    c.m_vCamera.y = m_pWorld->m_vWorldSize.y > h?
+      std::min(std::max(pos.y, h/2), m_pWorld->m_vWorldSize.y - h/2): m_pWorld->m_vWorldSize.y/2;
+  } //if
+
+  CNetRect r; //view rectangle
+  r.m_fLeft = c.m_vCamera.x - w/2 - m_fViewPad;
+  r.m_fBottom = c.m_vCamera.y - h/2 - m_fViewPad;
+  r.m_fRight = c.m_vCamera.x + w/2 + m_fViewPad;
+  r.m_fTop = c.m_vCamera.y + h/2 + m_fViewPad;
+  return r;
+} //GetView
+
+/// Send each client a snapshot of the objects that it can see or soon might.
+/// For each client, the spatial grid finds the objects in its view and the
+/// border around it, its filter chooses which of those to send, and the
+/// result is encoded against the newest snapshot that the client has
+/// acknowledged, if that is still in its ring of sent snapshots, or against
+/// nothing otherwise. The header says which baseline was used, so the client
+/// can decode it even if snapshots arrive out of order.
+
+void CSession::SendSnapshots(){
+  static const std::vector<CNetQuantized> empty; //baseline of nothing
+
+  CNetSnapshot h = {}; //header
+  memcpy(h.m_chMagic, NET_MAGIC, 4);
+  h.m_eType = eNetPacket::Snapshot;
+  h.m_nSession = m_nId;
+  h.m_nTick = m_nTick;
+
+  for(CNetClient& c: m_vecClients){
+    const CNetRect view = GetView(c); //what the client can see
+    const CNetRect bounds = c.m_cFilter.GetBounds(view); //what it might see soon
+
+    m_pWorld->m_pObjectManager->GetNetObjects(Vector2(bounds.m_fLeft, bounds.m_fBottom),
+      Vector2(bounds.m_fRight, bounds.m_fTop), m_vecObjects);
+    c.m_cFilter.Select(m_cCodec, m_vecObjects, view,
+      c.m_cSent.Find(c.m_nLastSent), m_vecQuantized);
+
+    const std::vector<CNetQuantized>* pBase =
+      c.m_cSent.Find(c.m_cInput.m_nSnapshot); //baseline
+
+    h.m_nBaseline = pBase? c.m_cInput.m_nSnapshot: 0;
+    h.m_nAck = c.m_cInput.m_nSequence;
+    h.m_nPlayer = c.m_nPlayer;
+
+    m_cCodec.Encode(pBase? *pBase: empty, m_vecQuantized, m_vecEncoded);
+    m_vecPacket.assign((const uint8_t*)&h, (const uint8_t*)&h + sizeof(h));
+    m_vecPacket.insert(m_vecPacket.end(), m_vecEncoded.begin(), m_vecEncoded.end());
+
+    if(m_cSocket.SendTo(c.m_cAddress, m_vecPacket.data(), m_vecPacket.size())){
+      c.m_cSent.Add(m_nTick) = m_vecQuantized;
+      c.m_nLastSent = m_nTick;
+    } //if
+  } //for
+} //SendSnapshots
+
+/// The session thread. This creates a world for the session, which has a
+/// random number generator of its own, loads the map, and then runs the
+/// simulation at a fixed tick rate until there are no clients left. The whole tick is done with the clients locked, so that the
+/// server thread can't add a client part way through. A client that dies
+/// stays in the session and watches, and a client that stops sending input
+/// is dropped along with its player.
+
+void CSession::Run(){
+  CWorld world((size_t)GetSpriteSize(eSprite::Tile).x, nullptr,
+    std::random_device()()); //this session's world
+  m_pWorld = &world;
+  m_pWorld->m_fFrameTime = m_fTickTime;
+  m_pWorld->m_bMute = true;
+
+  m_pWorld->m_pTileManager->LoadMap(m_strMap.c_str());
+  CreateObjects();
+
+  const auto dt = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<float>(m_fTickTime)); //tick time
+  auto next = std::chrono::steady_clock::now(); //time of next tick
+
+  while(m_bRunning){
+    std::this_thread::sleep_until(next);
+    next += dt;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const float t = m_nTick*m_fTickTime; //session time
+
+    for(auto i=m_vecClients.begin(); i!=m_vecClients.end();){ //drop silent clients
+      if(t - i->m_fLastHeard > m_fTimeout){
+        if(CPlayer* p = GetPlayer(*i))
+          m_pWorld->m_pObjectManager->Kill(p);
+        i = m_vecClients.erase(i);
+      } //if
+
+      else i++;
+    } //for
+
+    m_nNumClients = m_vecClients.size();
+
+    if(m_vecClients.empty()){ //everyone has gone
+      m_bRunning = false;
+      break;
+    } //if
+
+    m_pWorld->m_pPlayer = nullptr;
+
+    for(CNetClient& c: m_vecClients){
+      if(!c.m_bJoined){ //new client gets a player
+        c.m_nPlayer = m_pWorld->m_pObjectManager->create(eSprite::Player, m_vStart)->GetNetId();
+        c.m_vCamera = m_vStart;
+        c.m_bJoined = true;
+      } //if
+
+      CPlayer* p = GetPlayer(c); //client's player, if alive
+
+      if(p && m_pWorld->m_pPlayer == nullptr)
+        m_pWorld->m_pPlayer = p; //lead player, whom the zombies chase
+    } //for
+
+    for(CNetClient& c: m_vecClients)
+      ApplyInput(c);
+
+    m_pWorld->m_pObjectManager->move();
+    m_pWorld->m_pBulletManager->step();
+    m_pWorld->m_pObjectManager->RecordHistory(m_cHistory, m_nTick);
+
+    SendSnapshots();
+    m_nTick++;
+  } //while
+
+  m_pWorld = nullptr; //the world goes when this returns
+} //Run
+
+/// Reader function for the session identifier.
+/// \return Session identifier.
+
+const UINT CSession::GetId() const{
+  return m_nId;
+} //GetId
+
+/// Reader function for the IP address of the client that started the
+/// session, which the server uses to limit how many sessions one address
+/// can start.
+/// \return IP address.
+
+const uint32_t CSession::GetSource() const{
+  return m_nSource;
+} //GetSource
+
+/// Reader function for whether the session thread is running.
+/// \return true if the session thread is running.
+
+const bool CSession::IsRunning() const{
+  return m_bRunning;
+} //IsRunning
+
+/// Reader function for the number of clients.
+/// \return Number of clients.
+
+const size_t CSession::GetNumClients() const{
+  return m_nNumClients;
+} //GetNumClients
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Constructor.
+
+CServer::CServer(): m_bRunning(false){
+} //constructor
+
+/// Destructor.
+
+CServer::~CServer(){
+  Stop();
+} //destructor
+
+/// Open the server socket and start the server thread. The map is read once
+/// here first, so that a missing or broken map stops the server before any
+/// session starts.
+/// \param port Port to receive input on.
+/// \param map Map file name for sessions.
+/// \return true if the server started.
+
+const bool CServer::Start(uint16_t port, const char* map){
+  Stop();
+
+  if(!m_cSocket.Open(port))return false;
+
+  m_strMap = map;
+  CTileManager(nullptr, (size_t)GetSpriteSize(eSprite::Tile).x, nullptr).ReadMap(map);
+
+  m_bRunning = true;
+  m_cThread = std::thread(&CServer::Run, this);
+
+  return true;
+} //Start
+
+/// Stop the server thread, end all sessions, and close the socket.
+
+void CServer::Stop(){
+  m_bRunning = false;
+  if(m_cThread.joinable())m_cThread.join();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for(CSession* p: m_vecSessions)
+    delete p;
+
+  m_vecSessions.clear();
+  m_cSocket.Close();
+} //Stop
+
+/// Whether a client may start a new session, which it may if the server has
+/// room for another session and the client's IP address hasn't started as
+/// many as one address may. The sessions must be locked.
+/// \param from Client address.
+/// \return true if the client may start a session.
+
+const bool CServer::CanStart(const CNetAddress& from) const{
+  if(m_vecSessions.size() >= m_nMaxSessions)return false; //server is full
+
+  const size_t n = std::count_if(m_vecSessions.begin(), m_vecSessions.end(),
+    [&](const CSession* p){return p->GetSource() == from.m_nIP;}); //started by this address
+
+  return n < m_nMaxPerSource;
+} //CanStart
+
+/// The server thread. Input packets are passed to the session that they
+/// name, which is started if it isn't running and the sender may start one.
+/// Sessions that have stopped are deleted.
+
+void CServer::Run(){
+  char buffer[NET_MAX_PACKET]; //packet buffer
+  CNetAddress from; //sender
+
+  while(m_bRunning){
+    m_cSocket.Wait(100);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(;;){
+      const int n = m_cSocket.RecvFrom(from, buffer, sizeof(buffer)); //packet size
+      if(n < 0)break; //no more packets
+
+      if(n != sizeof(CNetInput))continue; //not for us
+
+      CNetInput input; //input packet
+      memcpy(&input, buffer, sizeof(input));
+
+      if(memcmp(input.m_chMagic, NET_MAGIC, 4) ||
+        input.m_eType != eNetPacket::Input)
+        continue; //not for us
+
+      auto i = std::find_if(m_vecSessions.begin(), m_vecSessions.end(),
+        [&](const CSession* p){
+          return p->GetId() == input.m_nSession && p->IsRunning();}); //session
+
+      if(i == m_vecSessions.end()){ //start it
+        if(!CanStart(from)){
+          LOG_DEBUG("Dropped input for new session %u, too many sessions.", input.m_nSession);
+          continue;
+        } //if
+
+        CSession* p = new CSession(input.m_nSession, from.m_nIP, m_strMap.c_str(), m_cSocket);
+        p->Receive(from, input); //so that it doesn't start empty
+        p->Start();
+        m_vecSessions.push_back(p);
+      } //if
+
+      else (*i)->Receive(from, input);
+    } //for
+
+    for(auto i=m_vecSessions.begin(); i!=m_vecSessions.end();){ //reap sessions
+      if(!(*i)->IsRunning()){
+        delete *i;
+        i = m_vecSessions.erase(i);
+      } //if
+
+      else i++;
+    } //for
+  } //while
+} //Run
+
+/// Reader function for the number of sessions.
+/// \return Number of sessions.
+
+const size_t CServer::GetNumSessions() const{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_vecSessions.size();
+} //GetNumSessions
+
+/// Reader function for the number of clients in all sessions.
+/// \return Number of clients.
+
+const size_t CServer::GetNumClients() const{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t n = 0; //result
+
+  for(const CSession* p: m_vecSessions)
+    n += p->GetNumClients();
+
+  return n;
+} //GetNumClients
@@ -0,0 +1,135 @@
+/// \file Server.h
+/// \brief Interface for the co-op server CServer and its sessions CSession.
+
+#ifndef __L4RC_GAME_SERVER_H__
+#define __L4RC_GAME_SERVER_H__
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common.h"
+#include "Net.h"
+#include "PositionHistory.h"
+
+class CPlayer;
+
+/// \brief A client of a session.
+
+struct CNetClient{
+  CNetAddress m_cAddress; ///< Client address.
+  UINT m_nPlayer = 0; ///< Network identifier of client's player, or 0 if dead.
+  bool m_bJoined = false; ///< Player has been created.
+  CNetInput m_cInput = {}; ///< Latest input.
+  float m_fLastShot = -1000.0f; ///< Session time of last shot.
+  float m_fLastHeard = 0.0f; ///< Session time of latest input.
+  CSnapshotRing m_cSent{NET_HISTORY}; ///< Snapshots sent, for baselines.
+  UINT m_nLastSent = 0; ///< Tick of newest snapshot sent, or 0 if none.
+  CSnapshotFilter m_cFilter; ///< Chooses the objects to send.
+  Vector2 m_vCamera; ///< Camera position, which stays put while dead.
+}; //CNetClient
+
+/// \brief A co-op session.
+///
+/// A session is one level being played by one or more clients. It runs on
+/// its own thread with its own `CWorld`, and steps the simulation at a
+/// fixed tick rate that has nothing to do with the rendering frame rate.
+/// Each tick it applies the latest input from each client to that client's
+/// player, moves the objects and bullets, and sends each client a snapshot
+/// of the objects near its camera, delta-encoded against the newest snapshot
+/// that the client has acknowledged. The positions of the zombies and
+/// turrets are kept for a few ticks, so that a client's shots can be tested
+/// against what the client saw when it fired. The zombies chase the first
+/// client's player that is still alive. A session stops when it has no
+/// clients left.
+
+class CSession:
+  public CCommon
+{
+  private:
+    const UINT m_nId = 0; ///< Session identifier.
+    const uint32_t m_nSource = 0; ///< IP address that started the session.
+    const std::string m_strMap; ///< Map file name.
+    CUdpSocket& m_cSocket; ///< Server socket, shared by all sessions.
+    CSnapshotCodec m_cCodec; ///< Snapshot codec.
+    const float m_fTickTime = 1.0f/30.0f; ///< Seconds per tick.
+    const float m_fTimeout = 10.0f; ///< Seconds of silence before a client is dropped.
+    const float m_fViewPad = 64.0f; ///< Half the width of the largest moving sprite.
+    const UINT m_nMaxRewind = 6; ///< Most ticks to rewind a shot, which is 200 ms.
+
+    std::mutex m_mutex; ///< Guards the clients.
+    std::vector<CNetClient> m_vecClients; ///< Clients.
+    std::thread m_cThread; ///< Session thread.
+    std::atomic<bool> m_bRunning; ///< Session thread is running.
+    std::atomic<size_t> m_nNumClients; ///< Number of clients.
+
+    UINT m_nTick = 1; ///< Current tick, counting from 1 so that 0 can mean none.
+    Vector2 m_vStart; ///< Player start position.
+    CPositionHistory m_cHistory{8}; ///< Recent positions of zombies and turrets.
+    std::vector<CNetObject> m_vecObjects; ///< Networked objects buffer.
+    std::vector<CNetQuantized> m_vecQuantized; ///< Quantized objects buffer.
+    std::vector<uint8_t> m_vecEncoded; ///< Encoded objects buffer.
+    std::vector<uint8_t> m_vecPacket; ///< Snapshot packet buffer.
+
+    void Run(); ///< Session thread.
+    void CreateObjects(); ///< Create level objects.
+    CPlayer* GetPlayer(CNetClient&) const; ///< Get a client's player.
+    void ApplyInput(CNetClient&); ///< Apply a client's input to its player.
+    const CNetRect GetView(CNetClient&) const; ///< Get a client's view.
+    void SendSnapshots(); ///< Send a snapshot to each client.
+
+  public:
+    CSession(UINT, uint32_t, const char*, CUdpSocket&); ///< Constructor.
+    ~CSession(); ///< Destructor.
+
+    void Start(); ///< Start session thread.
+    void Receive(const CNetAddress&, const CNetInput&); ///< Take input from client.
+
+    const UINT GetId() const; ///< Get session identifier.
+    const uint32_t GetSource() const; ///< Get IP address that started it.
+    const bool IsRunning() const; ///< Whether the session is running.
+    const size_t GetNumClients() const; ///< Get number of clients.
+}; //CSession
+
+/// \brief The co-op server.
+///
+/// The server owns a UDP socket and a limited number of sessions. Its thread
+/// receives input packets and passes each one to the session it names,
+/// starting the session if it isn't already running, and deletes the sessions
+/// that have stopped. Since each session is a world and a thread of its own,
+/// a packet naming a new session is dropped if the server already has as
+/// many sessions as it allows, or if the address that sent it has already
+/// started as many as one address may.
+
+class CServer:
+  public CCommon
+{
+  private:
+    CUdpSocket m_cSocket; ///< Server socket.
+    std::string m_strMap; ///< Map file name for new sessions.
+    std::thread m_cThread; ///< Server thread.
+    std::atomic<bool> m_bRunning; ///< Server thread is running.
+
+    mutable std::mutex m_mutex; ///< Guards the sessions.
+    std::vector<CSession*> m_vecSessions; ///< Sessions.
+    const size_t m_nMaxSessions = 32; ///< Most sessions at once.
+    const size_t m_nMaxPerSource = 2; ///< Most sessions started by one IP address.
+
+    const bool CanStart(const CNetAddress&) const; ///< Whether an address may start a session.
+
+    void Run(); ///< Server thread.
+
+  public:
+    CServer(); ///< Constructor.
+    ~CServer(); ///< Destructor.
+
+    const bool Start(uint16_t, const char*); ///< Start serving.
+    void Stop(); ///< Stop serving.
+
+    const size_t GetNumSessions() const; ///< Get number of sessions.
+    const size_t GetNumClients() const; ///< Get number of clients.
+}; //CServer
+
+#endif //__L4RC_GAME_SERVER_H__
@@ -12,7 +12,7 @@ protected:
         CObject* = nullptr); ///< Collision response.
 
 public:
-    CShop(eSprite t, const Vector2& p); ///< Constructor.
+    CShop(CWorld* pWorld, eSprite t, const Vector2& p); ///< Constructor.
 }; //CBullet
 
 #endif
\ No newline at end of file
@@ -0,0 +1,550 @@
+/// \file SnapshotCodec.cpp
+/// \brief Code for the network snapshot codec CSnapshotCodec and its
+/// helpers CSnapshotRing and CSnapshotFilter.
+
+#include "SnapshotCodec.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// \brief Bit writer.
+///
+/// Appends bits to a byte buffer, low bits first.
+
+struct CBitWriter{
+  std::vector<uint8_t>& m_vecOut; ///< Output buffer.
+  uint64_t m_nBits = 0; ///< Bits not yet written to the buffer.
+  uint32_t m_nCount = 0; ///< Number of bits not yet written.
+
+  CBitWriter(std::vector<uint8_t>& out): m_vecOut(out){}
+
+  /// Write some bits.
+  /// \param n Bits, which must fit in the count.
+  /// \param count Number of bits, at most 32.
+
+  void Put(uint32_t n, uint32_t count){
+    m_nBits |= (uint64_t)n << m_nCount;
+    m_nCount += count;
+
+    while(m_nCount >= 8){
+      m_vecOut.push_back((uint8_t)m_nBits);
+      m_nBits >>= 8;
+      m_nCount -= 8;
+    } //while
+  } //Put
+
+  /// Write a signed integer in two's complement.
+  /// \param n Integer, which must fit in the count.
+  /// \param count Number of bits.
+
+  void PutSigned(int32_t n, uint32_t count){
+    Put((uint32_t)n & ((1u << count) - 1), count);
+  } //PutSigned
+
+  /// Write the bits that are left over, padded to a whole byte.
+
+  void Flush(){
+    if(m_nCount > 0)m_vecOut.push_back((uint8_t)m_nBits);
+    m_nBits = m_nCount = 0;
+  } //Flush
+}; //CBitWriter
+
+/// \brief Bit reader.
+///
+/// Reads bits written by a `CBitWriter`. Reading past the end gives zeros
+/// and sets the overrun flag.
+
+struct CBitReader{
+  const uint8_t* m_pIn; ///< Input buffer.
+  size_t m_nSize; ///< Size of input buffer in bytes.
+  size_t m_nPos = 0; ///< Index of next bit.
+  bool m_bOverrun = false; ///< Read past the end.
+
+  CBitReader(const uint8_t* p, size_t n): m_pIn(p), m_nSize(n){}
+
+  /// Read some bits.
+  /// \param count Number of bits, at most 32.
+  /// \return The bits.
+
+  uint32_t Get(uint32_t count){
+    if(m_nPos + count > 8*m_nSize){
+      m_bOverrun = true;
+      return 0;
+    } //if
+
+    uint32_t n = 0; //result
+
+    for(uint32_t i=0; i<count;){
+      const size_t byte = m_nPos >> 3; //current byte
+      const uint32_t shift = m_nPos & 7; //bit offset in current byte
+      const uint32_t take = std::min(8 - shift, count - i); //bits to take from it
+
+      n |= (uint32_t)((m_pIn[byte] >> shift) & ((1u << take) - 1)) << i;
+      i += take;
+      m_nPos += take;
+    } //for
+
+    return n;
+  } //Get
+
+  /// Read a signed integer in two's complement.
+  /// \param count Number of bits.
+  /// \return The integer.
+
+  int32_t GetSigned(uint32_t count){
+    const uint32_t n = Get(count); //bits
+    const uint32_t sign = 1u << (count - 1); //sign bit
+    return (int32_t)(n ^ sign) - (int32_t)sign;
+  } //GetSigned
+}; //CBitReader
+
+static const uint32_t OP_UPDATE = 0; ///< Changed object record.
+static const uint32_t OP_CREATE = 1; ///< New object record.
+static const uint32_t OP_REMOVE = 2; ///< Removed object record.
+
+static const uint32_t CHANGED_POS = 1; ///< Position changed.
+static const uint32_t CHANGED_ROLL = 2; ///< Orientation changed.
+static const uint32_t CHANGED_SPRITE = 4; ///< Sprite changed.
+static const uint32_t CHANGED_HEALTH = 8; ///< Health changed.
+
+/// Write the gap between consecutive network identifiers, which is at least
+/// 1 and usually small.
+/// \param w Bit writer.
+/// \param gap Gap.
+
+static void PutGap(CBitWriter& w, uint32_t gap){
+  if(gap <= 16){w.Put(0, 1); w.Put(gap - 1, 4);}
+  else if(gap <= 1024){w.Put(1, 2); w.Put(gap - 1, 10);}
+  else{w.Put(3, 2); w.Put(gap, 32);}
+} //PutGap
+
+/// Read a gap written by `PutGap()`.
+/// \param r Bit reader.
+/// \return Gap.
+
+static uint32_t GetGap(CBitReader& r){
+  if(r.Get(1) == 0)return r.Get(4) + 1;
+  if(r.Get(1) == 0)return r.Get(10) + 1;
+  return r.Get(32);
+} //GetGap
+
+/// Write a coordinate as a delta from its baseline if it is small, and
+/// in full otherwise.
+/// \param w Bit writer.
+/// \param base Baseline coordinate.
+/// \param n Coordinate.
+/// \param bits Bits in a full coordinate.
+
+static void PutCoord(CBitWriter& w, uint32_t base, uint32_t n, uint32_t bits){
+  const int32_t d = (int32_t)n - (int32_t)base; //delta
+
+  if(d >= -16 && d < 16){w.Put(0, 1); w.PutSigned(d, 5);}
+  else if(d >= -256 && d < 256){w.Put(1, 2); w.PutSigned(d, 9);}
+  else{w.Put(3, 2); w.Put(n, bits);}
+} //PutCoord
+
+/// Read a coordinate written by `PutCoord()`.
+/// \param r Bit reader.
+/// \param base Baseline coordinate.
+/// \param bits Bits in a full coordinate.
+/// \return Coordinate.
+
+static uint32_t GetCoord(CBitReader& r, uint32_t base, uint32_t bits){
+  if(r.Get(1) == 0)return (uint32_t)((int32_t)base + r.GetSigned(5));
+  if(r.Get(1) == 0)return (uint32_t)((int32_t)base + r.GetSigned(9));
+  return r.Get(bits);
+} //GetCoord
+
+/// Constructor.
+/// \param tile Tile width and height in pixels.
+/// \param types Number of sprite types.
+
+CSnapshotCodec::CSnapshotCodec(float tile, uint32_t types):
+  m_fScale((float)(1 << m_nSubBits)/tile)
+{
+  while((1u << m_nTypeBits) < types)
+    m_nTypeBits++;
+} //constructor
+
+/// Quantize the objects and sort them by network identifier. Coordinates
+/// outside the world are clamped to its edges.
+/// \param objects Objects.
+/// \param q [out] Quantized objects.
+
+void CSnapshotCodec::Quantize(const std::vector<CNetObject>& objects,
+  std::vector<CNetQuantized>& q) const
+{
+  const float maxpos = (float)((1u << m_nPosBits) - 1); //largest coordinate
+  const float turn = 6.28318531f; //radians in a turn
+  const uint32_t rollmask = (1u << m_nRollBits) - 1; //orientation mask
+  const uint32_t maxhealth = (1u << m_nHealthBits) - 1; //largest health
+
+  q.resize(objects.size());
+
+  for(size_t i=0; i<objects.size(); i++){
+    const CNetObject& p = objects[i]; //shorthand
+    CNetQuantized& s = q[i]; //shorthand
+
+    s.m_nId = p.m_nId;
+    s.m_nType = p.m_nType;
+    s.m_nSprite = p.m_nSprite;
+    s.m_nX = (uint32_t)std::min(std::max(std::round(p.m_fX*m_fScale), 0.0f), maxpos);
+    s.m_nY = (uint32_t)std::min(std::max(std::round(p.m_fY*m_fScale), 0.0f), maxpos);
+    s.m_nRoll = (uint32_t)(int32_t)std::lround(p.m_fRoll/turn*(rollmask + 1)) & rollmask;
+    s.m_nHealth = std::min(p.m_nHealth, maxhealth);
+  } //for
+
+  std::sort(q.begin(), q.end(), [](const CNetQuantized& a, const CNetQuantized& b){
+    return a.m_nId < b.m_nId;});
+} //Quantize
+
+/// Turn quantized objects back into objects, to within the quantization
+/// step.
+/// \param q Quantized objects.
+/// \param objects [out] Objects.
+
+void CSnapshotCodec::Dequantize(const std::vector<CNetQuantized>& q,
+  std::vector<CNetObject>& objects) const
+{
+  const float turn = 6.28318531f; //radians in a turn
+
+  objects.resize(q.size());
+
+  for(size_t i=0; i<q.size(); i++){
+    const CNetQuantized& s = q[i]; //shorthand
+    CNetObject& p = objects[i]; //shorthand
+
+    p.m_nId = s.m_nId;
+    p.m_nType = s.m_nType;
+    p.m_nSprite = s.m_nSprite;
+    p.m_fX = s.m_nX/m_fScale;
+    p.m_fY = s.m_nY/m_fScale;
+    p.m_fRoll = s.m_nRoll*turn/(1u << m_nRollBits);
+    p.m_nHealth = s.m_nHealth;
+  } //for
+} //Dequantize
+
+/// Encode a snapshot as a delta against a baseline. The output is a 1 bit
+/// and an object record for each object that is new, changed, or removed, in
+/// order of network identifier, and then a 0 bit. A record is the gap from
+/// the previous record's identifier, an operation code, and then for a new
+/// object all of its fields, or for a changed object a mask of the fields
+/// that changed and those fields. Removed objects have no fields.
+/// \param base Baseline, which may be empty.
+/// \param q Snapshot.
+/// \param out [out] Encoded snapshot.
+
+void CSnapshotCodec::Encode(const std::vector<CNetQuantized>& base,
+  const std::vector<CNetQuantized>& q, std::vector<uint8_t>& out) const
+{
+  const uint32_t rollmask = (1u << m_nRollBits) - 1; //orientation mask
+
+  out.clear();
+  CBitWriter w(out);
+  uint32_t id = 0; //identifier of previous record
+
+  auto Begin = [&](uint32_t next, uint32_t op){ //start a record
+    w.Put(1, 1);
+    PutGap(w, next - id);
+    w.Put(op, 2);
+    id = next;
+  }; //Begin
+
+  size_t i = 0, j = 0; //indices into baseline and snapshot
+
+  while(i < base.size() || j < q.size()){
+    if(j == q.size() || (i < base.size() && base[i].m_nId < q[j].m_nId)){
+      Begin(base[i++].m_nId, OP_REMOVE);
+      continue;
+    } //if
+
+    const CNetQuantized& s = q[j++]; //shorthand
+
+    if(i == base.size() || s.m_nId < base[i].m_nId){ //new object
+      Begin(s.m_nId, OP_CREATE);
+      w.Put(s.m_nType, m_nTypeBits);
+      w.Put(s.m_nSprite, m_nTypeBits);
+      w.Put(s.m_nX, m_nPosBits);
+      w.Put(s.m_nY, m_nPosBits);
+      w.Put(s.m_nRoll, m_nRollBits);
+      w.Put(s.m_nHealth, m_nHealthBits);
+      continue;
+    } //if
+
+    const CNetQuantized& b = base[i++]; //same object in baseline
+
+    const uint32_t mask =
+      (s.m_nX != b.m_nX || s.m_nY != b.m_nY? CHANGED_POS: 0) |
+      (s.m_nRoll != b.m_nRoll? CHANGED_ROLL: 0) |
+      (s.m_nSprite != b.m_nSprite? CHANGED_SPRITE: 0) |
+      (s.m_nHealth != b.m_nHealth? CHANGED_HEALTH: 0); //changed fields
+
+    if(mask == 0)continue; //unchanged
+
+    Begin(s.m_nId, OP_UPDATE);
+    w.Put(mask, 4);
+
+    if(mask & CHANGED_POS){
+      PutCoord(w, b.m_nX, s.m_nX, m_nPosBits);
+      PutCoord(w, b.m_nY, s.m_nY, m_nPosBits);
+    } //if
+
+    if(mask & CHANGED_ROLL){
+      const int32_t d = (int32_t)((s.m_nRoll - b.m_nRoll + 8) & rollmask) - 8; //shortest way round
+
+      if(d >= -8 && d < 8){w.Put(0, 1); w.PutSigned(d, 4);}
+      else{w.Put(1, 1); w.Put(s.m_nRoll, m_nRollBits);}
+    } //if
+
+    if(mask & CHANGED_SPRITE)w.Put(s.m_nSprite, m_nTypeBits);
+    if(mask & CHANGED_HEALTH)w.Put(s.m_nHealth, m_nHealthBits);
+  } //while
+
+  w.Put(0, 1);
+  w.Flush();
+} //Encode
+
+/// Decode a snapshot encoded by `Encode()` against the same baseline.
+/// \param base Baseline, which may be empty.
+/// \param p Pointer to encoded snapshot.
+/// \param n Size of encoded snapshot in bytes.
+/// \param q [out] Snapshot.
+/// \return true if the encoded snapshot was well formed.
+
+const bool CSnapshotCodec::Decode(const std::vector<CNetQuantized>& base,
+  const uint8_t* p, size_t n, std::vector<CNetQuantized>& q) const
+{
+  const uint32_t rollmask = (1u << m_nRollBits) - 1; //orientation mask
+
+  q.clear();
+  q.reserve(base.size());
+
+  CBitReader r(p, n);
+  uint32_t id = 0; //identifier of previous record
+  size_t i = 0; //index into baseline
+
+  while(r.Get(1) == 1 && !r.m_bOverrun){
+    const uint32_t gap = GetGap(r); //identifier gap
+    const uint32_t op = r.Get(2); //operation
+    if(gap == 0 || id + gap < id)return false; //out of order
+
+    id += gap;
+
+    while(i < base.size() && base[i].m_nId < id) //unchanged objects
+      q.push_back(base[i++]);
+
+    const bool bInBase = i < base.size() && base[i].m_nId == id; //whether in baseline
+
+    if(op == OP_REMOVE){
+      if(!bInBase)return false;
+      i++;
+    } //if
+
+    else if(op == OP_CREATE){
+      if(bInBase)return false;
+
+      CNetQuantized s; //new object
+      s.m_nId = id;
+      s.m_nType = r.Get(m_nTypeBits);
+      s.m_nSprite = r.Get(m_nTypeBits);
+      s.m_nX = r.Get(m_nPosBits);
+      s.m_nY = r.Get(m_nPosBits);
+      s.m_nRoll = r.Get(m_nRollBits);
+      s.m_nHealth = r.Get(m_nHealthBits);
+      q.push_back(s);
+    } //else if
+
+    else if(op == OP_UPDATE){
+      if(!bInBase)return false;
+
+      CNetQuantized s = base[i++]; //changed object
+      const uint32_t mask = r.Get(4); //changed fields
+
+      if(mask & CHANGED_POS){
+        s.m_nX = GetCoord(r, s.m_nX, m_nPosBits);
+        s.m_nY = GetCoord(r, s.m_nY, m_nPosBits);
+      } //if
+
+      if(mask & CHANGED_ROLL){
+        if(r.Get(1) == 0)s.m_nRoll = (s.m_nRoll + r.GetSigned(4)) & rollmask;
+        else s.m_nRoll = r.Get(m_nRollBits);
+      } //if
+
+      if(mask & CHANGED_SPRITE)s.m_nSprite = r.Get(m_nTypeBits);
+      if(mask & CHANGED_HEALTH)s.m_nHealth = r.Get(m_nHealthBits);
+
+      q.push_back(s);
+    } //else if
+
+    else return false; //unknown operation
+  } //while
+
+  if(r.m_bOverrun)return false;
+
+  while(i < base.size()) //unchanged objects
+    q.push_back(base[i++]);
+
+  return true;
+} //Decode
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Constructor.
+/// \param n Number of snapshots to keep.
+
+CSnapshotRing::CSnapshotRing(size_t n):
+  m_vecSnapshots(n > 0? n: 1), m_vecTicks(n > 0? n: 1, 0){
+} //constructor
+
+/// Add a snapshot, replacing the oldest one if the ring is full.
+/// \param tick Tick of the snapshot, which must not be 0.
+/// \return Reference to the snapshot buffer, for the caller to fill in.
+
+std::vector<CNetQuantized>& CSnapshotRing::Add(uint32_t tick){
+  const size_t i = tick%m_vecTicks.size(); //ring index
+  m_vecTicks[i] = tick;
+  return m_vecSnapshots[i];
+} //Add
+
+/// Find the snapshot for a tick.
+/// \param tick Tick.
+/// \return Pointer to the snapshot, or `nullptr` if it isn't in the ring.
+
+const std::vector<CNetQuantized>* CSnapshotRing::Find(uint32_t tick) const{
+  const size_t i = tick%m_vecTicks.size(); //ring index
+  return tick != 0 && m_vecTicks[i] == tick? &m_vecSnapshots[i]: nullptr;
+} //Find
+
+/// Forget all snapshots.
+
+void CSnapshotRing::clear(){
+  std::fill(m_vecTicks.begin(), m_vecTicks.end(), 0);
+} //clear
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Constructor.
+/// \param margin Width of the border around the view in pixels.
+/// \param budget Most border objects sent per snapshot.
+
+CSnapshotFilter::CSnapshotFilter(float margin, size_t budget):
+  m_fMargin(std::max(margin, 1.0f)), m_nBudget(budget){
+} //constructor
+
+/// Get the rectangle that contains the view and the border around it, which
+/// is where the objects passed to `Select()` should come from.
+/// \param view View rectangle.
+/// \return View rectangle grown by the border.
+
+const CNetRect CSnapshotFilter::GetBounds(const CNetRect& view) const{
+  CNetRect r; //view and border
+  r.m_fLeft = view.m_fLeft - m_fMargin;
+  r.m_fBottom = view.m_fBottom - m_fMargin;
+  r.m_fRight = view.m_fRight + m_fMargin;
+  r.m_fTop = view.m_fTop + m_fMargin;
+  return r;
+} //GetBounds
+
+/// Choose the objects to send to a client and quantize them. Objects in the
+/// view are sent, and objects in the border that are due are sent. Other
+/// objects in the border are copied from the previous snapshot if they were
+/// in it, and left out otherwise.
+/// \param codec Codec to quantize with.
+/// \param objects Objects in the view and border, in any order.
+/// \param view View rectangle.
+/// \param pLast Previous snapshot sent to this client, or `nullptr` if none.
+/// \param q [out] Quantized snapshot, sorted by network identifier.
+
+void CSnapshotFilter::Select(const CSnapshotCodec& codec,
+  const std::vector<CNetObject>& objects, const CNetRect& view,
+  const std::vector<CNetQuantized>* pLast, std::vector<CNetQuantized>& q)
+{
+  //sort by identifier, so that the quantized objects line up with these
+
+  m_vecSorted.assign(objects.begin(), objects.end());
+  std::sort(m_vecSorted.begin(), m_vecSorted.end(),
+    [](const CNetObject& a, const CNetObject& b){return a.m_nId < b.m_nId;});
+  codec.Quantize(m_vecSorted, m_vecQuantized);
+
+  const size_t n = m_vecSorted.size(); //number of objects
+  m_vecSend.assign(n, 0);
+  m_vecDue.clear();
+  m_vecNext.clear();
+
+  //accumulate priority for the objects in the border, merging the old
+  //priorities in by identifier
+
+  size_t j = 0; //index into old priorities
+
+  for(size_t i=0; i<n; i++){
+    const CNetObject& p = m_vecSorted[i]; //shorthand
+
+    const float dx = std::max(std::max(view.m_fLeft - p.m_fX, p.m_fX - view.m_fRight), 0.0f);
+    const float dy = std::max(std::max(view.m_fBottom - p.m_fY, p.m_fY - view.m_fTop), 0.0f);
+
+    if(dx == 0 && dy == 0){ //in view
+      m_vecSend[i] = 1;
+      continue;
+    } //if
+
+    const float d = std::sqrt(dx*dx + dy*dy); //distance from view
+    if(d >= m_fMargin)continue; //too far away
+
+    while(j < m_vecPriority.size() && m_vecPriority[j].first < p.m_nId)
+      j++;
+
+    float priority = std::max(1.0f - d/m_fMargin, m_fMinRate); //gained this snapshot
+
+    if(j < m_vecPriority.size() && m_vecPriority[j].first == p.m_nId)
+      priority += m_vecPriority[j].second;
+
+    if(priority >= 1.0f)
+      m_vecDue.push_back(std::make_pair(i, m_vecNext.size()));
+
+    m_vecNext.push_back(std::make_pair(p.m_nId, priority));
+  } //for
+
+  //send the due objects with the highest priority, and reset their priority
+
+  if(m_vecDue.size() > m_nBudget){
+    std::nth_element(m_vecDue.begin(), m_vecDue.begin() + m_nBudget, m_vecDue.end(),
+      [&](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b){
+        return m_vecNext[a.second].second > m_vecNext[b.second].second;});
+    m_vecDue.resize(m_nBudget);
+  } //if
+
+  for(const std::pair<size_t, size_t>& due: m_vecDue){
+    m_vecSend[due.first] = 1;
+    m_vecNext[due.second].second = 0.0f;
+  } //for
+
+  m_vecPriority.swap(m_vecNext);
+
+  //output the objects sent, and the border objects from the previous
+  //snapshot that weren't sent
+
+  q.clear();
+  size_t k = 0; //index into previous snapshot
+
+  for(size_t i=0; i<n; i++){
+    if(m_vecSend[i]){
+      q.push_back(m_vecQuantized[i]);
+      continue;
+    } //if
+
+    if(pLast == nullptr)continue;
+    const uint32_t id = m_vecQuantized[i].m_nId; //identifier
+
+    while(k < pLast->size() && (*pLast)[k].m_nId < id)
+      k++;
+
+    if(k < pLast->size() && (*pLast)[k].m_nId == id)
+      q.push_back((*pLast)[k]);
+  } //for
+} //Select
+
+/// Forget the priorities, for when the client starts again.
+
+void CSnapshotFilter::clear(){
+  m_vecPriority.clear();
+} //clear
@@ -0,0 +1,149 @@
+/// \file SnapshotCodec.h
+/// \brief Interface for the network snapshot codec CSnapshotCodec and its
+/// helpers CSnapshotRing and CSnapshotFilter.
+
+#ifndef __L4RC_GAME_SNAPSHOTCODEC_H__
+#define __L4RC_GAME_SNAPSHOTCODEC_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// \brief Networked object state.
+///
+/// The part of an object's state that clients need in order to draw it.
+/// This has no engine types in it, so that the codec can be benchmarked
+/// without the engine.
+
+struct CNetObject{
+  uint32_t m_nId = 0; ///< Network identifier, unique in a session and never 0.
+  uint32_t m_nType = 0; ///< Sprite type the object was created with.
+  uint32_t m_nSprite = 0; ///< Current sprite.
+  float m_fX = 0; ///< Position x coordinate in pixels.
+  float m_fY = 0; ///< Position y coordinate in pixels.
+  float m_fRoll = 0; ///< Orientation in radians.
+  uint32_t m_nHealth = 0; ///< Health, for objects that have it.
+}; //CNetObject
+
+/// \brief Quantized networked object state.
+///
+/// A `CNetObject` with its position in units of a fraction of a tile and its
+/// orientation in units of a fraction of a turn. Two objects whose quantized
+/// states are equal look the same to a client.
+
+struct CNetQuantized{
+  uint32_t m_nId; ///< Network identifier.
+  uint32_t m_nType; ///< Sprite type the object was created with.
+  uint32_t m_nSprite; ///< Current sprite.
+  uint32_t m_nX; ///< Quantized x coordinate.
+  uint32_t m_nY; ///< Quantized y coordinate.
+  uint32_t m_nRoll; ///< Quantized orientation.
+  uint32_t m_nHealth; ///< Health, clamped.
+}; //CNetQuantized
+
+/// \brief Network snapshot codec.
+///
+/// A snapshot is the quantized state of every networked object, sorted by
+/// network identifier. It is encoded as a bit-packed delta against a
+/// baseline, which is a snapshot that the receiver is known to have, or
+/// against nothing if there is no such snapshot. Objects that haven't changed
+/// since the baseline cost nothing. An object that has changed costs its
+/// identifier gap, an operation code, and a mask of its changed fields, and
+/// then only those fields, with position and orientation as small signed
+/// deltas when they fit. A position is a tile number and a fraction of a
+/// tile, which allows worlds of up to 256 tiles on a side.
+
+class CSnapshotCodec{
+  private:
+    float m_fScale = 1.0f; ///< Quantized units per pixel.
+    uint32_t m_nTypeBits = 0; ///< Bits in a sprite type or sprite.
+    static const uint32_t m_nTileBits = 8; ///< Bits in a tile number.
+    static const uint32_t m_nSubBits = 5; ///< Bits in a fraction of a tile.
+    static const uint32_t m_nPosBits = m_nTileBits + m_nSubBits; ///< Bits in a coordinate.
+    static const uint32_t m_nRollBits = 8; ///< Bits in an orientation.
+    static const uint32_t m_nHealthBits = 5; ///< Bits in a health.
+
+  public:
+    CSnapshotCodec(float, uint32_t); ///< Constructor.
+
+    void Quantize(const std::vector<CNetObject>&,
+      std::vector<CNetQuantized>&) const; ///< Quantize a snapshot.
+    void Dequantize(const std::vector<CNetQuantized>&,
+      std::vector<CNetObject>&) const; ///< Undo quantization.
+
+    void Encode(const std::vector<CNetQuantized>&, const std::vector<CNetQuantized>&,
+      std::vector<uint8_t>&) const; ///< Encode a snapshot.
+    const bool Decode(const std::vector<CNetQuantized>&, const uint8_t*, size_t,
+      std::vector<CNetQuantized>&) const; ///< Decode a snapshot.
+}; //CSnapshotCodec
+
+/// \brief Recent snapshots.
+///
+/// A ring buffer of recent quantized snapshots labeled by tick, which the
+/// sender keeps for the snapshots that it sent and the receiver keeps for
+/// the snapshots that it received, so that both have the baseline that the
+/// receiver last acknowledged. The snapshot buffers are reused as the ring
+/// wraps around.
+
+class CSnapshotRing{
+  private:
+    std::vector<std::vector<CNetQuantized>> m_vecSnapshots; ///< Snapshots.
+    std::vector<uint32_t> m_vecTicks; ///< Tick of each snapshot, 0 for none.
+
+  public:
+    CSnapshotRing(size_t); ///< Constructor.
+
+    std::vector<CNetQuantized>& Add(uint32_t); ///< Add a snapshot.
+    const std::vector<CNetQuantized>* Find(uint32_t) const; ///< Find a snapshot.
+    void clear(); ///< Forget all snapshots.
+}; //CSnapshotRing
+
+/// \brief An axis-aligned rectangle in world coordinates.
+
+struct CNetRect{
+  float m_fLeft = 0; ///< Left edge.
+  float m_fBottom = 0; ///< Bottom edge.
+  float m_fRight = 0; ///< Right edge.
+  float m_fTop = 0; ///< Top edge.
+}; //CNetRect
+
+/// \brief Snapshot relevance filter.
+///
+/// Each client has one of these to decide which objects go into its
+/// snapshots. Objects in the client's view are always sent. Objects in a
+/// border around the view are sent now and then so that they are roughly
+/// right when they come into view. Each of them accumulates priority every
+/// snapshot, faster the nearer it is to the view, and the ones whose
+/// priority reaches 1 are sent, up to a budget per snapshot with the highest
+/// priority first, and have their priority reset. A border object that isn't
+/// sent keeps the state it had in the previous snapshot, which costs nothing
+/// once the client has acknowledged it. Objects further away are left out,
+/// so the client forgets them. The caller finds the objects in the border
+/// with a spatial query, so the cost of a snapshot depends on what the
+/// client can see, not on how many objects there are.
+
+class CSnapshotFilter{
+  private:
+    float m_fMargin = 256.0f; ///< Width of the border around the view.
+    size_t m_nBudget = 16; ///< Most border objects sent per snapshot.
+    float m_fMinRate = 0.1f; ///< Least priority gained per snapshot.
+
+    std::vector<std::pair<uint32_t, float>> m_vecPriority; ///< Border object priorities by identifier.
+    std::vector<std::pair<uint32_t, float>> m_vecNext; ///< Priorities buffer.
+    std::vector<CNetObject> m_vecSorted; ///< Objects sorted by identifier.
+    std::vector<CNetQuantized> m_vecQuantized; ///< Quantized objects buffer.
+    std::vector<std::pair<size_t, size_t>> m_vecDue; ///< Due border objects and their priority indices.
+    std::vector<uint8_t> m_vecSend; ///< Whether to send each object.
+
+  public:
+    CSnapshotFilter(float=256.0f, size_t=16); ///< Constructor.
+
+    const CNetRect GetBounds(const CNetRect&) const; ///< Get view and border.
+    void Select(const CSnapshotCodec&, const std::vector<CNetObject>&,
+      const CNetRect&, const std::vector<CNetQuantized>*,
+      std::vector<CNetQuantized>&); ///< Choose objects to send.
+    void clear(); ///< Forget priorities.
+}; //CSnapshotFilter
+
+#endif //__L4RC_GAME_SNAPSHOTCODEC_H__
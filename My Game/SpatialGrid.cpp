@@ -0,0 +1,153 @@
+/// \file SpatialGrid.cpp
+/// \brief Code for the uniform spatial grid CSpatialGrid.
+
+#include "SpatialGrid.h"
+#include "Object.h"
+
+/// Get the half-width of a square that contains an object's sprite at any
+/// orientation. The bounding circle radius is half of the larger sprite
+/// dimension, so scaling it by \f$\sqrt{2}\f$ covers the sprite's corners.
+/// \param pObj Pointer to an object.
+/// \return Half-width of the object's sprite bounds.
+
+const float CSpatialGrid::GetExtent(const CObject* pObj) const{
+  return 1.415f*pObj->m_fRadius;
+} //GetExtent
+
+/// Get the cell column containing a horizontal position, clamped to the grid.
+/// \param x Horizontal position.
+/// \return Cell column.
+
+const int CSpatialGrid::GetCellX(float x) const{
+  return std::min(std::max(0, (int)floorf(x/m_fCellSize)), m_nCellsWide - 1);
+} //GetCellX
+
+/// Get the cell row containing a vertical position, clamped to the grid.
+/// \param y Vertical position.
+/// \return Cell row.
+
+const int CSpatialGrid::GetCellY(float y) const{
+  return std::min(std::max(0, (int)floorf(y/m_fCellSize)), m_nCellsHigh - 1);
+} //GetCellY
+
+/// Rebuild the grid from an object list, skipping dead objects. Objects are
+/// bucketed by the cell containing their center, clamped to the grid, so
+/// that objects off the edge of the world land in the edge cells.
+/// \param objects Object list.
+/// \param size World width and height.
+
+void CSpatialGrid::Build(const std::list<CObject*>& objects, const Vector2& size){
+  m_nCellsWide = std::max(1, (int)ceilf(size.x/m_fCellSize));
+  m_nCellsHigh = std::max(1, (int)ceilf(size.y/m_fCellSize));
+
+  const size_t nCells = (size_t)m_nCellsWide*m_nCellsHigh; //number of cells
+
+  m_vecObjects.clear();
+  m_vecLarge.clear();
+  m_vecCellStart.assign(nCells + 1, 0);
+
+  for(CObject* p: objects)
+    if(!p->m_bDead)
+      m_vecObjects.push_back(p);
+
+  //count objects in each cell
+
+  for(UINT i=0; i<m_vecObjects.size(); i++){
+    const CObject* p = m_vecObjects[i]; //shorthand
+
+    if(GetExtent(p) > m_fCellSize) //too big for a cell
+      m_vecLarge.push_back(i);
+
+    else m_vecCellStart[GetCellY(p->m_vPos.y)*m_nCellsWide +
+      GetCellX(p->m_vPos.x) + 1]++;
+  } //for
+
+  //prefix sum gives start of each cell
+
+  for(size_t i=1; i<=nCells; i++)
+    m_vecCellStart[i] += m_vecCellStart[i - 1];
+
+  m_vecCellIndex.resize(m_vecCellStart[nCells]);
+
+  //place objects, using the cell start as a write cursor
+
+  for(UINT i=0; i<m_vecObjects.size(); i++){
+    const CObject* p = m_vecObjects[i]; //shorthand
+
+    if(GetExtent(p) <= m_fCellSize)
+      m_vecCellIndex[m_vecCellStart[GetCellY(p->m_vPos.y)*m_nCellsWide +
+        GetCellX(p->m_vPos.x)]++] = i;
+  } //for
+
+  //the write cursors have moved each start to the next cell's start
+
+  for(size_t i=nCells; i>0; i--)
+    m_vecCellStart[i] = m_vecCellStart[i - 1];
+
+  m_vecCellStart[0] = 0;
+} //Build
+
+/// Remove all objects from the grid. This must be done when the objects are
+/// deleted so that the grid isn't left holding dangling pointers.
+
+void CSpatialGrid::clear(){
+  m_vecObjects.clear();
+  m_vecCellIndex.clear();
+  m_vecLarge.clear();
+  m_vecCellStart.assign(m_vecCellStart.size(), 0);
+} //clear
+
+/// Find the objects whose sprite bounds overlap a rectangle. Since objects
+/// are bucketed by their center, the cells searched are those overlapping
+/// the rectangle grown by one cell on each side. Each object is reported at
+/// most once.
+/// \param lo Bottom left corner of rectangle.
+/// \param hi Top right corner of rectangle.
+/// \param result [out] Indices of the objects found are appended to this.
+
+void CSpatialGrid::Query(const Vector2& lo, const Vector2& hi,
+  std::vector<UINT>& result) const
+{
+  if(m_vecObjects.empty())return; //nothing to find
+
+  auto Overlaps = [&](UINT i){ //whether object i overlaps the rectangle
+    const CObject* p = m_vecObjects[i]; //shorthand
+    const float r = GetExtent(p); //half-width of sprite bounds
+
+    return p->m_vPos.x + r >= lo.x && p->m_vPos.x - r <= hi.x &&
+      p->m_vPos.y + r >= lo.y && p->m_vPos.y - r <= hi.y;
+  }; //Overlaps
+
+  const int x0 = GetCellX(lo.x - m_fCellSize);
+  const int x1 = GetCellX(hi.x + m_fCellSize);
+  const int y0 = GetCellY(lo.y - m_fCellSize);
+  const int y1 = GetCellY(hi.y + m_fCellSize);
+
+  for(int y=y0; y<=y1; y++)
+    for(int x=x0; x<=x1; x++){
+      const size_t n = (size_t)y*m_nCellsWide + x; //cell index
+
+      for(UINT j=m_vecCellStart[n]; j<m_vecCellStart[n + 1]; j++)
+        if(Overlaps(m_vecCellIndex[j]))
+          result.push_back(m_vecCellIndex[j]);
+    } //for
+
+  for(UINT i: m_vecLarge)
+    if(Overlaps(i))
+      result.push_back(i);
+} //Query
+
+/// Reader function for an object.
+/// \param i Index of object, as reported by `Query()`.
+/// \return Pointer to the object.
+
+CObject* CSpatialGrid::GetAt(UINT i) const{
+  return m_vecObjects[i];
+} //GetAt
+
+/// Reader function for the number of objects.
+/// \return Number of objects in the grid.
+
+const size_t CSpatialGrid::GetSize() const{
+  return m_vecObjects.size();
+} //GetSize
@@ -0,0 +1,51 @@
+/// \file SpatialGrid.h
+/// \brief Interface for the uniform spatial grid CSpatialGrid.
+
+#ifndef __L4RC_GAME_SPATIALGRID_H__
+#define __L4RC_GAME_SPATIALGRID_H__
+
+#include <list>
+#include <vector>
+
+#include "Common.h"
+
+class CObject;
+
+/// \brief A uniform spatial grid of objects.
+///
+/// The grid is rebuilt from the object list once per frame by a counting sort
+/// on the cell containing each object's center, so that the objects in each
+/// cell are contiguous in one array. Objects are referred to by their index
+/// in the object list at the time the grid was built, which means that
+/// sorting the results of a query puts them back into object list order.
+/// Objects whose sprites are larger than a cell are kept in a separate list
+/// and tested individually by every query.
+
+class CSpatialGrid:
+  public CCommon
+{
+  private:
+    const float m_fCellSize = 256.0f; ///< Width and height of a cell.
+
+    int m_nCellsWide = 0; ///< Number of cells wide.
+    int m_nCellsHigh = 0; ///< Number of cells high.
+
+    std::vector<CObject*> m_vecObjects; ///< Live objects in object list order.
+    std::vector<UINT> m_vecCellStart; ///< Start of each cell in m_vecCellIndex.
+    std::vector<UINT> m_vecCellIndex; ///< Object indices sorted by cell.
+    std::vector<UINT> m_vecLarge; ///< Indices of objects larger than a cell.
+
+    const float GetExtent(const CObject*) const; ///< Half-width of sprite bounds.
+    const int GetCellX(float) const; ///< Get cell column.
+    const int GetCellY(float) const; ///< Get cell row.
+
+  public:
+    void Build(const std::list<CObject*>&, const Vector2&); ///< Rebuild from object list.
+    void clear(); ///< Remove all objects.
+    void Query(const Vector2&, const Vector2&, std::vector<UINT>&) const; ///< Find objects in rectangle.
+
+    CObject* GetAt(UINT) const; ///< Get object by index.
+    const size_t GetSize() const; ///< Get number of objects.
+}; //CSpatialGrid
+
+#endif //__L4RC_GAME_SPATIALGRID_H__
@@ -0,0 +1,64 @@
+/// \file SpriteList.h
+/// \brief The list of sprites that the game loads.
+///
+/// Each `SPRITE(e, name)` entry ties the `eSprite` enumerator `e` from
+/// `GameDefines.h` to the name of its sprite tag in `gamesettings.xml`, in
+/// the order that the sprites are loaded. The first seven are the ones needed
+/// by the title and tutorial screens, plus the tile sprite, whose width is
+/// needed to set up the tile manager. This file is an X-macro list with no
+/// include guard: define `SPRITE` before including it and undefine it after.
+/// It has no other dependencies, so that tools such as AtlasBuilder can
+/// include it too.
+
+SPRITE(Tile,           "tile")
+SPRITE(Title,          "title")
+SPRITE(PlayButton,     "playbutton")
+SPRITE(PlayButton2,    "playbutton2")
+SPRITE(TutorialButton, "tutorialbutton")
+SPRITE(Title2,         "title2")
+SPRITE(BackButton,     "backbutton")
+SPRITE(Player,         "player")
+SPRITE(Bullet,         "bullet")
+SPRITE(Bullet2,        "bullet2")
+SPRITE(Smoke,          "smoke")
+SPRITE(Spark,          "spark")
+SPRITE(Turret,         "turret")
+SPRITE(Line,           "greenline")
+SPRITE(Activity,       "activity")
+SPRITE(House,          "house")
+SPRITE(Tree,           "tree")
+SPRITE(HealthBar,      "healthbar")
+SPRITE(HealthBar80,    "healthbar80")
+SPRITE(HealthBar60,    "healthbar60")
+SPRITE(HealthBar40,    "healthbar40")
+SPRITE(HealthBar20,    "healthbar20")
+SPRITE(HealthBar0,     "healthbar0")
+SPRITE(Player2,        "player2")
+SPRITE(Turret2,        "turret2")
+SPRITE(Frame,          "frame")
+SPRITE(Sun,            "sun")
+SPRITE(Moon,           "moon")
+SPRITE(Corn,           "corn")
+SPRITE(HalfCorn,       "halfcorn")
+SPRITE(Zombie2,        "zombie2")
+SPRITE(Battery,        "battery")
+SPRITE(Shop,           "shop")
+SPRITE(ProgressFrame,  "progressframe")
+SPRITE(Percent,        "percent")
+SPRITE(MessageFrame,   "messageframe")
+SPRITE(Background2,    "background")
+SPRITE(NightFarm,      "nightfarm")
+SPRITE(MaxFood,        "maxfood")
+SPRITE(LogicBoard,     "logicBoard")
+SPRITE(Antenna,        "antenna")
+SPRITE(DeadRadio,      "deadRadio")
+SPRITE(AliveRadio,     "aliveRadio")
+SPRITE(Victory,        "victory")
+SPRITE(PressToFarm,    "presstofarm")
+SPRITE(PressToEat,     "presstoeat")
+SPRITE(RadioParts,     "radioparts")
+SPRITE(PressToBuild,   "presstobuild")
+SPRITE(Radio,          "radio")
+SPRITE(Research,       "research")
+SPRITE(PressToLeave,   "presstoleave")
+SPRITE(Escape,         "escape")
@@ -0,0 +1,75 @@
+/// \file SpriteSizes.h
+/// \brief Sprite size table generated by AtlasBuilder. Do not edit.
+
+#ifndef __L4RC_GAME_SPRITESIZES_H__
+#define __L4RC_GAME_SPRITESIZES_H__
+
+#include "GameDefines.h"
+
+/// \brief Sprite size table entry.
+///
+/// The width and height in pixels of the first frame of a sprite, which
+/// are what the renderer reports for it once it is loaded.
+
+struct SpriteSize{
+  eSprite m_eSprite; ///< Sprite type.
+  UINT m_nWidth; ///< Width in pixels.
+  UINT m_nHeight; ///< Height in pixels.
+}; //SpriteSize
+
+static const SpriteSize SPRITE_SIZES[] = {
+  {eSprite::Tile, 32, 32},
+  {eSprite::Title, 1080, 1920},
+  {eSprite::PlayButton, 250, 600},
+  {eSprite::PlayButton2, 173, 599},
+  {eSprite::TutorialButton, 250, 600},
+  {eSprite::Title2, 1080, 1920},
+  {eSprite::BackButton, 105, 277},
+  {eSprite::Player, 43, 43},
+  {eSprite::Bullet, 8, 8},
+  {eSprite::Bullet2, 8, 8},
+  {eSprite::Smoke, 64, 64},
+  {eSprite::Spark, 64, 64},
+  {eSprite::Turret, 45, 45},
+  {eSprite::Line, 2, 2},
+  {eSprite::Activity, 250, 250},
+  {eSprite::House, 254, 299},
+  {eSprite::Tree, 70, 72},
+  {eSprite::HealthBar, 150, 32},
+  {eSprite::HealthBar80, 150, 32},
+  {eSprite::HealthBar60, 150, 32},
+  {eSprite::HealthBar40, 150, 32},
+  {eSprite::HealthBar20, 150, 32},
+  {eSprite::HealthBar0, 150, 32},
+  {eSprite::Player2, 43, 43},
+  {eSprite::Turret2, 83, 83},
+  {eSprite::Frame, 350, 40},
+  {eSprite::Sun, 50, 50},
+  {eSprite::Moon, 50, 50},
+  {eSprite::Corn, 50, 50},
+  {eSprite::HalfCorn, 50, 50},
+  {eSprite::Zombie2, 45, 45},
+  {eSprite::Battery, 32, 32},
+  {eSprite::Shop, 100, 80},
+  {eSprite::ProgressFrame, 152, 33},
+  {eSprite::Percent, 150, 32},
+  {eSprite::MessageFrame, 450, 300},
+  {eSprite::Background2, 1080, 1920},
+  {eSprite::NightFarm, 450, 300},
+  {eSprite::MaxFood, 450, 300},
+  {eSprite::LogicBoard, 32, 32},
+  {eSprite::Antenna, 32, 32},
+  {eSprite::DeadRadio, 100, 100},
+  {eSprite::AliveRadio, 100, 100},
+  {eSprite::Victory, 1080, 1920},
+  {eSprite::PressToFarm, 150, 32},
+  {eSprite::PressToEat, 150, 32},
+  {eSprite::RadioParts, 130, 40},
+  {eSprite::PressToBuild, 150, 32},
+  {eSprite::Radio, 32, 32},
+  {eSprite::Research, 81, 205},
+  {eSprite::PressToLeave, 150, 32},
+  {eSprite::Escape, 450, 300},
+}; //SPRITE_SIZES
+
+#endif //__L4RC_GAME_SPRITESIZES_H__
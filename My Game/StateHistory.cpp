@@ -0,0 +1,198 @@
+/// \file StateHistory.cpp
+/// \brief Code for the state history CStateHistory.
+
+#include "StateHistory.h"
+
+#include <algorithm>
+
+/// Append an unsigned integer to a buffer seven bits at a time, low bits
+/// first, with the top bit of each byte set if more bytes follow.
+/// \param n Integer.
+/// \param out [out] Buffer.
+
+static void PutVarInt(size_t n, std::vector<unsigned char>& out){
+  while(n >= 0x80){
+    out.push_back((unsigned char)(n | 0x80));
+    n >>= 7;
+  } //while
+
+  out.push_back((unsigned char)n);
+} //PutVarInt
+
+/// Read an unsigned integer written by `PutVarInt()`.
+/// \param p [in, out] Pointer to the first byte, advanced past the integer.
+/// \return The integer.
+
+static size_t GetVarInt(const unsigned char*& p){
+  size_t n = 0; //result
+  size_t shift = 0; //bits read so far
+
+  while(*p & 0x80){
+    n |= (size_t)(*p++ & 0x7F) << shift;
+    shift += 7;
+  } //while
+
+  return n | (size_t)*p++ << shift;
+} //GetVarInt
+
+/// Constructor.
+/// \param n Number of ticks to keep.
+
+CStateHistory::CStateHistory(size_t n):
+  m_vecRing(n > 0? n: 1){
+} //constructor
+
+/// Encode a state as the XOR of it with a base state, as alternating runs of
+/// zero bytes and literal bytes. The base is treated as padded with zeros if
+/// it is shorter than the state. A literal run ends at the first run of
+/// several zeros, since a shorter zero run costs more to encode than to copy.
+/// \param base Pointer to base state.
+/// \param nBase Size of base state.
+/// \param p Pointer to state.
+/// \param n Size of state.
+/// \param out [out] Encoded state.
+
+void CStateHistory::Encode(const char* base, size_t nBase, const char* p,
+  size_t n, std::vector<unsigned char>& out) const
+{
+  auto Xor = [&](size_t i){ //byte i of the delta
+    return (unsigned char)(i < nBase? p[i] ^ base[i]: p[i]);
+  }; //Xor
+
+  const size_t nMinZeros = 4; //shortest zero run that ends a literal run
+
+  out.clear();
+
+  for(size_t i=0; i<n;){
+    const size_t zeros = i; //start of zero run
+    while(i < n && Xor(i) == 0)i++;
+
+    const size_t literals = i; //start of literal run
+    size_t z = 0; //length of zero run inside literal run
+
+    for(; i<n && z<nMinZeros; i++)
+      z = Xor(i) == 0? z + 1: 0;
+
+    i -= z; //give back the trailing zeros
+
+    PutVarInt(literals - zeros, out);
+    PutVarInt(i - literals, out);
+
+    for(size_t j=literals; j<i; j++)
+      out.push_back(Xor(j));
+  } //for
+} //Encode
+
+/// Decode a tick. A keyframe is decoded from nothing, and a delta is decoded
+/// from the state of the tick before it.
+/// \param t Encoded tick.
+/// \param state [in, out] State of the tick before, replaced by this one.
+
+void CStateHistory::Decode(const CTick& t, std::vector<char>& state) const{
+  if(t.m_bKeyframe)
+    state.assign(t.m_nSize, 0);
+  else state.resize(t.m_nSize, 0);
+
+  const unsigned char* p = t.m_vecData.data(); //read cursor
+  const unsigned char* end = p + t.m_vecData.size(); //end of encoded tick
+  size_t i = 0; //write cursor
+
+  while(p < end){
+    i += GetVarInt(p);
+    const size_t n = GetVarInt(p); //number of literal bytes
+
+    for(size_t j=0; j<n; j++)
+      state[i++] ^= (char)*p++;
+  } //while
+} //Decode
+
+/// Record the state for a tick, overwriting the oldest tick if the ring is
+/// full.
+/// \param p Pointer to state.
+/// \param n Size of state.
+
+void CStateHistory::Record(const char* p, size_t n){
+  const bool bKey = m_nCount == 0 ||
+    m_nSinceKey + 1 >= std::min(m_nKeyInterval, m_vecRing.size());
+
+  if(m_nCount > 0)
+    m_nNewest = (m_nNewest + 1)%m_vecRing.size();
+
+  m_nCount = std::min(m_nCount + 1, m_vecRing.size());
+  m_nSinceKey = bKey? 0: m_nSinceKey + 1;
+
+  CTick& t = m_vecRing[m_nNewest]; //shorthand
+  t.m_nSize = n;
+  t.m_bKeyframe = bKey;
+
+  if(bKey)Encode(nullptr, 0, p, n, t.m_vecData);
+  else Encode(m_vecNewest.data(), m_vecNewest.size(), p, n, t.m_vecData);
+
+  m_vecNewest.assign(p, p + n);
+} //Record
+
+/// Go back some ticks. The state that many ticks before the newest one is
+/// decoded from the keyframe before it, and the ticks after it are
+/// forgotten, so that recording carries on from there.
+/// \param n Number of ticks to go back.
+/// \param state [out] State of the tick gone back to.
+/// \return true if the history goes back that far.
+
+const bool CStateHistory::Rewind(size_t n, std::vector<char>& state){
+  if(n > GetMaxRewind())return false; //too far
+
+  const size_t size = m_vecRing.size(); //ring size
+  const size_t target = (m_nNewest + size - n)%size; //ring index of target tick
+  size_t i = target; //ring index of keyframe
+  size_t since = 0; //ticks from keyframe to target
+
+  for(; !m_vecRing[i].m_bKeyframe; since++)
+    i = (i + size - 1)%size;
+
+  for(size_t j=0; j<=since; j++)
+    Decode(m_vecRing[(i + j)%size], state);
+
+  m_nNewest = target;
+  m_nCount -= n;
+  m_nSinceKey = since;
+  m_vecNewest = state;
+
+  return true;
+} //Rewind
+
+/// Forget all ticks, which must be done when the level changes.
+
+void CStateHistory::clear(){
+  m_nNewest = m_nCount = m_nSinceKey = 0;
+  m_vecNewest.clear();
+} //clear
+
+/// Get the number of ticks that we can go back from the newest. Ticks older
+/// than the oldest keyframe in the ring can't be decoded, since the
+/// keyframe they depend on has been overwritten.
+/// \return Number of ticks that can be gone back.
+
+const size_t CStateHistory::GetMaxRewind() const{
+  if(m_nCount == 0)return 0; //nothing recorded
+
+  const size_t size = m_vecRing.size(); //ring size
+  size_t i = (m_nNewest + size + 1 - m_nCount)%size; //ring index of oldest tick
+  size_t n = m_nCount - 1; //ticks from oldest to newest
+
+  for(; !m_vecRing[i].m_bKeyframe; n--)
+    i = (i + 1)%size;
+
+  return n;
+} //GetMaxRewind
+
+/// Get the total size of the encoded ticks.
+/// \return Size in bytes.
+
+const size_t CStateHistory::GetMemory() const{
+  size_t n = 0; //result
+
+  for(const CTick& t: m_vecRing)
+    n += t.m_vecData.size();
+
+  return n;
+} //GetMemory
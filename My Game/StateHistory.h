@@ -0,0 +1,55 @@
+/// \file StateHistory.h
+/// \brief Interface for the state history CStateHistory.
+
+#ifndef __L4RC_GAME_STATEHISTORY_H__
+#define __L4RC_GAME_STATEHISTORY_H__
+
+#include <cstddef>
+#include <vector>
+
+/// \brief A ring buffer of recent simulation states.
+///
+/// A state is an opaque string of bytes recorded once per simulation tick.
+/// Most ticks are stored as a delta against the previous tick, which is the
+/// two states XORed together. Since little changes in one tick this is mostly
+/// zero bytes, so it is stored as alternating runs of zeros and literal
+/// bytes. Every `m_nKeyInterval` ticks a keyframe is stored instead, which is
+/// the state encoded against nothing, so that going back to a tick only
+/// decodes the deltas since the keyframe before it. The encoded buffers are
+/// reused as the ring wraps around, so recording doesn't allocate memory once
+/// the ring is full.
+
+class CStateHistory{
+  private:
+    /// \brief An encoded tick.
+
+    struct CTick{
+      std::vector<unsigned char> m_vecData; ///< Encoded state.
+      size_t m_nSize = 0; ///< Size of decoded state.
+      bool m_bKeyframe = false; ///< Encoded against nothing.
+    }; //CTick
+
+    std::vector<CTick> m_vecRing; ///< Encoded ticks.
+    size_t m_nNewest = 0; ///< Ring index of newest tick.
+    size_t m_nCount = 0; ///< Number of ticks in the ring.
+    size_t m_nSinceKey = 0; ///< Number of ticks since the newest keyframe.
+    const size_t m_nKeyInterval = 30; ///< Ticks between keyframes.
+
+    std::vector<char> m_vecNewest; ///< Newest state, decoded.
+
+    void Encode(const char*, size_t, const char*, size_t,
+      std::vector<unsigned char>&) const; ///< Encode a state.
+    void Decode(const CTick&, std::vector<char>&) const; ///< Decode a state.
+
+  public:
+    CStateHistory(size_t); ///< Constructor.
+
+    void Record(const char*, size_t); ///< Record a tick.
+    const bool Rewind(size_t, std::vector<char>&); ///< Go back some ticks.
+    void clear(); ///< Forget all ticks.
+
+    const size_t GetMaxRewind() const; ///< Get how far back we can go.
+    const size_t GetMemory() const; ///< Get size of encoded ticks.
+}; //CStateHistory
+
+#endif //__L4RC_GAME_STATEHISTORY_H__
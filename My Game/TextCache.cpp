@@ -0,0 +1,133 @@
+/// \file TextCache.cpp
+/// \brief Code for the text cache CTextCache.
+
+#include "TextCache.h"
+#include "AssetPack.h"
+#include "Abort.h"
+
+#include <algorithm>
+#include <cstring>
+
+/// Read the glyph metrics from a sprite font file. A sprite font file starts
+/// with an 8-character signature and a glyph count, followed by one record
+/// per glyph containing the character code, the glyph's rectangle in the font
+/// texture, and its horizontal offset, vertical offset, and horizontal
+/// advance. Characters that are not in the font use the metrics of the
+/// font's default character. The rest of the file, which is the font texture,
+/// is not needed. The font file comes from the asset pack if it is there.
+/// \param filename Name of the sprite font file.
+
+void CTextCache::Load(const char* filename){
+  std::vector<char> storage; //buffer for a font that isn't in the pack
+  const char* p = nullptr; //font file contents
+  size_t size = 0; //font file size in bytes
+
+  if(!m_pAssetPack->Load(filename, p, size, storage)) //abort if it's missing
+    ABORT("Font %s not found.", filename); //panic
+
+  const char* const end = p + size; //end of font file
+
+  auto Read = [&](void* dest, size_t n){ //read n bytes, if there are that many
+    if((size_t)(end - p) < n)return false;
+    memcpy(dest, p, n);
+    p += n;
+    return true;
+  }; //Read
+
+  char signature[8]; //file signature
+  UINT n = 0; //number of glyphs
+
+  if(!Read(signature, 8) || memcmp(signature, "DXTKfont", 8) ||
+     !Read(&n, sizeof(UINT)))
+    ABORT("Font %s is not a sprite font.", filename); //panic
+
+  #pragma pack(push, 4)
+  struct{ //glyph record
+    UINT m_nChar; //character code
+    int m_nLeft, m_nTop, m_nRight, m_nBottom; //rectangle in font texture
+    float m_fXOffset, m_fYOffset, m_fXAdvance; //metrics
+  } glyph;
+  #pragma pack(pop)
+
+  bool bDefined[256] = {false}; //whether each character is in the font
+
+  for(UINT i=0; i<n; i++){
+    if(!Read(&glyph, sizeof(glyph)))
+      ABORT("Font %s is truncated.", filename); //panic
+
+    if(glyph.m_nChar < 256){
+      const UINT c = glyph.m_nChar; //shorthand
+      m_fWidth[c] = (float)(glyph.m_nRight - glyph.m_nLeft);
+      m_fOffset[c] = glyph.m_fXOffset;
+      m_fAdvance[c] = glyph.m_fXAdvance;
+      bDefined[c] = true;
+    } //if
+  } //for
+
+  float fLineSpacing = 0; //line spacing, unused
+  UINT nDefault = 0; //default character
+
+  Read(&fLineSpacing, sizeof(float));
+  Read(&nDefault, sizeof(UINT));
+
+  if(nDefault < 256 && bDefined[nDefault])
+    for(UINT c=0; c<256; c++)
+      if(!bDefined[c]){
+        m_fWidth[c] = m_fWidth[nDefault];
+        m_fOffset[c] = m_fOffset[nDefault];
+        m_fAdvance[c] = m_fAdvance[nDefault];
+      } //if
+
+  m_mapWidth.clear();
+} //Load
+
+/// Measure the width of a single line of text, following the glyph layout
+/// used by the renderer.
+/// \param s A string.
+/// \return Width of the string in pixels.
+
+const float CTextCache::Measure(const std::string& s) const{
+  float x = 0; //current position
+  float w = 0; //width so far
+
+  for(const char ch: s){
+    const UINT c = (unsigned char)ch; //character code
+    x = std::max(0.0f, x + m_fOffset[c]);
+    w = std::max(w, x + m_fWidth[c]);
+    x += m_fWidth[c] + m_fAdvance[c];
+  } //for
+
+  return w;
+} //Measure
+
+/// Get the width of a string, measuring it only the first time. Strings
+/// that change over time, such as the clock, would make the cache grow
+/// without bound, so it is emptied when it gets large.
+/// \param s A string.
+/// \return Width of the string in pixels.
+
+const float CTextCache::GetWidth(const std::string& s){
+  const auto it = m_mapWidth.find(s); //look in the cache
+
+  if(it != m_mapWidth.end())
+    return it->second;
+
+  if(m_mapWidth.size() >= m_nMaxCached) //cache is full
+    m_mapWidth.clear();
+
+  const float w = Measure(s); //not in the cache, so measure it
+  m_mapWidth[s] = w;
+  return w;
+} //GetWidth
+
+/// Get the screen position at which to draw a string so that it is
+/// centered horizontally on a point.
+/// \param s A string.
+/// \param center Screen position of the center of the top of the string.
+/// \return Screen position of the top left of the string.
+
+const Vector2 CTextCache::GetCenteredPos(const std::string& s,
+  const Vector2& center)
+{
+  return Vector2(center.x - GetWidth(s)/2, center.y);
+} //GetCenteredPos
@@ -0,0 +1,40 @@
+/// \file TextCache.h
+/// \brief Interface for the text cache CTextCache.
+
+#ifndef __L4RC_GAME_TEXTCACHE_H__
+#define __L4RC_GAME_TEXTCACHE_H__
+
+#include <string>
+#include <unordered_map>
+
+#include "Common.h"
+
+/// \brief The text cache.
+///
+/// The text cache reads the glyph metrics from the sprite font file that the
+/// renderer uses for screen text, and uses them to measure the width of a
+/// string in pixels the same way that the renderer lays it out. The width of
+/// each distinct string is measured once and cached, so that text can be
+/// centered without measuring it every frame.
+
+class CTextCache:
+  public CCommon
+{
+  private:
+    float m_fWidth[256] = {0}; ///< Glyph widths.
+    float m_fOffset[256] = {0}; ///< Glyph horizontal offsets.
+    float m_fAdvance[256] = {0}; ///< Glyph advances after the glyph width.
+
+    std::unordered_map<std::string, float> m_mapWidth; ///< Cached string widths.
+    const size_t m_nMaxCached = 1024; ///< Maximum number of cached widths.
+
+    const float Measure(const std::string&) const; ///< Measure a string.
+
+  public:
+    void Load(const char*); ///< Load glyph metrics from sprite font.
+
+    const float GetWidth(const std::string&); ///< Get width of string.
+    const Vector2 GetCenteredPos(const std::string&, const Vector2&); ///< Get position to center string.
+}; //CTextCache
+
+#endif //__L4RC_GAME_TEXTCACHE_H__
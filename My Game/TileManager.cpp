@@ -3,22 +3,62 @@
 
 #include "TileManager.h"
 #include "SpriteRenderer.h"
+#include "DrawList.h"
+#include "AssetPack.h"
 #include "Abort.h"
+#include "AllocTracker.h"
+#include "Log.h"
+#include "Helpers.h"
+#include "World.h"
 #define STBI_ASSERT(x)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#include <iostream>
 #include "Game.h"
+#include <sstream>
+#include <cstring>
 
 /// Construct a tile manager using square tiles, given the width and height
+/// of each tile.
+/// \param pWorld Pointer to the world the tile manager is part of, or
+/// `nullptr` if it only reads maps for another tile manager to swap in.
+/// \param n Tile width and height in pixels.
+/// \param pGame Pointer to the game that tells the time, or `nullptr`.
+
+CTileManager::CTileManager(CWorld* pWorld, size_t n, CGame* pGame):
+  CCommon(pWorld), m_pGame(pGame), m_fTileSize((float)n){
+} //constructor
 
 /// Delete the memory used for storing the map.
 CTileManager::~CTileManager(){
-  for(size_t i=0; i<m_nHeight; i++)
-    delete [] m_chMap[i];
+  FreeMap();
+} //destructor
+
+/// Allocate the map, deleting the old one first. The tiles are in a single
+/// block with the rows one after the other, and the row pointers point into
+/// it, so a map is two allocations however many rows it has.
+/// \param w Width in tiles.
+/// \param h Height in tiles.
+
+void CTileManager::AllocMap(size_t w, size_t h){
+  FreeMap();
+
+  const CAllocScope scope(eAlloc::Map); //charge to the map
+  m_chMap = new char*[std::max<size_t>(h, 1)]; //row 0 holds the block even if empty
+  m_chMap[0] = new char[w*h];
+
+  for(size_t i=1; i<h; i++)
+    m_chMap[i] = m_chMap[0] + i*w;
+} //AllocMap
 
+/// Delete the map, if there is one.
+
+void CTileManager::FreeMap(){
+  if(m_chMap == nullptr)return; //nothing to delete
+
+  delete [] m_chMap[0];
   delete [] m_chMap;
-} //destructor
+  m_chMap = nullptr;
+} //FreeMap
 
 /// Make the AABBs for the walls. Care is taken to use the longest horizontal
 /// and vertical AABBs possible so that there aren't so many of them.
@@ -28,11 +68,7 @@ void CTileManager::LoadMapFromImageFile(char* filename) {
     m_vecTrees.clear(); //clear trees from previous level
 
 
-    if (m_chMap != nullptr) { //unload any previous maps
-        for (int i = 0; i < m_nHeight; i++)
-            delete[] m_chMap[i];
-        delete[] m_chMap;
-    } //if
+    FreeMap(); //unload any previous maps
 
     //read map file into a byte buffer 
 
@@ -43,10 +79,7 @@ void CTileManager::LoadMapFromImageFile(char* filename) {
 
     //allocate space for the map 
 
-    m_chMap = new char* [m_nHeight];
-
-    for (int i = 0; i < m_nHeight; i++)
-        m_chMap[i] = new char[m_nWidth];
+    AllocMap(m_nWidth, m_nHeight);
 
     //load the map information from the buffer to the map
 
@@ -63,8 +96,9 @@ void CTileManager::LoadMapFromImageFile(char* filename) {
 
       //finish up
 
-    m_vWorldSize = Vector2((float)m_nWidth, (float)m_nHeight) * m_fTileSize;
+    m_pWorld->m_vWorldSize = Vector2((float)m_nWidth, (float)m_nHeight) * m_fTileSize;
     MakeBoundingBoxes();
+    m_vecChunks.clear(); //rebuilt on next draw
 
     stbi_image_free(buffer);
 } //LoadMapFromImageFile
@@ -180,37 +214,12 @@ void CTileManager::MakeBoundingBoxes(){
   } //for
 } //MakeBoundingBoxes
 
-/// Delete the old map (if any), allocate the right sized chunk of memory for
-/// the new map, and read it from a text file.
-/// \param filename Name of the map file.
-
-void CTileManager::LoadMap(char* filename){
-  if(m_chMap != nullptr){ //unload any previous maps
-    for(size_t i=0; i<m_nHeight; i++)
-      delete [] m_chMap[i];
-
-    delete [] m_chMap;
-  } //if
-
-  m_vecTurrets.clear(); //clear out the turret list
-  m_vecTrees.clear(); //clear out the tree list
-
-  FILE *input; //input file handle
-
-  fopen_s(&input, filename, "rb"); //open the map file
-  if(input == nullptr) //abort if it's missing
-    ABORT("Map &s not found.", filename); //panic
-
-  //read map file into a character buffer 
-
-  fseek(input, 0, SEEK_END); //seek to end of map file
-  const size_t n = ftell(input); //get file size in bytes
-  rewind(input); //seek to start of file
-
-  char *buffer = new char[n + 1]; //temporary character buffer
-  fread(buffer, n, 1, input); //read the whole thing in a chunk
-  fclose(input); //close the map file, we're done with it
+/// Parse a map file. Allocate the right sized chunk of memory for the map,
+/// fill it from the text, and record the positions of the objects in it.
+/// \param buffer Map file contents.
+/// \param n Map file size in bytes.
 
+void CTileManager::ParseMap(const char* buffer, size_t n){
   //get map width and height into m_nWidth and m_nHeight
 
   m_nWidth = 0; 
@@ -236,10 +245,7 @@ void CTileManager::LoadMap(char* filename){
 
   //allocate space for the map 
   
-  m_chMap = new char*[m_nHeight];
-
-  for(size_t i=0; i<m_nHeight; i++)
-    m_chMap[i] = new char[m_nWidth];
+  AllocMap(m_nWidth, m_nHeight);
 
   //load the map information from the buffer to the map
 
@@ -292,12 +298,131 @@ void CTileManager::LoadMap(char* filename){
 
     index++; //skip end of line character
   } //for
+} //ParseMap
 
-  m_vWorldSize = Vector2((float)m_nWidth + 1, (float)m_nHeight)*m_fTileSize;
-  MakeBoundingBoxes();
-  delete [] buffer; //clean up
+/// Load a map and make it the current level.
+/// \param filename Name of the map file.
+
+void CTileManager::LoadMap(const char* filename){
+  ReadMap(filename);
+  Activate();
 } //LoadMap
 
+/// Delete the old map (if any) and load a new one from a text file in the
+/// asset pack or on disk, along with its walls, object positions, and trigger
+/// volumes. This touches nothing outside this tile manager, so it can be run
+/// on a worker thread for a tile manager that isn't the one being drawn.
+/// \param filename Name of the map file.
+
+void CTileManager::ReadMap(const char* filename){
+  const CAllocScope scope(eAlloc::Map); //charge level data to the map
+  FreeMap(); //unload any previous maps
+
+  m_vecTurrets.clear(); //clear out the turret list
+  m_vecZombies.clear(); //clear out the zombie list
+  m_vecTrees.clear(); //clear out the tree list
+
+  //get the map file from the asset pack, or read it into a character buffer
+
+  std::vector<char> storage; //buffer for a map that isn't in the pack
+  const char* buffer = nullptr; //map file contents
+  size_t n = 0; //map file size in bytes
+
+  if(!m_pAssetPack->Load(filename, buffer, n, storage)) //abort if it's missing
+    ABORT("Map %s not found.", filename); //panic
+
+  ParseMap(buffer, n);
+  MakeBoundingBoxes();
+  LoadTriggers(filename);
+} //ReadMap
+
+/// Make the map read by `ReadMap()` the current level by setting the world
+/// size to match it and dropping the tile chunks for the old map.
+
+void CTileManager::Activate(){
+  m_pWorld->m_vWorldSize = Vector2((float)m_nWidth + 1, (float)m_nHeight)*m_fTileSize;
+  m_vecChunks.clear(); //rebuilt on next draw
+} //Activate
+
+/// Exchange level data with another tile manager and make the result the
+/// current level. This is how a map prefetched into another tile manager is
+/// put into play without any parsing or disk access.
+/// \param other Tile manager to swap with.
+
+void CTileManager::Swap(CTileManager& other){
+  std::swap(m_nWidth, other.m_nWidth);
+  std::swap(m_nHeight, other.m_nHeight);
+  std::swap(m_chMap, other.m_chMap);
+  std::swap(m_vecWalls, other.m_vecWalls);
+  std::swap(m_vecTurrets, other.m_vecTurrets);
+  std::swap(m_vecZombies, other.m_vecZombies);
+  std::swap(m_vecTrees, other.m_vecTrees);
+  std::swap(m_vecTriggers, other.m_vecTriggers);
+  std::swap(m_vPlayer, other.m_vPlayer);
+  std::swap(m_vActivity, other.m_vActivity);
+  std::swap(m_vHouse, other.m_vHouse);
+  std::swap(m_vShop, other.m_vShop);
+  std::swap(m_vRadioTower, other.m_vRadioTower);
+
+  Activate();
+  other.m_vecChunks.clear();
+} //Swap
+
+/// Load the trigger volumes for a map from its zone file, which has the same
+/// name as the map file but with the extension `.zones`. Each line of a zone
+/// file has a trigger name from `eTrigger` followed by the left, bottom,
+/// right, and top of its rectangle in world coordinates. Lines starting with
+/// `#` are comments. A map without a zone file of its own gets the ones in
+/// `default.zones` in the same folder, and if that isn't there either then
+/// it has no trigger volumes. Like the map, the zone file comes from the
+/// asset pack if it is there.
+/// \param filename Name of the map file.
+
+void CTileManager::LoadTriggers(const char* filename){
+  static const char* names[(UINT)eTrigger::Size] = {
+    "Farm", "Workbench", "Exit"
+  }; //trigger names, in the same order as eTrigger
+
+  m_vecTriggers.clear(); //clear out the trigger list
+
+  std::string zonefile(filename); //zone file name
+  const size_t dot = zonefile.find_last_of('.'); //start of extension
+  zonefile = zonefile.substr(0, dot) + ".zones";
+
+  std::vector<char> storage; //buffer for a zone file that isn't in the pack
+  const char* p = nullptr; //zone file contents
+  size_t n = 0; //zone file size in bytes
+
+  if(!m_pAssetPack->Load(zonefile.c_str(), p, n, storage)){ //no zone file for this map
+    const size_t slash = zonefile.find_last_of("\\/"); //end of folder
+    zonefile = zonefile.substr(0, slash + 1) + "default.zones";
+    if(!m_pAssetPack->Load(zonefile.c_str(), p, n, storage))return; //no default either
+  } //if
+
+  std::istringstream input(std::string(p, n)); //input stream
+
+  std::string name; //trigger name
+
+  while(input >> name){
+    if(name[0] == '#'){ //comment
+      std::getline(input, name); //skip rest of line
+      continue;
+    } //if
+
+    CTriggerVolume v; //trigger volume
+    input >> v.m_vLo.x >> v.m_vLo.y >> v.m_vHi.x >> v.m_vHi.y;
+
+    UINT i = 0; //index into trigger names
+    while(i < (UINT)eTrigger::Size && strcmp(names[i], name.c_str()))i++;
+
+    if(i == (UINT)eTrigger::Size || input.fail())
+      ABORT("Bad zone %s in %s.", name.c_str(), zonefile.c_str());
+
+    v.m_eType = (eTrigger)i;
+    m_vecTriggers.push_back(v);
+  } //while
+} //LoadTriggers
+
 /// Get positions of objects listed on map.
 /// \param turrets [out] Vector of turret positions
 /// \param player [out] Player position.
@@ -313,19 +438,55 @@ void CTileManager::GetObjects(std::vector<Vector2>& turrets, Vector2& player, Ve
   radiotower = m_vRadioTower;
 } //GetObjects
 
+/// Get the trigger volumes for the current map.
+/// \param triggers [out] Vector of trigger volumes.
+
+void CTileManager::GetTriggers(std::vector<CTriggerVolume>& triggers) const{
+  triggers = m_vecTriggers;
+} //GetTriggers
+
 /// This is for debug purposes so that you can verify that
-/// the collision shapes are in the right places.
+/// the collision shapes are in the right places. Only the bounding boxes
+/// that overlap the view rectangle are drawn.
 /// \param t Line sprite to be stretched to draw the line.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+/// \param drawn [in, out] Incremented for each bounding box drawn.
+/// \param culled [in, out] Incremented for each bounding box not drawn.
 
-void CTileManager::DrawBoundingBoxes(eSprite t){
+void CTileManager::DrawBoundingBoxes(eSprite t, const Vector2& lo,
+  const Vector2& hi, size_t& drawn, size_t& culled)
+{
   for(auto& p: m_vecWalls)
-    m_pRenderer->DrawBoundingBox(t, p);
+    if(p.Center.x + p.Extents.x >= lo.x && p.Center.x - p.Extents.x <= hi.x &&
+       p.Center.y + p.Extents.y >= lo.y && p.Center.y - p.Extents.y <= hi.y)
+    {
+      m_pRenderer->DrawBoundingBox(t, p);
+      drawn++;
+    } //if
+
+    else culled++;
 } //DrawBoundingBoxes
 
-/// Draw order is top-down, left-to-right so that the image
-/// agrees with the map text file viewed in NotePad.
-/// \param t Sprite type for a 3-frame sprite: 0 is floor, 1 is wall, 2 is an error tile.
- 
+/// Get the rectangle of the world that is visible in the window, which is
+/// the window centered on the camera.
+/// \param lo [out] Bottom left corner of view rectangle.
+/// \param hi [out] Top right corner of view rectangle.
+
+void CTileManager::GetViewRect(Vector2& lo, Vector2& hi) const{
+  const Vector2 campos = m_pRenderer->GetCameraPos(); //camera position
+  const Vector2 half(m_nWinWidth/2.0f, m_nWinHeight/2.0f); //half window size
+
+  lo = campos - half;
+  hi = campos + half;
+} //GetViewRect
+
+/// Linear interpolation between two colors.
+/// \param start Color when factor is 0.
+/// \param end Color when factor is 1.
+/// \param factor Interpolation factor.
+/// \return Interpolated color.
+
 XMFLOAT4 CTileManager::lerp(XMFLOAT4 start, XMFLOAT4 end, float factor) {
     return XMFLOAT4(
         start.x + factor * (end.x - start.x),
@@ -335,94 +496,134 @@ XMFLOAT4 CTileManager::lerp(XMFLOAT4 start, XMFLOAT4 end, float factor) {
     );
 }
 
-void CTileManager::Draw(eSprite t) {
-    LSpriteDesc2D desc; //sprite descriptor for tile
-    desc.m_nSpriteIndex = (UINT)t; //sprite index for tile
-
-    XMFLOAT4 dayColor = XMFLOAT4(Colors::White);
-    XMFLOAT4 nightColor = XMFLOAT4(Colors::DarkCyan);
-
-    // Get the current game time
-    int gameHours = m_pGame->GetGameHours();
-    std::string am_pm = m_pGame->getAmPm();
-
-    float lerpFactor = 0.0f;
-    if (gameHours == 12 && am_pm == "AM") {
-        // Transition from day to night from 5PM to 6PM
-        lerpFactor = 1.0f;
-    }
-    else if ((am_pm == "PM" && gameHours < 5) || (am_pm == "AM" && gameHours >= 6)) {
-        // Full day from 6AM to 5PM
-        lerpFactor = 0.0f;
-    }
-    else if (gameHours == 12 && am_pm == "PM") {
-		// Transition from day to night from 5PM to 6PM
-		lerpFactor = 0.0f;
-	}
-    else if (am_pm == "PM" && gameHours == 5) {
-        // Transition from day to night from 5PM to 6PM
-        lerpFactor = 0.5f;
-    }
-    else if ((am_pm == "PM" && gameHours > 5) || (am_pm == "AM" && gameHours < 5)) {
-        // Full night from 6PM to 5AM
-        lerpFactor = 1.0f;
-    }
-    else if (am_pm == "AM" && gameHours == 5) {
-        // Transition from night to day from 5AM to 6AM
-        lerpFactor = 0.5f;
-    }
-
-    // Interpolate the tint color using the lerpFactor
-    desc.m_f4Tint = lerp(dayColor, nightColor, lerpFactor);
-
-    const Vector2 campos = m_pRenderer->GetCameraPos(); //camera position
-
-    // Calculate camera's corresponding tile indices
-    const int camTileX = (int)(campos.x / m_fTileSize);
-    const int camTileY = (int)(m_nHeight - (campos.y / m_fTileSize));
-
-    // Calculate the number of tiles across half the screen width/height
-    const int tilesAcrossHalfWidth = (m_nWinWidth / 2) / m_fTileSize + 1; // +1 to ensure we capture edge tiles
-    const int tilesAcrossHalfHeight = (m_nWinHeight / 2) / m_fTileSize + 1; // +1 to ensure we capture edge tiles
-
-    // Determine visible tile range based on camera position
-    const int left = std::max(0, camTileX - tilesAcrossHalfWidth);
-    const int right = std::min(static_cast<int>(m_nWidth) - 2, camTileX + tilesAcrossHalfWidth);
-    const int topTileIndex = std::max(0, camTileY - tilesAcrossHalfHeight);
-    const int bottomTileIndex = std::min(static_cast<int>(m_nHeight) - 1, camTileY + tilesAcrossHalfHeight);
-
-    // Print out the values for verification
-    //std::cout << "camTileX: " << camTileX << std::endl;
-    //std::cout << "tilesAcrossHalfWidth: " << tilesAcrossHalfWidth << std::endl;
-    //std::cout << "camTileX + tilesAcrossHalfWidth: " << camTileX + tilesAcrossHalfWidth << std::endl;
-
-    for (int i = topTileIndex; i <= bottomTileIndex; i++) //for each column
-        for (int j = left; j <= right; j++) { //for each row
-            desc.m_vPos.x = (j + 0.5f) * m_fTileSize; //horizontal component of tile position
-            desc.m_vPos.y = (m_nHeight - 1 - i + 0.5f) * m_fTileSize; //vertical component of tile position
-
-            switch (m_chMap[i][j]) { //select which frame of the tile sprite is to be drawn
-            case 'F': desc.m_nCurrentFrame = 0; break; //green floor
-            case 'T': desc.m_nCurrentFrame = 3; break; //green floor
-            case 'W': desc.m_nCurrentFrame = 1; break; //wall
-            case 'G': desc.m_nCurrentFrame = 3; break; //grass
-            case 'R': desc.m_nCurrentFrame = 4; break; //road
-            case 'E': desc.m_nCurrentFrame = 3; break; //road
-            case 'A': desc.m_nCurrentFrame = 5; break; //road
-            case 'Z': desc.m_nCurrentFrame = 3; break; //Zombie2
-            case 'S': desc.m_nCurrentFrame = 3; break; //Shop
-            case 'H': desc.m_nCurrentFrame = 3; break; //Shop
-            default:
-                std::cout << "Unexpected tile character: " << m_chMap[i][j] << " at [" << i << "][" << j << "]" << std::endl;
-                desc.m_nCurrentFrame = 2;
-                break;
-            } //switch
-
-
-            m_pRenderer->Draw(&desc); //finally we can draw a tile
-        } //for
+/// Get the frame of the tile sprite used to draw a map tile.
+/// \param i Row counting down from the top of the map.
+/// \param j Column.
+/// \return Frame number: 0 is floor, 1 is wall, 2 is an error tile.
+
+const UINT CTileManager::GetTileFrame(size_t i, size_t j) const{
+  switch(m_chMap[i][j]){
+    case 'F': return 0; //floor
+    case 'W': return 1; //wall
+    case 'R': return 4; //road
+    case 'A': return 5; //road
+
+    case 'G': case 'T': case 'E': case 'Z': case 'S': case 'H':
+      return 3; //grass
+
+    default:
+      LOG_WARNING("Unexpected tile character %c at [%zu][%zu].", m_chMap[i][j], i, j);
+      return 2; //error tile
+  } //switch
+} //GetTileFrame
+
+/// Get how far the tint has moved from day towards night. It is full day
+/// from 6AM to 5PM and full night from 6PM to 5AM, with the hours 5AM and
+/// 5PM halfway between. Without a game to tell the time it is noon.
+/// \return 0 for day, 1 for night.
+
+const float CTileManager::GetNightFactor() const{
+  const int h = m_pGame? m_pGame->GetHourOfDay(): 12; //hours since midnight
+
+  if(h >= 6 && h < 17)return 0.0f; //day
+  else if(h == 5 || h == 17)return 0.5f; //dawn or dusk
+  else return 1.0f; //night
+} //GetNightFactor
+
+/// Make the tile sprite descriptors and group them into square chunks of
+/// tiles. Chunks are numbered left-to-right and bottom-to-top in world space.
+/// \param t Sprite type for a multi-frame tile sprite.
+
+void CTileManager::MakeChunks(eSprite t){
+  const CAllocScope scope(eAlloc::Map); //chunks belong to the map
+  const size_t n = m_nChunkSize; //shorthand
+
+  m_nChunksWide = (m_nWidth + n - 1)/n;
+  m_nChunksHigh = (m_nHeight + n - 1)/n;
+  m_vecChunks.assign(m_nChunksWide*m_nChunksHigh, std::vector<LSpriteDesc2D>());
+
+  LSpriteDesc2D desc; //sprite descriptor for tile
+  desc.m_nSpriteIndex = (UINT)t; //sprite index for tile
+  desc.m_f4Tint = m_f4ChunkTint;
+
+  for(size_t i=0; i<m_nHeight; i++) //for each row
+    for(size_t j=0; j<m_nWidth; j++){ //for each column
+      const size_t y = m_nHeight - 1 - i; //row counting up from the bottom
+
+      desc.m_vPos = m_fTileSize*Vector2(j + 0.5f, y + 0.5f);
+      desc.m_nCurrentFrame = GetTileFrame(i, j);
+
+      m_vecChunks[(y/n)*m_nChunksWide + j/n].push_back(desc);
+    } //for
+} //MakeChunks
+
+/// Add the chunks that overlap the view rectangle to the draw list. The
+/// chunks are made on the first draw after a map is loaded. The tint of the
+/// chunk sprites is only changed when the time of day changes it.
+/// \param t Sprite type for a multi-frame tile sprite.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+
+void CTileManager::Draw(eSprite t, const Vector2& lo, const Vector2& hi){
+  if(m_chMap == nullptr)return; //no map loaded
+  if(m_vecChunks.empty())MakeChunks(t);
+
+  const XMFLOAT4 tint = lerp(XMFLOAT4(Colors::White),
+    XMFLOAT4(Colors::DarkCyan), GetNightFactor()); //tint for time of day
+
+  if(tint.x != m_f4ChunkTint.x || tint.y != m_f4ChunkTint.y ||
+     tint.z != m_f4ChunkTint.z || tint.w != m_f4ChunkTint.w)
+  { //time of day changed the tint
+    m_f4ChunkTint = tint;
+
+    for(auto& chunk: m_vecChunks)
+      for(LSpriteDesc2D& desc: chunk)
+        desc.m_f4Tint = tint;
+  } //if
+
+  const float w = m_nChunkSize*m_fTileSize; //chunk width and height
+
+  const int x0 = std::max(0, (int)floorf(lo.x/w));
+  const int x1 = std::min((int)m_nChunksWide - 1, (int)floorf(hi.x/w));
+  const int y0 = std::max(0, (int)floorf(lo.y/w));
+  const int y1 = std::min((int)m_nChunksHigh - 1, (int)floorf(hi.y/w));
+
+  for(int y=y0; y<=y1; y++) //for each visible chunk row
+    for(int x=x0; x<=x1; x++) //for each visible chunk column
+      for(const LSpriteDesc2D& desc: m_vecChunks[y*m_nChunksWide + x])
+        m_pDrawList->Add(eDrawLayer::Ground, desc);
 } //Draw
 
+/// Add the tiles that overlap the view rectangle to the draw list one at a
+/// time, making a sprite descriptor for each, which is how the map was drawn
+/// before there were chunks. `Draw()` must draw the same thing, except that
+/// it also draws the tiles out of view in the chunks that it draws, and the
+/// draw test checks that it does.
+/// \param t Sprite type for a multi-frame tile sprite.
+/// \param lo Bottom left corner of view rectangle.
+/// \param hi Top right corner of view rectangle.
+
+void CTileManager::DrawTiles(eSprite t, const Vector2& lo, const Vector2& hi){
+  if(m_chMap == nullptr)return; //no map loaded
+
+  LSpriteDesc2D desc; //sprite descriptor for tile
+  desc.m_nSpriteIndex = (UINT)t; //sprite index for tile
+  desc.m_f4Tint = lerp(XMFLOAT4(Colors::White),
+    XMFLOAT4(Colors::DarkCyan), GetNightFactor()); //tint for time of day
+
+  const int x0 = std::max(0, (int)floorf(lo.x/m_fTileSize));
+  const int x1 = std::min((int)m_nWidth - 1, (int)ceilf(hi.x/m_fTileSize) - 1);
+  const int y0 = std::max(0, (int)floorf(lo.y/m_fTileSize));
+  const int y1 = std::min((int)m_nHeight - 1, (int)ceilf(hi.y/m_fTileSize) - 1);
+
+  for(int y=y0; y<=y1; y++) //for each visible row, counting up from the bottom
+    for(int x=x0; x<=x1; x++){ //for each visible column
+      desc.m_vPos = m_fTileSize*Vector2(x + 0.5f, y + 0.5f);
+      desc.m_nCurrentFrame = GetTileFrame(m_nHeight - 1 - y, x);
+      m_pDrawList->Add(eDrawLayer::Ground, desc);
+    } //for
+} //DrawTiles
+
 /// Check whether a circle is visible from a point, that is, either the left
 /// or the right side of the object (from the perspective of the point)
 /// has no walls between it and the point. This gives some weird behavior
@@ -525,4 +726,64 @@ const bool CTileManager::CollideWithWall(
     } //if
   } //for
   return hit;
-} //CollideWithWall
\ No newline at end of file
+} //CollideWithWall
+
+/// Check whether a tile is a wall. Tiles outside the map count as walls.
+/// \param x Tile column.
+/// \param y Tile row counting up from the bottom of the map.
+/// \return true if the tile is a wall.
+
+const bool CTileManager::IsWall(int x, int y) const{
+  if(x < 0 || y < 0 || x >= (int)m_nWidth || y >= (int)m_nHeight)
+    return true; //off the map
+
+  return m_chMap[m_nHeight - 1 - y][x] == 'W';
+} //IsWall
+
+/// Find the first wall tile that a circle touches as it moves along a line
+/// segment, so that fast objects can't pass through thin walls or the
+/// corners of walls between frames. Only the wall tiles under the rectangle
+/// swept out by the circle are tested, so the cost depends on the length of
+/// the segment and not on the number of walls.
+/// \param p Circle center at the start of the segment.
+/// \param v Displacement of the circle center along the segment.
+/// \param r Circle radius.
+/// \param t [in, out] Fraction of v at first contact. Walls touched later
+/// than this are ignored.
+/// \param norm [out] Collision normal.
+/// \return true if the circle touches a wall before t.
+
+const bool CTileManager::SweepWalls(const Vector2& p, const Vector2& v,
+  float r, float& t, Vector2& norm) const
+{
+  if(m_chMap == nullptr)return false; //no map loaded
+
+  const float s = m_fTileSize; //shorthand
+  const Vector2 q = p + t*v; //end of segment
+  const int x0 = (int)floorf((std::min(p.x, q.x) - r)/s); //leftmost column
+  const int x1 = (int)floorf((std::max(p.x, q.x) + r)/s); //rightmost column
+  const int y0 = (int)floorf((std::min(p.y, q.y) - r)/s); //bottom row
+  const int y1 = (int)floorf((std::max(p.y, q.y) + r)/s); //top row
+
+  const Vector2 half(s/2, s/2); //tile half-size
+  bool hit = false; //return result, true if there is a collision with a wall
+
+  for(int y=y0; y<=y1; y++) //for each row under the swept rectangle
+    for(int x=x0; x<=x1; x++) //for each column under the swept rectangle
+      if(IsWall(x, y)){
+        BoundingBox aabb; //tile AABB
+        aabb.Center = Vector3(((float)x + 0.5f)*s, ((float)y + 0.5f)*s, 0);
+        aabb.Extents = Vector3(half.x, half.y, 0);
+
+        float t0 = 0; //time of contact with this tile
+        Vector2 n; //collision normal with this tile
+
+        if(SweepCircleVsAABB(p, v, r, aabb, t0, n) && t0 < t){ //earliest so far
+          t = t0;
+          norm = n;
+          hit = true;
+        } //if
+      } //if
+
+  return hit;
+} //SweepWalls
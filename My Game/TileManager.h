@@ -9,12 +9,18 @@
 #include "Common.h"
 #include "Settings.h"
 #include "Sprite.h"
+#include "SpriteDesc.h"
 #include "GameDefines.h"
 #include "Game.h"
+#include "TriggerManager.h"
 
 /// \brief The tile manager.
 ///
-/// The tile manager is responsible for the tile-based background.
+/// The tile manager is responsible for the tile-based background. The ground
+/// tiles never change within a level, so when a map is loaded their sprite
+/// descriptors are built once and grouped into square chunks. Drawing the
+/// background is then just a matter of submitting the chunks that overlap the
+/// view rectangle. Only the tint changes with the time of day.
 
 class CTileManager: 
   public CCommon, 
@@ -28,33 +34,57 @@ class CTileManager:
 
     float m_fTileSize = 0.0f; ///< Tile width and height.
 
-    char** m_chMap = nullptr; ///< The level map.
+    char** m_chMap = nullptr; ///< The level map, rows of one block.
 
     std::vector<BoundingBox> m_vecWalls; ///< AABBs for the walls.
     std::vector<Vector2> m_vecTurrets; ///< Turret positions.
     std::vector<Vector2> m_vecZombies; ///< Turret positions.
     std::vector<Vector2> m_vecTrees; ///< AABBs for the walls.
+    std::vector<CTriggerVolume> m_vecTriggers; ///< Trigger volumes.
     Vector2 m_vPlayer; ///< Player location.
     Vector2 m_vActivity;
     Vector2 m_vHouse;
     Vector2 m_vShop;
     Vector2 m_vRadioTower;
 
+    const size_t m_nChunkSize = 16; ///< Chunk width and height in tiles.
+    size_t m_nChunksWide = 0; ///< Number of chunks wide.
+    size_t m_nChunksHigh = 0; ///< Number of chunks high.
+
+    std::vector<std::vector<LSpriteDesc2D>> m_vecChunks; ///< Tile sprites in each chunk.
+    XMFLOAT4 m_f4ChunkTint = XMFLOAT4(Colors::White); ///< Tint of the chunk sprites.
+
+    void AllocMap(size_t, size_t); ///< Allocate the map.
+    void FreeMap(); ///< Delete the map.
     void MakeBoundingBoxes(); ///< Make bounding boxes for walls.
+    void ParseMap(const char*, size_t); ///< Parse a map file.
+    void LoadTriggers(const char*); ///< Load trigger volumes for a map.
+    void MakeChunks(eSprite); ///< Make tile sprite chunks.
+    const UINT GetTileFrame(size_t, size_t) const; ///< Get sprite frame for a tile.
+    const float GetNightFactor() const; ///< Get how dark it is.
 
   public:
-     CTileManager(size_t n, CGame* pGame) : m_fTileSize((float)n), m_pGame(pGame) { }
+    CTileManager(CWorld*, size_t, CGame*); ///< Constructor.
     ~CTileManager(); ///< Destructor.
 
     void LoadMapFromImageFile(char*);
     XMFLOAT4 lerp(XMFLOAT4 a, XMFLOAT4 b, float t);
-    void LoadMap(char*); ///< Load a map.
-    void Draw(eSprite); ///< Draw the map with a given tile.
-    void DrawBoundingBoxes(eSprite); ///< Draw the bounding boxes.
+    void LoadMap(const char*); ///< Load a map.
+    void ReadMap(const char*); ///< Read a map without making it current.
+    void Activate(); ///< Make the map current.
+    void Swap(CTileManager&); ///< Swap level data with another tile manager.
+    void Draw(eSprite, const Vector2&, const Vector2&); ///< Draw the map with a given tile.
+    void DrawTiles(eSprite, const Vector2&, const Vector2&); ///< Draw the map a tile at a time.
+    void DrawBoundingBoxes(eSprite, const Vector2&, const Vector2&,
+      size_t&, size_t&); ///< Draw the visible bounding boxes.
+    void GetViewRect(Vector2&, Vector2&) const; ///< Get visible world rectangle.
+    void GetTriggers(std::vector<CTriggerVolume>&) const; ///< Get trigger volumes.
     void GetObjects(std::vector<Vector2>&, Vector2&, Vector2&, Vector2&, std::vector<Vector2>&, std::vector<Vector2>&, Vector2&, Vector2&); ///< Get objects.
     
     const bool Visible(const Vector2&, const Vector2&, float) const; ///< Check visibility.
     const bool CollideWithWall(BoundingSphere, Vector2&, float&) const; ///< Object-wall collision test.
+    const bool IsWall(int, int) const; ///< Check for wall tile.
+    const bool SweepWalls(const Vector2&, const Vector2&, float, float&, Vector2&) const; ///< Moving circle-wall test.
 }; //CTileManager
 
 #endif //__L4RC_GAME_TILEMANAGER_H__
\ No newline at end of file
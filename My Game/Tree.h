@@ -12,7 +12,7 @@ protected:
         CObject* = nullptr); ///< Collision response.
 
 public:
-    CTree(eSprite t, const Vector2& p); ///< Constructor.
+    CTree(CWorld* pWorld, eSprite t, const Vector2& p); ///< Constructor.
 }; //CBullet
 
 #endif
\ No newline at end of file
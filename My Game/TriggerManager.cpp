@@ -0,0 +1,137 @@
+/// \file TriggerManager.cpp
+/// \brief Code for the trigger volume manager CTriggerManager.
+
+#include "TriggerManager.h"
+
+/// Test whether a point is inside a trigger volume, including its boundary.
+/// \param p A point.
+/// \return true if the point is inside the volume.
+
+const bool CTriggerVolume::Contains(const Vector2& p) const{
+  return p.x >= m_vLo.x && p.x <= m_vHi.x && p.y >= m_vLo.y && p.y <= m_vHi.y;
+} //Contains
+
+/// Get the cell column containing a horizontal position, clamped to the grid.
+/// \param x Horizontal position.
+/// \return Cell column.
+
+const int CTriggerManager::GetCellX(float x) const{
+  return std::min(std::max(0, (int)floorf(x/m_fCellSize)), m_nCellsWide - 1);
+} //GetCellX
+
+/// Get the cell row containing a vertical position, clamped to the grid.
+/// \param y Vertical position.
+/// \return Cell row.
+
+const int CTriggerManager::GetCellY(float y) const{
+  return std::min(std::max(0, (int)floorf(y/m_fCellSize)), m_nCellsHigh - 1);
+} //GetCellY
+
+/// Replace the trigger volumes and rebuild the grid. A volume is put into
+/// every cell that it overlaps. If the player is inside any of the old
+/// volumes, exit events are sent for them first.
+/// \param volumes Trigger volumes.
+/// \param size World width and height.
+
+void CTriggerManager::Build(const std::vector<CTriggerVolume>& volumes,
+  const Vector2& size)
+{
+  for(UINT i=0; i<(UINT)eTrigger::Size; i++) //leave the old volumes
+    if(m_nInside[i] > 0){
+      m_nInside[i] = 0;
+      Fire((eTrigger)i, false);
+    } //if
+
+  m_vecVolumes = volumes;
+  m_vecInside.assign(m_vecVolumes.size(), false);
+  m_vecOccupied.clear();
+
+  m_nCellsWide = std::max(1, (int)ceilf(size.x/m_fCellSize));
+  m_nCellsHigh = std::max(1, (int)ceilf(size.y/m_fCellSize));
+
+  const size_t nCells = (size_t)m_nCellsWide*m_nCellsHigh; //number of cells
+  m_vecCellStart.assign(nCells + 1, 0);
+
+  auto ForEachCell = [&](const CTriggerVolume& v, auto f){ //cells overlapped
+    for(int y=GetCellY(v.m_vLo.y); y<=GetCellY(v.m_vHi.y); y++)
+      for(int x=GetCellX(v.m_vLo.x); x<=GetCellX(v.m_vHi.x); x++)
+        f((size_t)y*m_nCellsWide + x);
+  }; //ForEachCell
+
+  for(const CTriggerVolume& v: m_vecVolumes) //count volumes in each cell
+    ForEachCell(v, [&](size_t n){m_vecCellStart[n + 1]++;});
+
+  for(size_t i=1; i<=nCells; i++) //prefix sum gives start of each cell
+    m_vecCellStart[i] += m_vecCellStart[i - 1];
+
+  m_vecCellIndex.resize(m_vecCellStart[nCells]);
+  std::vector<UINT> cursor(m_vecCellStart.begin(), m_vecCellStart.end() - 1);
+
+  for(UINT i=0; i<m_vecVolumes.size(); i++) //place volumes
+    ForEachCell(m_vecVolumes[i], [&](size_t n){m_vecCellIndex[cursor[n]++] = i;});
+} //Build
+
+/// Set the function to be called when the player enters or leaves a trigger
+/// type. Its parameters are the trigger type and whether it was entered.
+/// \param f Callback function.
+
+void CTriggerManager::SetCallback(const Callback& f){
+  m_fnCallback = f;
+} //SetCallback
+
+/// Send an event to the callback function, if there is one.
+/// \param t Trigger type.
+/// \param bEnter true if entered, false if left.
+
+void CTriggerManager::Fire(eTrigger t, bool bEnter){
+  if(m_fnCallback)
+    m_fnCallback(t, bEnter);
+} //Fire
+
+/// Update the trigger volumes with the player's position. Exit events are
+/// sent before enter events so that moving between two adjacent volumes of
+/// different types leaves one before entering the other.
+/// \param p Player position.
+
+void CTriggerManager::Update(const Vector2& p){
+  if(m_vecVolumes.empty())return; //nothing to do
+
+  for(size_t k=0; k<m_vecOccupied.size();){ //check for exits
+    const UINT i = m_vecOccupied[k]; //volume index
+
+    if(m_vecVolumes[i].Contains(p))k++; //still inside
+
+    else{ //left volume i
+      m_vecInside[i] = false;
+      m_vecOccupied[k] = m_vecOccupied.back();
+      m_vecOccupied.pop_back();
+
+      const eTrigger t = m_vecVolumes[i].m_eType; //shorthand
+      if(--m_nInside[(UINT)t] == 0)
+        Fire(t, false);
+    } //else
+  } //for
+
+  const size_t n = (size_t)GetCellY(p.y)*m_nCellsWide + GetCellX(p.x); //cell
+
+  for(UINT j=m_vecCellStart[n]; j<m_vecCellStart[n + 1]; j++){ //check for entries
+    const UINT i = m_vecCellIndex[j]; //volume index
+
+    if(!m_vecInside[i] && m_vecVolumes[i].Contains(p)){ //entered volume i
+      m_vecInside[i] = true;
+      m_vecOccupied.push_back(i);
+
+      const eTrigger t = m_vecVolumes[i].m_eType; //shorthand
+      if(m_nInside[(UINT)t]++ == 0)
+        Fire(t, true);
+    } //if
+  } //for
+} //Update
+
+/// Reader function for whether the player is inside a trigger type.
+/// \param t Trigger type.
+/// \return true if the player is inside a volume of that type.
+
+const bool CTriggerManager::IsInside(eTrigger t) const{
+  return m_nInside[(UINT)t] > 0;
+} //IsInside
@@ -0,0 +1,70 @@
+/// \file TriggerManager.h
+/// \brief Interface for the trigger volume manager CTriggerManager.
+
+#ifndef __L4RC_GAME_TRIGGERMANAGER_H__
+#define __L4RC_GAME_TRIGGERMANAGER_H__
+
+#include <vector>
+#include <functional>
+
+#include "Common.h"
+#include "GameDefines.h"
+
+/// \brief A trigger volume.
+///
+/// An axis-aligned rectangle in world space that fires events when the
+/// player enters or leaves it.
+
+class CTriggerVolume{
+  public:
+    eTrigger m_eType = eTrigger::Farm; ///< Trigger type.
+    Vector2 m_vLo; ///< Bottom left corner.
+    Vector2 m_vHi; ///< Top right corner.
+
+    const bool Contains(const Vector2&) const; ///< Point containment test.
+}; //CTriggerVolume
+
+/// \brief The trigger volume manager.
+///
+/// The trigger volumes for the current map are bucketed into a uniform grid
+/// so that each update only tests the volumes in the cell containing the
+/// player, plus the volumes that the player is already inside in order to
+/// catch the player leaving them. Enter and exit events are sent to a
+/// callback function only when the player crosses the boundary of a trigger
+/// type, so overlapping volumes of the same type act as one zone.
+
+class CTriggerManager:
+  public CCommon
+{
+  public:
+    using Callback = std::function<void(eTrigger, bool)>; ///< Event callback type.
+
+  private:
+    const float m_fCellSize = 256.0f; ///< Width and height of a grid cell.
+
+    int m_nCellsWide = 0; ///< Number of cells wide.
+    int m_nCellsHigh = 0; ///< Number of cells high.
+
+    std::vector<CTriggerVolume> m_vecVolumes; ///< Trigger volumes.
+    std::vector<UINT> m_vecCellStart; ///< Start of each cell in m_vecCellIndex.
+    std::vector<UINT> m_vecCellIndex; ///< Volume indices sorted by cell.
+
+    std::vector<bool> m_vecInside; ///< Whether the player is inside each volume.
+    std::vector<UINT> m_vecOccupied; ///< Indices of volumes the player is inside.
+    UINT m_nInside[(UINT)eTrigger::Size] = {0}; ///< Volumes of each type the player is inside.
+
+    Callback m_fnCallback; ///< Event callback.
+
+    const int GetCellX(float) const; ///< Get cell column.
+    const int GetCellY(float) const; ///< Get cell row.
+    void Fire(eTrigger, bool); ///< Send an event.
+
+  public:
+    void Build(const std::vector<CTriggerVolume>&, const Vector2&); ///< Build from volumes.
+    void SetCallback(const Callback&); ///< Set event callback.
+    void Update(const Vector2&); ///< Update with player position.
+
+    const bool IsInside(eTrigger) const; ///< Is the player inside a trigger type?
+}; //CTriggerManager
+
+#endif //__L4RC_GAME_TRIGGERMANAGER_H__
@@ -10,19 +10,21 @@
 #include "Particle.h"
 #include "ParticleEngine.h"
 #include "Object.h"
+#include "AllocTracker.h"
+#include "World.h"
 #include <iostream>
 
 /// Create and initialize a turret object given its position.
+/// \param pWorld Pointer to the world the object is part of.
 /// \param p Position of turret.
 
-CTurret::CTurret(const Vector2& p): CObject(eSprite::Turret, p){
+CTurret::CTurret(CWorld* pWorld, const Vector2& p): CObject(pWorld, eSprite::Turret, p){
   m_bStatic = false; //turrets are static
   m_bIsTurret = true; //flag for collision detection
   m_bIsActivity = false;
   HasBeenInActivity = false;
   HasBeenShot = false;
-  m_vWanderDirection = Vector2(rand() - RAND_MAX / 2, rand() - RAND_MAX / 2);
-  m_vWanderDirection.Normalize();
+  m_vWanderDirection = m_pWorld->m_cRandom.randv();
 } //constructor
 
 /// Rotate the turret and fire the gun at at the closest available target if
@@ -30,7 +32,7 @@ CTurret::CTurret(const Vector2& p): CObject(eSprite::Turret, p){
 
 void CTurret::move() {
     m_frameCounter++;
-    if (m_pPlayer && m_bIsTurret) {
+    if (m_pWorld->m_pPlayer && m_bIsTurret) {
         if (m_frameCounter % 25 == 0) {
             if (m_bIsAlternateSprite) {
                 m_nSpriteIndex = (UINT)eSprite::Turret; // Alternate sprite 1
@@ -50,22 +52,20 @@ void CTurret::move() {
     // Reduce the knockback velocity
     m_vKnockbackVelocity *= (1.0f - knockbackFraction);
     
-    if (m_pPlayer && (HasBeenInActivity == true || HasBeenShot == true)) { // Safety check
-        const float r = ((CTurret*)m_pPlayer)->m_fRadius; // Player radius
-        if (m_pTileManager->Visible(m_vPos, m_pPlayer->m_vPos, r)) // Player visible
+    if (m_pWorld->m_pPlayer && (HasBeenInActivity == true || HasBeenShot == true)) { // Safety check
+        const float r = ((CTurret*)m_pWorld->m_pPlayer)->m_fRadius; // Player radius
+        if (m_pWorld->m_pTileManager->Visible(m_vPos, m_pWorld->m_pPlayer->m_vPos, r)) // Player visible
         {
             // Rotate towards the player
-            RotateTowards(m_pPlayer->m_vPos);
+            RotateTowards(m_pWorld->m_pPlayer->m_vPos);
 
             // Move towards the player
-            MoveTowards(m_pPlayer->m_vPos);
+            MoveTowards(m_pWorld->m_pPlayer->m_vPos);
         }
         else {
             // Change direction every 100 frames
-            static int counter = 0;
-            if (counter++ % 350 == 0) {
-                m_vWanderDirection = Vector2(rand() - RAND_MAX / 2, rand() - RAND_MAX / 2);
-                m_vWanderDirection.Normalize();
+            if (m_nWanderFrames++ % 350 == 0) {
+                m_vWanderDirection = m_pWorld->m_cRandom.randv();
             }
 
             // Rotate towards the wander direction
@@ -77,10 +77,8 @@ void CTurret::move() {
     }
     else {
         // Change direction every 100 frames
-        static int counter = 0;
-        if (counter++ % 100 == 0) {
-            m_vWanderDirection = Vector2(rand() - RAND_MAX / 2, rand() - RAND_MAX / 2);
-            m_vWanderDirection.Normalize();
+        if (m_nWanderFrames++ % 100 == 0) {
+            m_vWanderDirection = m_pWorld->m_cRandom.randv();
         }
 
         // Rotate towards the wander direction
@@ -90,7 +88,7 @@ void CTurret::move() {
         MoveTowards(m_vPos + m_vWanderDirection);
     }
 
-    m_fRoll += 0.2f * m_fRotSpeed * XM_2PI * m_pTimer->GetFrameTime(); // Rotate
+    m_fRoll += 0.2f * m_fRotSpeed * XM_2PI * m_pWorld->m_fFrameTime; // Rotate
     NormalizeAngle(m_fRoll); // Normalize to [-pi, pi] for accuracy
     if (m_frameCounter == 50) {
         m_frameCounter = 0;
@@ -140,7 +138,7 @@ void CTurret::RotateTowards(const Vector2& pos){
   //fire gun if pointing approximately towards target
 
   //if(fabsf(diff) < fAngleDelta && m_pGunFireEvent->Triggered())
-    //m_pObjectManager->FireGun(this, eSprite::Bullet2);
+    //m_pWorld->m_pObjectManager->FireGun(this, eSprite::Bullet2);
 } //RotateTowards
 
 /// Response to collision. 
@@ -152,8 +150,7 @@ void CTurret::RotateTowards(const Vector2& pos){
 void CTurret::CollisionResponse(const Vector2& norm, float d, CObject* pObj){
   if(m_bDead)return; //already dead, bail out 
 
-  m_vWanderDirection = Vector2(rand() - RAND_MAX / 2, rand() - RAND_MAX / 2);
-  m_vWanderDirection.Normalize();
+  m_vWanderDirection = m_pWorld->m_cRandom.randv();
 
   //If pObj is a Activity, then do nothing
   if (pObj && pObj->isActivity()) {
@@ -165,30 +162,40 @@ void CTurret::CollisionResponse(const Vector2& norm, float d, CObject* pObj){
       m_vPos += vOverlap; //back off this object
 
 
-      if (pObj && pObj->isBullet()) { //collision with bullet
-          // Calculate the pushback velocity based on the collision normal
-          const float pushbackSpeed = 25.0f; // Adjust the pushback speed as needed
-          m_vKnockbackVelocity = norm * pushbackSpeed; // Store the pushback velocity
-
-          HasBeenShot = true;
-          if (--m_nHealth == 0) { //health decrements to zero means death 
-              m_pAudio->play(eSound::Boom); //explosion
-              m_bDead = true; //flag for deletion from object list
-              DeathFX(); //particle effects
-          } //if
-
-          else { //not a death blow
-              m_pAudio->play(eSound::Clang); //impact sound
-              const float f = 0.5f + 0.5f * (float)m_nHealth / m_nMaxHealth; //health fraction
-              m_f4Tint = XMFLOAT4(1.0f, f, f, 0); //redden the sprite to indicate damage
-          } //else
-      } //if
+      if (pObj && pObj->isBullet()) //collision with bullet
+          TakeHit(norm);
   }
 } //CollisionResponse
 
+/// Response to being hit by a bullet. Get knocked back and lose health.
+/// \param norm Collision normal.
+
+void CTurret::TakeHit(const Vector2& norm){
+  if(m_bDead)return; //already dead, bail out
+
+  // Calculate the pushback velocity based on the collision normal
+  const float pushbackSpeed = 25.0f; // Adjust the pushback speed as needed
+  m_vKnockbackVelocity = norm * pushbackSpeed; // Store the pushback velocity
+
+  HasBeenShot = true;
+  if (--m_nHealth == 0) { //health decrements to zero means death 
+      if(!m_pWorld->m_bMute)m_pAudio->play(eSound::Boom); //explosion
+      m_bDead = true; //flag for deletion from object list
+      DeathFX(); //particle effects
+  } //if
+
+  else { //not a death blow
+      if(!m_pWorld->m_bMute)m_pAudio->play(eSound::Clang); //impact sound
+      const float f = 0.5f + 0.5f * (float)m_nHealth / m_nMaxHealth; //health fraction
+      m_f4Tint = XMFLOAT4(1.0f, f, f, 0); //redden the sprite to indicate damage
+  } //else
+} //TakeHit
+
 /// Perform a particle effect to mark the death of the turret.
 
 void CTurret::DeathFX(){
+  if(m_pWorld->m_pParticleEngine == nullptr)return; //nobody to see it
+  const CAllocScope scope(eAlloc::Particles); //charge to particles
   LParticleDesc2D d; //particle descriptor
   d.m_vPos = m_vPos; //center particle at turret center
 
@@ -198,7 +205,7 @@ void CTurret::DeathFX(){
   d.m_fScaleInFrac = 0.5f;
   d.m_fFadeOutFrac = 0.8f;
   d.m_fScaleOutFrac = 0;
-  m_pParticleEngine->create(d);
+  m_pWorld->m_pParticleEngine->create(d);
 
   d.m_nSpriteIndex = (UINT)eSprite::Spark;
   d.m_fLifeSpan = 0.5f;
@@ -207,5 +214,5 @@ void CTurret::DeathFX(){
   d.m_fScaleOutFrac = 0.3f;
   d.m_fFadeOutFrac = 0.5f;
   d.m_f4Tint = XMFLOAT4(Colors::Orange);
-  m_pParticleEngine->create(d);
+  m_pWorld->m_pParticleEngine->create(d);
 } //DeathFX
\ No newline at end of file
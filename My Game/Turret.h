@@ -11,8 +11,11 @@
 /// CTurret is the abstract representation of a turret object.
 
 class CTurret: public CObject{
+  friend class CObjectManager; ///< Object manager saves and loads health.
+
   protected:
     Vector2 m_vWanderDirection; ///< Current wander direction.
+    UINT m_nWanderFrames = 0; ///< Frames spent wandering.
     const UINT m_nMaxHealth = 8; ///< Maximum health.
     UINT m_nHealth = m_nMaxHealth; ///< Current health.
     bool HasBeenInActivity;
@@ -23,9 +26,10 @@ class CTurret: public CObject{
     void MoveTowards(const Vector2&);
     virtual void CollisionResponse(const Vector2&, float, CObject* = nullptr); ///< Collision response.
     virtual void DeathFX(); ///< Death special effects.
+    virtual void TakeHit(const Vector2&); ///< Response to being shot.
 
   public:
-    CTurret(const Vector2& p); ///< Constructor.
+    CTurret(CWorld* pWorld, const Vector2& p); ///< Constructor.
     virtual void move(); ///< Move turret.
     int m_frameCounter = 0;
     bool m_bIsAlternateSprite = false;
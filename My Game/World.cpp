@@ -0,0 +1,144 @@
+/// \file World.cpp
+/// \brief Code for the world CWorld.
+
+#include <algorithm>
+
+#include "World.h"
+#include "ComponentIncludes.h"
+#include "ParticleEngine.h"
+#include "ObjectManager.h"
+#include "BulletManager.h"
+#include "TileManager.h"
+#include "Player.h"
+#include "Activity.h"
+#include "House.h"
+#include "Shop.h"
+#include "RadioTower.h"
+
+static const UINT MAX_NIGHT_SPAWNS = 70; ///< Most zombies and turrets out in a night.
+
+/// Create the managers for a new world. A world in a process that has no
+/// renderer has no particle engine either.
+/// \param n Tile size in pixels.
+/// \param pGame Pointer to the game that tells the tile manager the time,
+/// or `nullptr` if there is none.
+/// \param seed Seed for the world's random number generator.
+
+CWorld::CWorld(size_t n, CGame* pGame, uint32_t seed): m_cRandom(seed){
+  m_pTileManager = new CTileManager(this, n, pGame);
+  m_pObjectManager = new CObjectManager(this);
+  m_pBulletManager = new CBulletManager(this);
+
+  if(m_pRenderer) //particles are only for looking at
+    m_pParticleEngine = new LParticleEngine2D(m_pRenderer);
+} //constructor
+
+/// Delete the managers for this world. The objects are deleted while the
+/// other managers still exist, since objects may refer to them on the way
+/// out.
+
+CWorld::~CWorld(){
+  delete m_pParticleEngine;
+  delete m_pObjectManager;
+  delete m_pBulletManager;
+  delete m_pTileManager;
+} //destructor
+
+/// Create the objects that a level starts with at the positions that the map
+/// in the tile manager gives for them: the player, if asked for, then the
+/// activity, house, shop, radio tower, and trees. Zombies and turrets come
+/// later. A snapshot is taken of the objects, so that `RestoreLevel()` can
+/// put them back the way they started.
+/// \param bPlayer true to create a player at the start position.
+/// \return Start position.
+
+const Vector2 CWorld::CreateLevel(bool bPlayer){
+  std::vector<Vector2> turretpos; //turret positions
+  std::vector<Vector2> treepos; //tree positions
+  std::vector<Vector2> zombiepos; //zombie positions
+  Vector2 start, activitypos, housepos, shoppos, radiotowerpos; //other positions
+
+  m_pTileManager->GetObjects(turretpos, start, activitypos, housepos,
+    treepos, zombiepos, shoppos, radiotowerpos);
+
+  m_pPlayer = bPlayer? (CPlayer*)m_pObjectManager->create(eSprite::Player, start): nullptr;
+  m_pActivity = (CActivity*)m_pObjectManager->create(eSprite::Activity, start);
+  m_pHouse = (CHouse*)m_pObjectManager->create(eSprite::House, housepos);
+  m_pShop = (CShop*)m_pObjectManager->create(eSprite::Shop, shoppos);
+  m_pRadioTower = (CRadioTower*)m_pObjectManager->create(eSprite::Research, radiotowerpos);
+
+  for(const Vector2& pos: treepos)
+    m_pObjectManager->create(eSprite::Tree, pos);
+
+  m_pObjectManager->Snapshot();
+  m_nNights = 0;
+  return start;
+} //CreateLevel
+
+/// Put the objects back the way they were when `CreateLevel()` created them
+/// with a player, from the object manager's snapshot. The map doesn't change
+/// during play, so it is kept.
+
+void CWorld::RestoreLevel(){
+  m_pObjectManager->RestoreSnapshot();
+
+  //the objects that the world keeps pointers to, in the order that
+  //CreateLevel() created them
+
+  m_pPlayer = (CPlayer*)m_pObjectManager->GetSnapshotObject(0);
+  m_pActivity = (CActivity*)m_pObjectManager->GetSnapshotObject(1);
+  m_pHouse = (CHouse*)m_pObjectManager->GetSnapshotObject(2);
+  m_pShop = (CShop*)m_pObjectManager->GetSnapshotObject(3);
+  m_pRadioTower = (CRadioTower*)m_pObjectManager->GetSnapshotObject(4);
+
+  m_nNights = 0;
+} //RestoreLevel
+
+/// Bring out the zombies and turrets for the night at the map's zombie and
+/// turret positions, picked at random, reusing positions if the map has too
+/// few. `m_cTuning.m_nNightZombies` of each come out on the first night, and
+/// `m_cTuning.m_nNightRamp` more on each night after that, up to 70.
+/// \return Number of zombies and turrets that came out.
+
+const UINT CWorld::SpawnNight(){
+  std::vector<Vector2> turretpos; //turret positions
+  std::vector<Vector2> treepos; //tree positions
+  std::vector<Vector2> zombiepos; //zombie positions
+  Vector2 start, activitypos, housepos, shoppos, radiotowerpos; //other positions
+
+  m_pTileManager->GetObjects(turretpos, start, activitypos, housepos,
+    treepos, zombiepos, shoppos, radiotowerpos);
+
+  std::shuffle(turretpos.begin(), turretpos.end(), m_cRandom);
+  std::shuffle(zombiepos.begin(), zombiepos.end(), m_cRandom);
+
+  const UINT n = std::min(m_cTuning.m_nNightZombies + m_nNights*m_cTuning.m_nNightRamp,
+    MAX_NIGHT_SPAWNS); //number of each
+  UINT count = 0; //number that came out
+  m_nNights++;
+
+  for(UINT i=0; i<n && !zombiepos.empty(); i++, count++)
+    m_pObjectManager->create(eSprite::Zombie2, zombiepos[i%zombiepos.size()]);
+
+  for(UINT i=0; i<n && !turretpos.empty(); i++, count++)
+    m_pObjectManager->create(eSprite::Turret, turretpos[i%turretpos.size()]);
+
+  return count;
+} //SpawnNight
+
+/// Get the time of day on the game clock, which starts at noon and runs at
+/// 30 game minutes per second.
+/// \param t Seconds since the level started.
+/// \return Minutes since midnight.
+
+const int CWorld::GetClockMinutes(float t){
+  return ((int)(t*30) + 12*60)%(24*60);
+} //GetClockMinutes
+
+/// Night runs from 6:00 PM until 6:00 AM, inclusive.
+/// \param minutes Minutes since midnight.
+/// \return true if it is night.
+
+const bool CWorld::IsNight(int minutes){
+  return minutes >= 18*60 || minutes <= 6*60;
+} //IsNight
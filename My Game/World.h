@@ -0,0 +1,89 @@
+/// \file World.h
+/// \brief Interface for the world CWorld.
+
+#ifndef __L4RC_GAME_WORLD_H__
+#define __L4RC_GAME_WORLD_H__
+
+#include "Common.h"
+#include "Random.h"
+
+class CGame;
+class CObjectManager; 
+class CBulletManager;
+class LParticleEngine2D;
+class CTileManager;
+class CPlayer;
+class CActivity;
+class CHouse;
+class CShop;
+class CRadioTower;
+
+/// \brief Tuning values.
+///
+/// The values that the rules of the game are tuned by, which the balance
+/// harness varies.
+
+struct CTuning{
+  UINT m_nNightZombies = 6; ///< Zombies and turrets out on the first night.
+  UINT m_nNightRamp = 10; ///< Extra zombies and turrets each night after that.
+  float m_fShotCooldown = 0.35f; ///< Least time between the player's shots in seconds.
+  UINT m_nZombieHealth = 4; ///< Zombie health in hits.
+  float m_fZombieSpeed = 1.0f; ///< Zombie speed in pixels per frame.
+}; //CTuning
+
+/// \brief A world.
+///
+/// A world is the object manager, bullet manager, particle engine, and tile
+/// manager for one simulation, together with the game state that goes with
+/// them and a random number generator of its own. The managers and the
+/// objects that they create point back to the world that they are part of,
+/// so nothing about a world depends on which thread it is used from, and
+/// any number of worlds can exist at once. A world must be used by only one
+/// thread at a time. Worlds share the renderer and asset pack, which they
+/// only read. The rules of the night and the values that they are tuned by
+/// are here too, so that the game, the co-op server, and the balance
+/// harness all play by the same ones.
+
+class CWorld:
+  public CCommon
+{
+  public:
+    CObjectManager* m_pObjectManager = nullptr; ///< Pointer to object manager.
+    CBulletManager* m_pBulletManager = nullptr; ///< Pointer to bullet manager.
+    LParticleEngine2D* m_pParticleEngine = nullptr; ///< Pointer to particle engine, if drawn.
+    CTileManager* m_pTileManager = nullptr; ///< Pointer to tile manager.
+    CRandom m_cRandom; ///< Random number generator.
+
+    CTuning m_cTuning; ///< Values that the rules are tuned by.
+    UINT m_nNights = 0; ///< Nights that zombies have come out since the level started.
+
+    bool m_bGodMode = false; ///< God mode flag.
+    float m_fFrameTime = 0.0f; ///< Simulation step in seconds.
+    bool m_bMute = false; ///< Don't play sounds.
+
+    bool gotBattery = false;
+    bool gotAntenna = false;
+    bool gotLogicBoard = false;
+
+    Vector2 m_vWorldSize; ///< World height and width.
+    CPlayer* m_pPlayer = nullptr; ///< Pointer to player character.
+    CActivity* m_pActivity = nullptr;
+    CHouse* m_pHouse = nullptr;
+    CShop* m_pShop = nullptr;
+    CRadioTower* m_pRadioTower = nullptr;
+
+    CWorld(size_t, CGame*, uint32_t); ///< Constructor.
+    ~CWorld(); ///< Destructor.
+
+    const Vector2 CreateLevel(bool); ///< Create the objects for the map.
+    void RestoreLevel(); ///< Put the objects back the way they started.
+    const UINT SpawnNight(); ///< Bring out the zombies and turrets for the night.
+
+    static const int GetClockMinutes(float); ///< Get the time of day.
+    static const bool IsNight(int); ///< Whether a time of day is at night.
+
+    CWorld(const CWorld&) = delete; ///< No copy constructor.
+    CWorld& operator=(const CWorld&) = delete; ///< No assignment.
+}; //CWorld
+
+#endif //__L4RC_GAME_WORLD_H__
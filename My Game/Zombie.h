@@ -11,9 +11,11 @@
 /// CTurret is the abstract representation of a turret object.
 
 class CZombie : public CObject {
+    friend class CObjectManager; ///< Object manager saves and loads health.
+
 protected:
     Vector2 m_vWanderDirection; ///< Current wander direction.
-    const UINT m_nMaxHealth = 4; ///< Maximum health.
+    const UINT m_nMaxHealth; ///< Maximum health, which the world sets.
     UINT m_nHealth = m_nMaxHealth; ///< Current health.
     bool HasBeenInActivity;
     bool HasBeenShot;
@@ -23,9 +25,10 @@ protected:
     void MoveTowards(const Vector2&);
     virtual void CollisionResponse(const Vector2&, float, CObject* = nullptr); ///< Collision response.
     virtual void DeathFX(); ///< Death special effects.
+    virtual void TakeHit(const Vector2&); ///< Response to being shot.
 
 public:
-    CZombie(const Vector2& p); ///< Constructor.
+    CZombie(CWorld* pWorld, const Vector2& p); ///< Constructor.
     virtual void move(); ///< Move turret.
     int m_frameCounter = 0;
     bool m_bIsAlternateSprite = false;
@@ -0,0 +1,226 @@
+/// \file AssetPack.cpp
+/// \brief Command line tool that builds the game's asset pack.
+///
+/// Collects every file under the given directories into a single pack file
+/// in the format described in `My Game/AssetPack.h`: a header, an
+/// open-addressed hash table of contents, the asset names, and the asset data
+/// aligned to page boundaries. After writing the pack, it reads it back and
+/// looks up every asset by name, to check that the table finds each one. Build
+/// and run it from the root of the repository with
+///
+///     g++ -O2 -std=c++17 -I"My Game" Tools/AssetPack/AssetPack.cpp -o assetpack
+///     ./assetpack Media/media.pack Media/Images Media/Sounds Media/Fonts Media/Maps Media/XML
+///
+/// The first argument is the pack file and the rest are the directories to
+/// put into it. The game opens `Media\media.pack` if it exists and reads any
+/// asset that it can't find there from its loose file.
+
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/// \brief An asset to be packed.
+
+struct Asset{
+  std::string m_strName; ///< Normalized asset name.
+  fs::path m_Path; ///< Path of loose file.
+  uint64_t m_nOffset = 0; ///< Offset of data in pack.
+  uint64_t m_nSize = 0; ///< Size of data in bytes.
+}; //Asset
+
+/// Normalize a name for the table of contents.
+/// \param s Name.
+/// \return Normalized name.
+
+static std::string Normalize(std::string s){
+  for(char& c: s)c = PackNormalize(c);
+  return s;
+} //Normalize
+
+/// Round up to a multiple of the pack alignment.
+/// \param n Offset.
+/// \return Aligned offset.
+
+static uint64_t Align(uint64_t n){
+  return (n + PACK_ALIGN - 1)/PACK_ALIGN*PACK_ALIGN;
+} //Align
+
+/// Find the slot for a hash in the table, which is the first empty slot at or
+/// after the hash's home slot, wrapping around at the end.
+/// \param table Table of contents.
+/// \param hash Hash of name.
+/// \return Slot index.
+
+static uint32_t FindSlot(const std::vector<PackEntry>& table, uint64_t hash){
+  const uint32_t mask = (uint32_t)table.size() - 1; //for wrapping slot index
+  uint32_t i = (uint32_t)hash & mask; //home slot
+  while(table[i].m_nHash != 0)i = (i + 1) & mask;
+  return i;
+} //FindSlot
+
+/// Read back a pack and check that every asset can be found by name and has
+/// the right contents.
+/// \param filename Pack file name.
+/// \param assets Assets that should be in the pack.
+/// \return true if every asset was found intact.
+
+static bool Verify(const std::string& filename, const std::vector<Asset>& assets){
+  std::ifstream in(filename, std::ios::binary);
+  std::vector<char> pack((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  const PackHeader& h = *(const PackHeader*)pack.data();
+  const PackEntry* table = (const PackEntry*)(pack.data() + sizeof(PackHeader));
+  const uint32_t mask = h.m_nTableSize - 1;
+  size_t probes = 0; //total number of slots probed
+
+  for(const Asset& a: assets){
+    const uint64_t hash = PackHash(a.m_strName.data(), a.m_strName.size());
+    const PackEntry* found = nullptr;
+
+    for(uint32_t i=(uint32_t)hash & mask; table[i].m_nHash != 0; i=(i + 1) & mask){
+      probes++;
+      const PackEntry& e = table[i];
+
+      if(e.m_nHash == hash && e.m_nNameLength == a.m_strName.size() &&
+         !memcmp(pack.data() + e.m_nNameOffset, a.m_strName.data(), e.m_nNameLength))
+      {
+        found = &e;
+        break;
+      } //if
+    } //for
+
+    std::ifstream loose(a.m_Path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(loose)), std::istreambuf_iterator<char>());
+
+    if(found == nullptr || found->m_nOffset%PACK_ALIGN || found->m_nSize != data.size() ||
+       memcmp(pack.data() + found->m_nOffset, data.data(), data.size()))
+    {
+      fprintf(stderr, "Verify failed for %s\n", a.m_strName.c_str());
+      return false;
+    } //if
+  } //for
+
+  printf("Verified %zu assets, %.2f probes per lookup\n", assets.size(),
+    (double)probes/std::max<size_t>(1, assets.size()));
+  return true;
+} //Verify
+
+int main(int argc, char* argv[]){
+  if(argc < 3){
+    fprintf(stderr, "Usage: %s pack-file directory...\n", argv[0]);
+    return 1;
+  } //if
+
+  const std::string packName = argv[1];
+
+  //collect files
+
+  std::vector<Asset> assets;
+
+  for(int i=2; i<argc; i++){
+    if(!fs::is_directory(argv[i])){
+      fprintf(stderr, "%s is not a directory\n", argv[i]);
+      return 1;
+    } //if
+
+    for(const auto& f: fs::recursive_directory_iterator(argv[i]))
+      if(f.is_regular_file()){
+        Asset a;
+        a.m_Path = f.path();
+        a.m_strName = Normalize(f.path().generic_string());
+        a.m_nSize = (uint64_t)f.file_size();
+        assets.push_back(a);
+      } //if
+  } //for
+
+  std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b){
+    return a.m_strName < b.m_strName;
+  }); //sort
+
+  for(size_t i=1; i<assets.size(); i++)
+    if(assets[i].m_strName == assets[i - 1].m_strName){
+      fprintf(stderr, "Duplicate asset %s\n", assets[i].m_strName.c_str());
+      return 1;
+    } //if
+
+  //lay out the file
+
+  PackHeader header;
+  memcpy(header.m_chMagic, PACK_MAGIC, 4);
+  header.m_nVersion = PACK_VERSION;
+  header.m_nNumEntries = (uint32_t)assets.size();
+  header.m_nTableSize = 1;
+  while(header.m_nTableSize < 2*assets.size() + 1) //keep load factor under half
+    header.m_nTableSize *= 2;
+
+  std::vector<PackEntry> table(header.m_nTableSize);
+  memset(table.data(), 0, table.size()*sizeof(PackEntry));
+
+  std::string names; //all asset names
+  const uint64_t namesOffset = sizeof(PackHeader) + table.size()*sizeof(PackEntry);
+
+  for(const Asset& a: assets)
+    names += a.m_strName;
+
+  uint64_t offset = Align(namesOffset + names.size()); //start of next asset
+  uint64_t nameOffset = namesOffset; //start of next name
+
+  for(Asset& a: assets){
+    a.m_nOffset = offset;
+    offset = Align(offset + a.m_nSize);
+
+    const uint64_t hash = PackHash(a.m_strName.data(), a.m_strName.size());
+    PackEntry& e = table[FindSlot(table, hash)];
+    e.m_nHash = hash;
+    e.m_nOffset = a.m_nOffset;
+    e.m_nSize = a.m_nSize;
+    e.m_nNameOffset = (uint32_t)nameOffset;
+    e.m_nNameLength = (uint32_t)a.m_strName.size();
+    nameOffset += a.m_strName.size();
+  } //for
+
+  //write the file
+
+  std::ofstream out(packName, std::ios::binary);
+
+  if(!out){
+    fprintf(stderr, "Cannot write %s\n", packName.c_str());
+    return 1;
+  } //if
+
+  out.write((const char*)&header, sizeof(header));
+  out.write((const char*)table.data(), table.size()*sizeof(PackEntry));
+  out.write(names.data(), names.size());
+
+  std::vector<char> data;
+
+  for(const Asset& a: assets){
+    const std::string pad((size_t)(a.m_nOffset - (uint64_t)out.tellp()), '\0');
+    out.write(pad.data(), pad.size());
+
+    std::ifstream in(a.m_Path, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    if(data.size() != a.m_nSize){
+      fprintf(stderr, "Cannot read %s\n", a.m_Path.string().c_str());
+      return 1;
+    } //if
+
+    out.write(data.data(), data.size());
+  } //for
+
+  out.close();
+
+  printf("%s: %zu assets, %llu bytes\n", packName.c_str(), assets.size(),
+    (unsigned long long)fs::file_size(packName));
+
+  return Verify(packName, assets)? 0: 1;
+} //main
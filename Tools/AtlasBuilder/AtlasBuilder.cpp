@@ -0,0 +1,500 @@
+/// \file AtlasBuilder.cpp
+/// \brief Offline texture atlas builder for the sprites in Media/Images.
+///
+/// Reads the image files for each sprite from `gamesettings.xml`, and ties
+/// them to `eSprite` values with the sprite list `SpriteList.h` that the game
+/// loads its sprites from. It decodes the images with the `stb_image.h`
+/// bundled with the game, packs them onto a few atlas pages with a shelf
+/// packer, and writes the pages as PNG files. The PNG writer is the small one
+/// below, which stores the pixels without compressing them, since the game
+/// only needs to decode them and the asset pack is where size is dealt with.
+/// With the pages it writes a generated header `AtlasTable.h` that gives the atlas page and
+/// texture coordinates of every sprite frame, keyed by its `eSprite` value.
+/// Images too large to share a page (the full-screen backgrounds) are left as
+/// they are and listed in the header as standalone. It also writes the
+/// generated header `SpriteSizes.h`, which gives the size of each sprite so
+/// that the game can simulate without a renderer. Nothing here needs a window
+/// or a graphics device. Build and run it from the root of the repository with
+///
+///     g++ -O2 -std=c++17 -I"My Game" Tools/AtlasBuilder/AtlasBuilder.cpp -o atlasbuilder
+///     ./atlasbuilder Media/XML/gamesettings.xml Atlas 2048 "My Game/SpriteSizes.h"
+///
+/// The arguments are the settings file, the output directory, the atlas page
+/// size in pixels, and where to write the sprite size header. Run it again
+/// whenever a sprite image changes size.
+
+#define STBI_ASSERT(x)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// \brief An image to be packed.
+
+struct Image{
+  std::string m_strSprite; ///< eSprite enumerator name.
+  std::string m_strFile; ///< Image file name.
+  unsigned m_nFrame = 0; ///< Frame number within sprite.
+  int m_nWidth = 0; ///< Width in pixels.
+  int m_nHeight = 0; ///< Height in pixels.
+  std::vector<uint8_t> m_vecPixels; ///< RGBA pixels.
+  int m_nPage = -1; ///< Atlas page, or -1 if standalone.
+  int m_nX = 0; ///< Left edge on page.
+  int m_nY = 0; ///< Top edge on page.
+}; //Image
+
+/// \brief An atlas page.
+
+struct Page{
+  int m_nWidth = 0; ///< Width in pixels.
+  int m_nHeight = 0; ///< Height used in pixels.
+  int m_nShelfY = 0; ///< Top of current shelf.
+  int m_nShelfH = 0; ///< Height of current shelf.
+  int m_nCursorX = 0; ///< Next free position on current shelf.
+}; //Page
+
+////////////////////////////////////////////////////////////////////////////////
+// PNG writer
+
+/// Append a 32-bit number in big-endian order, as PNG wants.
+/// \param v Bytes to append to.
+/// \param n Number.
+
+static void Put32(std::vector<uint8_t>& v, uint32_t n){
+  for(int s=24; s>=0; s-=8)
+    v.push_back((uint8_t)(n >> s));
+} //Put32
+
+/// Compute the CRC-32 that PNG puts at the end of each chunk.
+/// \param p Bytes.
+/// \param n Number of bytes.
+/// \return CRC-32.
+
+static uint32_t Crc32(const uint8_t* p, size_t n){
+  static uint32_t table[256] = {0}; //CRC of each byte value
+
+  if(table[1] == 0)
+    for(uint32_t i=0; i<256; i++){
+      uint32_t c = i;
+      for(int k=0; k<8; k++)c = c & 1? 0xEDB88320u ^ (c >> 1): c >> 1;
+      table[i] = c;
+    } //for
+
+  uint32_t crc = 0xFFFFFFFFu;
+
+  for(size_t i=0; i<n; i++)
+    crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+
+  return crc ^ 0xFFFFFFFFu;
+} //Crc32
+
+/// Append a PNG chunk, which is its length, type, data, and CRC.
+/// \param out Bytes to append to.
+/// \param type Four character chunk type.
+/// \param data Chunk data.
+
+static void PutChunk(std::vector<uint8_t>& out, const char* type,
+  const std::vector<uint8_t>& data)
+{
+  Put32(out, (uint32_t)data.size());
+  const size_t start = out.size(); //the CRC covers the type and data
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  Put32(out, Crc32(&out[start], out.size() - start));
+} //PutChunk
+
+/// Write RGBA pixels to a PNG file. Each row is unfiltered, and the zlib
+/// stream is made of stored deflate blocks, so there is no compression.
+/// \param name File name.
+/// \param w Width in pixels.
+/// \param h Height in pixels.
+/// \param rgba Pixels, 4 bytes each, rows top to bottom.
+/// \return true if the file was written.
+
+static bool WritePng(const std::string& name, int w, int h, const uint8_t* rgba){
+  const size_t row = (size_t)w*4; //bytes per row
+  std::vector<uint8_t> raw; //filter byte and pixels for each row
+  raw.reserve((size_t)h*(row + 1));
+
+  for(int y=0; y<h; y++){
+    raw.push_back(0); //no filter
+    raw.insert(raw.end(), rgba + y*row, rgba + (y + 1)*row);
+  } //for
+
+  std::vector<uint8_t> z = {0x78, 0x01}; //zlib header
+  size_t i = 0; //start of next block
+
+  do{
+    const size_t n = std::min<size_t>(raw.size() - i, 65535); //block size
+    z.push_back(i + n == raw.size()? 1: 0); //stored block, last or not
+    z.push_back((uint8_t)n); z.push_back((uint8_t)(n >> 8));
+    z.push_back((uint8_t)~n); z.push_back((uint8_t)(~n >> 8));
+    z.insert(z.end(), raw.begin() + i, raw.begin() + i + n);
+    i += n;
+  }while(i < raw.size());
+
+  uint32_t a = 1, b = 0; //Adler-32 sums
+
+  for(uint8_t x: raw){
+    a = (a + x)%65521;
+    b = (b + a)%65521;
+  } //for
+
+  Put32(z, (b << 16) | a);
+
+  std::vector<uint8_t> ihdr; //image header
+  Put32(ihdr, (uint32_t)w);
+  Put32(ihdr, (uint32_t)h);
+  ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0}); //8 bits per channel, RGBA
+
+  std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'}; //file
+  PutChunk(out, "IHDR", ihdr);
+  PutChunk(out, "IDAT", z);
+  PutChunk(out, "IEND", {});
+
+  FILE* f = fopen(name.c_str(), "wb");
+  if(f == nullptr)return false;
+
+  const bool bOK = fwrite(out.data(), out.size(), 1, f) == 1;
+  return fclose(f) == 0 && bOK;
+} //WritePng
+
+////////////////////////////////////////////////////////////////////////////////
+// Sprite list
+
+/// \brief A sprite that the game loads.
+
+struct Sprite{
+  const char* m_pEnum; ///< eSprite enumerator name.
+  const char* m_pName; ///< Sprite tag name in gamesettings.xml.
+}; //Sprite
+
+/// The sprites that the game loads, from the same list that the game uses.
+
+static const Sprite SPRITES[] = {
+  #define SPRITE(e, name) {#e, name},
+  #include "SpriteList.h"
+  #undef SPRITE
+}; //SPRITES
+
+////////////////////////////////////////////////////////////////////////////////
+// Input parsing
+
+/// Read a whole text file.
+/// \param filename File name.
+/// \param s [out] File contents.
+/// \return true if the file was read.
+
+static bool ReadFile(const std::string& filename, std::string& s){
+  std::ifstream in(filename, std::ios::binary);
+  if(!in)return false;
+  std::stringstream ss;
+  ss << in.rdbuf();
+  s = ss.str();
+  return true;
+} //ReadFile
+
+/// Get the value of an attribute from an XML tag, allowing white space
+/// around the equals sign.
+/// \param tag Text of tag.
+/// \param name Attribute name.
+/// \return Attribute value, or an empty string if it is not there.
+
+static std::string GetAttribute(const std::string& tag, const std::string& name){
+  for(size_t i=tag.find(name); i!=std::string::npos; i=tag.find(name, i + 1)){
+    if(i > 0 && !isspace((unsigned char)tag[i - 1]))continue; //part of another name
+
+    size_t j = i + name.size();
+    while(j < tag.size() && isspace((unsigned char)tag[j]))j++;
+    if(j >= tag.size() || tag[j] != '=')continue;
+    j++;
+    while(j < tag.size() && isspace((unsigned char)tag[j]))j++;
+    if(j >= tag.size() || tag[j] != '"')continue;
+
+    const size_t k = tag.find('"', j + 1);
+    if(k == std::string::npos)return "";
+    return tag.substr(j + 1, k - j - 1);
+  } //for
+
+  return "";
+} //GetAttribute
+
+/// Get the image files for each sprite name from `gamesettings.xml`. A sprite
+/// tag either names a single file, or a file name stem, an extension, and a
+/// number of frames, in which case the frame files are the stem followed by
+/// the frame number.
+/// \param xml Text of settings file.
+/// \param files [out] Map from sprite name to image files.
+
+static void ParseSettings(const std::string& xml,
+  std::map<std::string, std::vector<std::string>>& files)
+{
+  std::string path; //image directory
+
+  for(size_t i=xml.find('<'); i!=std::string::npos; i=xml.find('<', i + 1)){
+    if(xml.compare(i, 4, "<!--") == 0){ //skip comment
+      i = xml.find("-->", i);
+      if(i == std::string::npos)break;
+      continue;
+    } //if
+
+    const size_t j = xml.find('>', i);
+    if(j == std::string::npos)break;
+    const std::string tag = xml.substr(i, j - i + 1);
+
+    if(tag.compare(0, 9, "<sprites ") == 0){
+      path = GetAttribute(tag, "path");
+      std::replace(path.begin(), path.end(), '\\', '/');
+    } //if
+
+    else if(tag.compare(0, 8, "<sprite ") == 0){
+      const std::string name = GetAttribute(tag, "name");
+      const std::string file = GetAttribute(tag, "file");
+      const std::string ext = GetAttribute(tag, "ext");
+      const int frames = atoi(GetAttribute(tag, "frames").c_str());
+      std::vector<std::string>& v = files[name];
+
+      if(frames > 0)
+        for(int k=0; k<frames; k++)
+          v.push_back(path + "/" + file + std::to_string(k) + "." + ext);
+
+      else v.push_back(path + "/" + file);
+    } //else if
+  } //for
+} //ParseSettings
+
+////////////////////////////////////////////////////////////////////////////////
+// Packing
+
+/// Pack images onto pages using a shelf packer. Images are placed tallest
+/// first, left to right along the current shelf, starting a new shelf when
+/// the current one is full and a new page when the current page is full.
+/// Images with a dimension larger than half the page size are not packed.
+/// \param images Images.
+/// \param size Page width and height.
+/// \param pad Padding between images in pixels.
+/// \param pages [out] Pages.
+
+static void Pack(std::vector<Image>& images, int size, int pad,
+  std::vector<Page>& pages)
+{
+  std::vector<Image*> order;
+  for(Image& img: images)
+    if(std::max(img.m_nWidth, img.m_nHeight) <= size/2)
+      order.push_back(&img);
+
+  std::stable_sort(order.begin(), order.end(), [](const Image* a, const Image* b){
+    return a->m_nHeight > b->m_nHeight;
+  }); //sort
+
+  for(Image* img: order){
+    const int w = img->m_nWidth + pad; //padded width
+    const int h = img->m_nHeight + pad; //padded height
+
+    if(pages.empty())pages.push_back({size});
+    Page* p = &pages.back();
+
+    if(p->m_nCursorX + w > size){ //next shelf
+      p->m_nShelfY += p->m_nShelfH;
+      p->m_nShelfH = 0;
+      p->m_nCursorX = 0;
+    } //if
+
+    if(p->m_nShelfY + h > size){ //next page
+      pages.push_back({size});
+      p = &pages.back();
+    } //if
+
+    img->m_nPage = (int)pages.size() - 1;
+    img->m_nX = p->m_nCursorX;
+    img->m_nY = p->m_nShelfY;
+
+    p->m_nCursorX += w;
+    p->m_nShelfH = std::max(p->m_nShelfH, h);
+    p->m_nHeight = std::max(p->m_nHeight, p->m_nShelfY + h);
+  } //for
+} //Pack
+
+////////////////////////////////////////////////////////////////////////////////
+// Main
+
+int main(int argc, char* argv[]){
+  const std::string settingsFile = argc > 1? argv[1]: "Media/XML/gamesettings.xml";
+  const std::string outDir = argc > 2? argv[2]: "Atlas";
+  const int size = argc > 3? atoi(argv[3]): 2048;
+  const std::string sizesFile = argc > 4? argv[4]: "My Game/SpriteSizes.h";
+  const int pad = 2; //padding between images to stop bleeding under filtering
+
+  std::string xml;
+
+  if(!ReadFile(settingsFile, xml)){
+    fprintf(stderr, "Cannot read %s\n", settingsFile.c_str());
+    return 1;
+  } //if
+
+  std::map<std::string, std::vector<std::string>> files;
+  ParseSettings(xml, files);
+
+  //load images
+
+  std::vector<Image> images;
+
+  for(const Sprite& s: SPRITES){
+    const auto it = files.find(s.m_pName);
+
+    if(it == files.end()){
+      fprintf(stderr, "Sprite %s is not in %s\n", s.m_pName, settingsFile.c_str());
+      return 1;
+    } //if
+
+    for(unsigned f=0; f<it->second.size(); f++){
+      Image img;
+      img.m_strSprite = s.m_pEnum;
+      img.m_strFile = it->second[f];
+      img.m_nFrame = f;
+
+      int channels = 0;
+      uint8_t* p = stbi_load(img.m_strFile.c_str(), &img.m_nWidth, &img.m_nHeight, &channels, 4);
+
+      if(p == nullptr){
+        fprintf(stderr, "Cannot load %s: %s\n", img.m_strFile.c_str(), stbi_failure_reason());
+        return 1;
+      } //if
+
+      img.m_vecPixels.assign(p, p + (size_t)img.m_nWidth*img.m_nHeight*4);
+      stbi_image_free(p);
+      images.push_back(std::move(img));
+    } //for
+  } //for
+
+  //pack and write pages
+
+  std::vector<Page> pages;
+  Pack(images, size, pad, pages);
+
+  std::filesystem::create_directories(outDir);
+
+  for(size_t k=0; k<pages.size(); k++){
+    const Page& page = pages[k];
+    std::vector<uint8_t> rgba((size_t)page.m_nWidth*page.m_nHeight*4, 0);
+
+    for(const Image& img: images)
+      if(img.m_nPage == (int)k)
+        for(int y=0; y<img.m_nHeight; y++)
+          memcpy(&rgba[((size_t)(img.m_nY + y)*page.m_nWidth + img.m_nX)*4],
+            &img.m_vecPixels[(size_t)y*img.m_nWidth*4], (size_t)img.m_nWidth*4);
+
+    const std::string name = outDir + "/atlas" + std::to_string(k) + ".png";
+
+    if(!WritePng(name, page.m_nWidth, page.m_nHeight, rgba.data())){
+      fprintf(stderr, "Cannot write %s\n", name.c_str());
+      return 1;
+    } //if
+
+    printf("%s: %d x %d\n", name.c_str(), page.m_nWidth, page.m_nHeight);
+  } //for
+
+  //write UV table
+
+  const std::string headerName = outDir + "/AtlasTable.h";
+  FILE* out = fopen(headerName.c_str(), "w");
+
+  if(out == nullptr){
+    fprintf(stderr, "Cannot write %s\n", headerName.c_str());
+    return 1;
+  } //if
+
+  fprintf(out,
+    "/// \\file AtlasTable.h\n"
+    "/// \\brief Texture atlas table generated by AtlasBuilder. Do not edit.\n\n"
+    "#ifndef __L4RC_GAME_ATLASTABLE_H__\n"
+    "#define __L4RC_GAME_ATLASTABLE_H__\n\n"
+    "#include \"GameDefines.h\"\n\n"
+    "/// \\brief Atlas table entry.\n"
+    "///\n"
+    "/// The atlas page and texture coordinates of one frame of a sprite. A\n"
+    "/// page of -1 means that the frame is in its own image file.\n\n"
+    "struct AtlasEntry{\n"
+    "  eSprite m_eSprite; ///< Sprite type.\n"
+    "  UINT m_nFrame; ///< Frame number.\n"
+    "  int m_nPage; ///< Atlas page, or -1 if standalone.\n"
+    "  float m_fU0, m_fV0, m_fU1, m_fV1; ///< Texture coordinates.\n"
+    "  const char* m_pFile; ///< Image file.\n"
+    "}; //AtlasEntry\n\n"
+    "static const UINT NUM_ATLAS_PAGES = %zu; ///< Number of atlas pages.\n\n"
+    "static const AtlasEntry ATLAS_TABLE[] = {\n", pages.size());
+
+  size_t nPacked = 0; //number of frames on atlas pages
+
+  for(const Image& img: images){
+    float u0 = 0, v0 = 0, u1 = 1, v1 = 1;
+    std::string file = img.m_strFile;
+
+    if(img.m_nPage >= 0){
+      const Page& page = pages[img.m_nPage];
+      u0 = (float)img.m_nX/page.m_nWidth;
+      v0 = (float)img.m_nY/page.m_nHeight;
+      u1 = (float)(img.m_nX + img.m_nWidth)/page.m_nWidth;
+      v1 = (float)(img.m_nY + img.m_nHeight)/page.m_nHeight;
+      file = "atlas" + std::to_string(img.m_nPage) + ".png";
+      nPacked++;
+    } //if
+
+    fprintf(out, "  {eSprite::%s, %u, %d, %.6ff, %.6ff, %.6ff, %.6ff, \"%s\"},\n",
+      img.m_strSprite.c_str(), img.m_nFrame, img.m_nPage, u0, v0, u1, v1, file.c_str());
+  } //for
+
+  fprintf(out, "}; //ATLAS_TABLE\n\n#endif //__L4RC_GAME_ATLASTABLE_H__\n");
+  fclose(out);
+
+  printf("%s: %zu frames, %zu packed on %zu pages, %zu standalone\n",
+    headerName.c_str(), images.size(), nPacked, pages.size(), images.size() - nPacked);
+
+  //write sprite size table, from the first frame of each sprite
+
+  out = fopen(sizesFile.c_str(), "w");
+
+  if(out == nullptr){
+    fprintf(stderr, "Cannot write %s\n", sizesFile.c_str());
+    return 1;
+  } //if
+
+  fprintf(out,
+    "/// \\file SpriteSizes.h\n"
+    "/// \\brief Sprite size table generated by AtlasBuilder. Do not edit.\n\n"
+    "#ifndef __L4RC_GAME_SPRITESIZES_H__\n"
+    "#define __L4RC_GAME_SPRITESIZES_H__\n\n"
+    "#include \"GameDefines.h\"\n\n"
+    "/// \\brief Sprite size table entry.\n"
+    "///\n"
+    "/// The width and height in pixels of the first frame of a sprite, which\n"
+    "/// are what the renderer reports for it once it is loaded.\n\n"
+    "struct SpriteSize{\n"
+    "  eSprite m_eSprite; ///< Sprite type.\n"
+    "  UINT m_nWidth; ///< Width in pixels.\n"
+    "  UINT m_nHeight; ///< Height in pixels.\n"
+    "}; //SpriteSize\n\n"
+    "static const SpriteSize SPRITE_SIZES[] = {\n");
+
+  for(const Image& img: images)
+    if(img.m_nFrame == 0)
+      fprintf(out, "  {eSprite::%s, %d, %d},\n", img.m_strSprite.c_str(),
+        img.m_nWidth, img.m_nHeight);
+
+  fprintf(out, "}; //SPRITE_SIZES\n\n#endif //__L4RC_GAME_SPRITESIZES_H__\n");
+  fclose(out);
+
+  printf("%s: %zu sprites\n", sizesFile.c_str(), sizeof(SPRITES)/sizeof(SPRITES[0]));
+
+  return 0;
+} //main
@@ -0,0 +1,107 @@
+/// \file DecodeBench.cpp
+/// \brief Headless benchmark for the image decode stage of game startup.
+///
+/// Decodes every PNG in a directory with the `stb_image.h` bundled with the
+/// game, one after another on one thread the way that `CGame::LoadImages()`
+/// does. The game decodes and uploads each image on the main thread, a few
+/// per frame while the title screen is showing, so this reports the total
+/// decode time and the slowest batch of images decoded in one frame, which
+/// is the longest that decoding can stall a title screen frame. No window or
+/// graphics device is needed, so this can be run on a build server. Build
+/// and run it from the root of the repository with
+///
+///     g++ -O2 -std=c++17 -I"My Game" Tools/DecodeBench/DecodeBench.cpp -o decodebench
+///     ./decodebench Media/Images 3 4
+///
+/// The arguments are the image directory (default `Media/Images`), the
+/// number of times to repeat the measurement (default 3), and the number of
+/// images loaded per frame (default 4, the same as `CGame`). The best time
+/// of the repeats is reported.
+
+#define STBI_ASSERT(x)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// Decode an image and throw the pixels away.
+/// \param filename Name of image file.
+/// \return Number of bytes of pixels decoded, or 0 if the decode failed.
+
+static size_t Decode(const std::string& filename){
+  int w = 0, h = 0, channels = 0;
+  unsigned char* pixels = stbi_load(filename.c_str(), &w, &h, &channels, 4);
+  if(pixels == nullptr)return 0;
+  stbi_image_free(pixels);
+  return (size_t)w*h*4;
+} //Decode
+
+/// Decode all images one after another, a batch at a time.
+/// \param files Image file names.
+/// \param nPerFrame Number of images in a batch.
+/// \param slowest [out] Time taken by the slowest batch in milliseconds.
+/// \param bytes [out] Total number of bytes of pixels decoded.
+/// \return Elapsed time in milliseconds.
+
+static double DecodeAll(const std::vector<std::string>& files, size_t nPerFrame,
+  double& slowest, size_t& bytes)
+{
+  const auto start = std::chrono::steady_clock::now();
+  slowest = 0;
+  bytes = 0;
+
+  for(size_t i=0; i<files.size(); i+=nPerFrame){
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for(size_t j=i; j<std::min(i + nPerFrame, files.size()); j++)
+      bytes += Decode(files[j]);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    slowest = std::max(slowest, std::chrono::duration<double, std::milli>(t1 - t0).count());
+  } //for
+
+  const auto finish = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(finish - start).count();
+} //DecodeAll
+
+int main(int argc, char* argv[]){
+  const std::string dir = argc > 1? argv[1]: "Media/Images"; //image directory
+  const int nRepeats = argc > 2? std::max(1, atoi(argv[2])): 3; //repeats
+  const size_t nPerFrame = argc > 3? (size_t)std::max(1, atoi(argv[3])): 4; //images per frame
+
+  std::vector<std::string> files; //image file names
+
+  std::error_code err;
+  for(const auto& entry: std::filesystem::directory_iterator(dir, err))
+    if(entry.path().extension() == ".png")
+      files.push_back(entry.path().string());
+
+  if(files.empty()){
+    fprintf(stderr, "No PNG files found in %s\n", dir.c_str());
+    return 1;
+  } //if
+
+  std::sort(files.begin(), files.end()); //same order every run
+
+  double best = 0, bestSlowest = 0; //best times in milliseconds
+  size_t bytes = 0; //bytes of pixels decoded
+
+  for(int i=0; i<nRepeats; i++){
+    double slowest = 0; //slowest batch this time
+    const double t = DecodeAll(files, nPerFrame, slowest, bytes);
+
+    if(i == 0 || t < best)best = t;
+    if(i == 0 || slowest < bestSlowest)bestSlowest = slowest;
+  } //for
+
+  printf("%zu images in %s, %.1f MB decoded\n", files.size(), dir.c_str(), bytes/1048576.0);
+  printf("total         %8.2f ms\n", best);
+  printf("slowest frame %8.2f ms for %zu images\n", bestSlowest, nPerFrame);
+  return 0;
+} //main
@@ -0,0 +1,356 @@
+/// \file RewindBench.cpp
+/// \brief Headless benchmark for the lag compensation position history.
+///
+/// Moves a crowd of zombies around a world without a window, recording
+/// their positions every tick in the game's own `CPositionHistory` the way
+/// that a session does, and fires shots that are rewound to where the
+/// zombies were a few ticks ago. Only the position history is the game's.
+/// The grid, the sweep, and the rewind loop are a model of `CSpatialGrid`,
+/// `SweepCircleVsCircle()`, and `CBulletManager::CatchUp()` written on plain
+/// structs, since the real ones need the game's objects, so the shot times
+/// are for the model and not for the shipped code. They leave out walls,
+/// static objects, and the object manager's query buffers. Each rewound shot
+/// is tested twice, once against the candidates from the grid of the current
+/// positions grown by the history's drift, and once against every zombie,
+/// and the two must agree, which checks that growing the query by the drift
+/// is enough. It reports the memory used per zombie and the time taken to
+/// record a tick, which are the history's own, and the time taken to rewind
+/// a shot and to rewind every zombie. Build and run it from the root of the
+/// repository with
+///
+///     g++ -O2 -std=c++17 -I"My Game" Tools/RewindBench/RewindBench.cpp "My Game/PositionHistory.cpp" -o rewindbench
+///     ./rewindbench --zombies 1000 --rewind 6
+///
+/// The options are `--zombies` (1000), `--width` and `--height` of the
+/// world in pixels (3040 and 1408, which is `map1`), `--ticks` to play
+/// (1800, which is a minute), `--rewind` for the ticks to rewind a shot (6,
+/// which is 200 ms), `--depth` for the ticks kept (8), `--shots` per tick
+/// (8), and `--seed` (1).
+///
+/// The zombies wander at 1 pixel per tick the same as in a session, and now
+/// and then one is knocked back 50 pixels, which is the farthest that
+/// anything moves in a tick. Bullets move 15 pixels per tick, which is 450
+/// pixels per second at 30 ticks per second.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PositionHistory.h"
+
+//constants from the game
+
+static const float ZOMBIE_RADIUS = 22.5f; ///< Zombie bounding circle radius.
+static const float BULLET_RADIUS = 4.0f; ///< Bullet radius.
+static const float BULLET_STEP = 15.0f; ///< Bullet movement per tick.
+static const float KNOCKBACK = 50.0f; ///< Knockback distance.
+static const float CELL_SIZE = 256.0f; ///< Same as `CSpatialGrid`.
+static const float PI = 3.14159265f; ///< Pi.
+
+/// \brief A zombie.
+
+struct Zombie{
+  uint32_t m_nId = 0; ///< Network identifier.
+  float m_fX = 0; ///< X coordinate.
+  float m_fY = 0; ///< Y coordinate.
+  float m_fHeading = 0; ///< Direction of travel in radians.
+}; //Zombie
+
+/// \brief A model of `CSpatialGrid` for zombies.
+///
+/// Rebuilt every tick by a counting sort on the cell containing each
+/// zombie's center, the same way as `CSpatialGrid`.
+
+struct Grid{
+  int m_nWide = 0; ///< Cells wide.
+  int m_nHigh = 0; ///< Cells high.
+  std::vector<uint32_t> m_vecStart; ///< Start of each cell in m_vecIndex.
+  std::vector<uint32_t> m_vecIndex; ///< Zombie indices sorted by cell.
+
+  int CellX(float x) const{return std::min(std::max((int)(x/CELL_SIZE), 0), m_nWide - 1);}
+  int CellY(float y) const{return std::min(std::max((int)(y/CELL_SIZE), 0), m_nHigh - 1);}
+
+  /// Rebuild the grid.
+  /// \param z Zombies.
+
+  void Build(const std::vector<Zombie>& z){
+    m_vecStart.assign((size_t)m_nWide*m_nHigh + 1, 0);
+    m_vecIndex.resize(z.size());
+
+    for(const Zombie& p: z)
+      m_vecStart[CellY(p.m_fY)*m_nWide + CellX(p.m_fX) + 1]++;
+
+    for(size_t i=1; i<m_vecStart.size(); i++)
+      m_vecStart[i] += m_vecStart[i - 1];
+
+    std::vector<uint32_t> next(m_vecStart.begin(), m_vecStart.end() - 1);
+
+    for(uint32_t i=0; i<(uint32_t)z.size(); i++)
+      m_vecIndex[next[CellY(z[i].m_fY)*m_nWide + CellX(z[i].m_fX)]++] = i;
+  } //Build
+
+  /// Find the zombies whose centers are in cells that overlap a rectangle,
+  /// grown by a zombie's radius.
+  /// \param x0 Left.
+  /// \param y0 Bottom.
+  /// \param x1 Right.
+  /// \param y1 Top.
+  /// \param out [out] Zombie indices.
+
+  void Query(float x0, float y0, float x1, float y1, std::vector<uint32_t>& out) const{
+    out.clear();
+
+    for(int y=CellY(y0 - ZOMBIE_RADIUS); y<=CellY(y1 + ZOMBIE_RADIUS); y++)
+      for(int x=CellX(x0 - ZOMBIE_RADIUS); x<=CellX(x1 + ZOMBIE_RADIUS); x++){
+        const size_t c = (size_t)y*m_nWide + x; //cell
+        out.insert(out.end(), m_vecIndex.begin() + m_vecStart[c],
+          m_vecIndex.begin() + m_vecStart[c + 1]);
+      } //for
+  } //Query
+}; //Grid
+
+/// Sweep a moving circle against a fixed one, the same as
+/// `SweepCircleVsCircle()`.
+/// \param px Moving circle x.
+/// \param py Moving circle y.
+/// \param vx Displacement x.
+/// \param vy Displacement y.
+/// \param r Sum of the radii.
+/// \param cx Fixed circle x.
+/// \param cy Fixed circle y.
+/// \param t [out] Fraction of displacement at contact.
+/// \return true if they touch during the displacement.
+
+static bool Sweep(float px, float py, float vx, float vy, float r, float cx,
+  float cy, float& t)
+{
+  const float dx = px - cx, dy = py - cy;
+  const float c = dx*dx + dy*dy - r*r;
+
+  if(c <= 0){ //already touching
+    t = 0;
+    return true;
+  } //if
+
+  const float a = vx*vx + vy*vy, b = dx*vx + dy*vy;
+  const float disc = b*b - a*c;
+  if(a == 0 || b >= 0 || disc < 0)return false;
+
+  t = (-b - sqrtf(disc))/a;
+  return t <= 1;
+} //Sweep
+
+/// \brief A shot.
+
+struct Shot{
+  float m_fX = 0; ///< Muzzle x.
+  float m_fY = 0; ///< Muzzle y.
+  float m_fDX = 0; ///< Direction x.
+  float m_fDY = 0; ///< Direction y.
+}; //Shot
+
+/// Rewind a shot the way that `CBulletManager::CatchUp()` does, moving the
+/// bullet one step for each tick from `from` up to the newest tick in the
+/// history, and testing it at each step against where the zombies were at
+/// that tick.
+/// \param h Position history.
+/// \param z Zombies, as they are now.
+/// \param grid Grid of the zombies as they are now, or `nullptr` to test
+/// every zombie.
+/// \param s Shot.
+/// \param from Tick the shooter was looking at.
+/// \param cand Candidate buffer.
+/// \return Identifier of the zombie hit, or 0 for none.
+
+static uint32_t Rewind(const CPositionHistory& h, const std::vector<Zombie>& z,
+  const Grid* grid, const Shot& s, uint32_t from, std::vector<uint32_t>& cand)
+{
+  float px = s.m_fX, py = s.m_fY;
+  const float vx = s.m_fDX*BULLET_STEP, vy = s.m_fDY*BULLET_STEP;
+
+  for(uint32_t tick=std::max(from, h.GetOldest()); tick<h.GetNewest(); tick++){
+    uint32_t hit = 0;
+    float best = 1;
+
+    if(grid){
+      const float d = h.GetDrift(tick) + BULLET_RADIUS;
+      grid->Query(std::min(px, px + vx) - d, std::min(py, py + vy) - d,
+        std::max(px, px + vx) + d, std::max(py, py + vy) + d, cand);
+    } //if
+
+    else{
+      cand.resize(z.size());
+      for(uint32_t i=0; i<(uint32_t)z.size(); i++)cand[i] = i;
+    } //else
+
+    for(uint32_t i: cand){
+      float x, y, t;
+
+      if(h.GetPos(z[i].m_nId, tick, x, y) &&
+        Sweep(px, py, vx, vy, ZOMBIE_RADIUS + BULLET_RADIUS, x, y, t) &&
+        (t < best || (t == best && hit != 0 && z[i].m_nId < hit)))
+      {
+        best = t;
+        hit = z[i].m_nId;
+      } //if
+    } //for
+
+    if(hit)return hit;
+
+    px += vx;
+    py += vy;
+  } //for
+
+  return 0;
+} //Rewind
+
+int main(int argc, char* argv[]){
+  int nZombies = 1000; //number of zombies
+  float fWidth = 3040, fHeight = 1408; //world size
+  int nTicks = 1800; //ticks to play
+  int nRewind = 6; //ticks to rewind
+  int nDepth = 8; //ticks kept
+  int nShots = 8; //shots per tick
+  uint32_t seed = 1; //seed
+
+  for(int i=1; i+1<argc; i+=2){
+    const std::string opt = argv[i], val = argv[i + 1];
+
+    if(opt == "--zombies")nZombies = std::max(1, atoi(val.c_str()));
+    else if(opt == "--width")fWidth = std::max(1.0f, (float)atof(val.c_str()));
+    else if(opt == "--height")fHeight = std::max(1.0f, (float)atof(val.c_str()));
+    else if(opt == "--ticks")nTicks = std::max(1, atoi(val.c_str()));
+    else if(opt == "--rewind")nRewind = std::max(0, atoi(val.c_str()));
+    else if(opt == "--depth")nDepth = std::max(1, atoi(val.c_str()));
+    else if(opt == "--shots")nShots = std::max(0, atoi(val.c_str()));
+    else if(opt == "--seed")seed = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+
+    else{
+      fprintf(stderr, "Unknown option %s\n", opt.c_str());
+      return 1;
+    } //else
+  } //for
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+  std::vector<Zombie> zombies(nZombies);
+  uint32_t nLastId = 0;
+
+  for(Zombie& p: zombies){
+    p.m_nId = ++nLastId;
+    p.m_fX = unit(rng)*fWidth;
+    p.m_fY = unit(rng)*fHeight;
+    p.m_fHeading = (2*unit(rng) - 1)*PI;
+  } //for
+
+  CPositionHistory history(nDepth);
+  Grid grid;
+  grid.m_nWide = std::max(1, (int)ceilf(fWidth/CELL_SIZE));
+  grid.m_nHigh = std::max(1, (int)ceilf(fHeight/CELL_SIZE));
+
+  std::vector<uint32_t> cand;
+  double fRecord = 0, fGrid = 0, fBrute = 0, fAll = 0; //seconds
+  size_t nQueries = 0, nHits = 0, nAll = 0;
+  size_t nBytes = 0; //most memory used
+
+  printf("%d zombies in %.0fx%.0f, %d ticks, rewind %d ticks, %d shots per tick\n",
+    nZombies, fWidth, fHeight, nTicks, nRewind, nShots);
+
+  for(uint32_t tick=1; tick<=(uint32_t)nTicks; tick++){
+
+    //move the zombies, replacing a few with new ones
+
+    for(Zombie& p: zombies){
+      if(unit(rng) < 0.01f)p.m_fHeading = (2*unit(rng) - 1)*PI;
+      const float step = unit(rng) < 0.002f? KNOCKBACK: 1.0f;
+
+      p.m_fX = std::min(std::max(p.m_fX + step*cosf(p.m_fHeading), 0.0f), fWidth);
+      p.m_fY = std::min(std::max(p.m_fY + step*sinf(p.m_fHeading), 0.0f), fHeight);
+
+      if(unit(rng) < 0.001f){ //killed, and another one spawned
+        p.m_nId = ++nLastId;
+        p.m_fX = unit(rng)*fWidth;
+        p.m_fY = unit(rng)*fHeight;
+      } //if
+    } //for
+
+    //record them
+
+    auto start = std::chrono::steady_clock::now();
+
+    history.Begin(tick);
+    for(const Zombie& p: zombies)
+      history.Record(p.m_nId, p.m_fX, p.m_fY);
+    history.End();
+
+    fRecord += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    nBytes = std::max(nBytes, history.GetBytes());
+    grid.Build(zombies);
+
+    if(tick <= (uint32_t)nRewind)continue;
+    const uint32_t from = tick - nRewind; //tick the shooter saw
+
+    //rewind some shots from near random zombies
+
+    for(int k=0; k<nShots; k++){
+      const Zombie& target = zombies[rng()%zombies.size()];
+      const float a = (2*unit(rng) - 1)*PI;
+      const float d = 60 + 100*unit(rng);
+
+      Shot s;
+      s.m_fX = target.m_fX - d*cosf(a);
+      s.m_fY = target.m_fY - d*sinf(a);
+      s.m_fDX = cosf(a + 0.2f*(unit(rng) - 0.5f));
+      s.m_fDY = sinf(a + 0.2f*(unit(rng) - 0.5f));
+
+      start = std::chrono::steady_clock::now();
+      const uint32_t hit = Rewind(history, zombies, &grid, s, from, cand);
+      fGrid += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      start = std::chrono::steady_clock::now();
+      const uint32_t check = Rewind(history, zombies, nullptr, s, from, cand);
+      fBrute += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      if(hit != check){
+        fprintf(stderr, "Tick %u: grid hit %u but every zombie hit %u\n", tick, hit, check);
+        return 1;
+      } //if
+
+      nQueries++;
+      if(hit)nHits++;
+    } //for
+
+    //rewind every zombie
+
+    start = std::chrono::steady_clock::now();
+    volatile float sum = 0; //stops the optimizer removing the work
+
+    for(const Zombie& p: zombies){
+      float x, y;
+
+      if(history.GetPos(p.m_nId, from, x, y)){
+        sum += x + y;
+        nAll++;
+      } //if
+    } //for
+
+    fAll += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } //for
+
+  const int nRewound = std::max(1, nTicks - nRewind); //ticks with shots
+
+  printf("\nmemory        %zu bytes, %.1f per zombie\n", nBytes, (double)nBytes/nZombies);
+  printf("record        %.2f us per tick\n", 1e6*fRecord/nTicks);
+  printf("model of the rewind path, not the game's grid or bullet manager:\n");
+  printf("rewind shot   %.2f us with grid, %.2f us against every zombie (%zu shots, %.0f%% hit)\n",
+    1e6*fGrid/std::max<size_t>(nQueries, 1), 1e6*fBrute/std::max<size_t>(nQueries, 1),
+    nQueries, 100.0*nHits/std::max<size_t>(nQueries, 1));
+  printf("rewind all    %.2f us for %.0f zombies\n", 1e6*fAll/nRewound, (double)nAll/nRewound);
+  return 0;
+} //main
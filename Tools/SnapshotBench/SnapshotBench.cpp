@@ -0,0 +1,504 @@
+/// \file SnapshotBench.cpp
+/// \brief Headless benchmark for the network snapshot codec.
+///
+/// Plays one night of a map without a window or a network, encoding a
+/// snapshot of the objects every tick with the game's own `CSnapshotCodec`
+/// the way that a session does, and reports how many bytes a snapshot takes
+/// and how fast the codec is. There are two clients: one that gets every
+/// object, and one that only gets the objects near its view, chosen by the
+/// game's own `CSnapshotFilter`. Build and run it from the root of the
+/// repository with
+///
+///     g++ -O2 -std=c++17 -I"My Game" Tools/SnapshotBench/SnapshotBench.cpp "My Game/SnapshotCodec.cpp" -o snapshotbench
+///     ./snapshotbench --zombies 70 --turrets 70 --latency 3 --loss 0.05
+///
+/// The options are `--map` (`Media/Maps/map1.txt`), `--zombies` and
+/// `--turrets` spawned at the map's `Z` and `T` positions, reusing positions
+/// if the map has too few (70 each, which is the most in a night),
+/// `--repeat` for a world made of that many copies of the map across and up
+/// (1), `--ticks` to play (1800, which is a minute), `--latency` in ticks
+/// before the client's acknowledgement of a snapshot reaches the server (3),
+/// `--loss` for the fraction of snapshots lost (0), `--seed` (1), `--view`
+/// for the client window size (`1920x1080`), `--margin` for the width of the
+/// border around the view (256), `--budget` for the most border objects sent
+/// per snapshot (16), and `--reps` for the number of thousands of times a
+/// snapshot is encoded and decoded when timing the codec (20).
+///
+/// Only the codec and filter are the game's. This build doesn't link the
+/// object classes, so the traffic is made by a script at the session's 30
+/// ticks per second: zombies and turrets wander at 1 pixel per tick and turn
+/// towards where they are going, turrets flip between their two sprites
+/// every 25 ticks, the player walks around the farm, and now and then
+/// something is shot and loses health or dies. The sizes are typical of a
+/// session rather than measured from one. Every snapshot is decoded again
+/// and checked against what was encoded.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SnapshotCodec.h"
+
+//constants from the game
+
+static const float TILE_SIZE = 32.0f; ///< Tile width and height in pixels.
+static const float PI = 3.14159265f; ///< Pi.
+static const uint32_t NUM_SPRITES = 54; ///< Size of `eSprite`.
+static const uint32_t SPRITE_PLAYER = 4; ///< `eSprite::Player`.
+static const uint32_t SPRITE_TURRET = 5; ///< `eSprite::Turret`.
+static const uint32_t SPRITE_TURRET2 = 22; ///< `eSprite::Turret2`.
+static const uint32_t SPRITE_ZOMBIE = 28; ///< `eSprite::Zombie2`.
+static const uint32_t PLAYER_HEALTH = 12; ///< Player maximum health.
+static const uint32_t TURRET_HEALTH = 8; ///< Turret maximum health.
+static const uint32_t ZOMBIE_HEALTH = 4; ///< Zombie maximum health.
+static const size_t HISTORY = 32; ///< Same as `NET_HISTORY`.
+static const size_t RECORD_SIZE = 44; ///< Size of a `CSavedObject`.
+
+/// \brief A 2D position.
+
+struct Vec{
+  float x = 0; ///< Horizontal component.
+  float y = 0; ///< Vertical component.
+}; //Vec
+
+/// \brief The map.
+///
+/// Just the size and spawn positions of a map file, in world coordinates
+/// with the origin at the bottom left the same way as `CTileManager`.
+
+struct Map{
+  int m_nWidth = 0; ///< Width in tiles.
+  int m_nHeight = 0; ///< Height in tiles.
+  std::vector<Vec> m_vecZombies; ///< Zombie spawn positions.
+  std::vector<Vec> m_vecTurrets; ///< Turret spawn positions.
+  Vec m_vPlayer; ///< Player start.
+}; //Map
+
+/// Read a map file in the format that `CTileManager::ParseMap()` reads.
+/// \param filename Name of map file.
+/// \param map [out] Map.
+/// \return true if the map was read.
+
+static bool LoadMap(const std::string& filename, Map& map){
+  std::ifstream input(filename);
+  if(!input)return false;
+
+  std::vector<std::string> rows;
+  std::string line;
+
+  while(std::getline(input, line)){
+    if(!line.empty() && line.back() == '\r')line.pop_back();
+    if(!line.empty())rows.push_back(line);
+  } //while
+
+  if(rows.empty())return false;
+
+  map.m_nHeight = (int)rows.size();
+  map.m_nWidth = (int)rows[0].size();
+
+  for(int i=0; i<map.m_nHeight; i++)
+    for(int j=0; j<map.m_nWidth && j<(int)rows[i].size(); j++){
+      const Vec pos = {(j + 0.5f)*TILE_SIZE, (map.m_nHeight - i - 0.5f)*TILE_SIZE};
+
+      switch(rows[i][j]){
+        case 'Z': map.m_vecZombies.push_back(pos); break;
+        case 'T': map.m_vecTurrets.push_back(pos); break;
+        case 'P': map.m_vPlayer = pos; break;
+        default: break;
+      } //switch
+    } //for
+
+  return true;
+} //LoadMap
+
+/// \brief A simulated object.
+
+struct Walker{
+  CNetObject m_cNet; ///< Networked state.
+  float m_fHeading = 0; ///< Direction of travel in radians.
+  bool m_bDead = false; ///< Ready to be removed.
+}; //Walker
+
+/// \brief The world.
+///
+/// The objects, which are kept in order of network identifier the same way
+/// that `CObjectManager` keeps them in order of creation.
+
+struct World{
+  std::vector<Walker> m_vecWalkers; ///< Objects, including the player.
+  uint32_t m_nLastId = 0; ///< Last network identifier.
+  float m_fWidth = 0; ///< World width in pixels.
+  float m_fHeight = 0; ///< World height in pixels.
+  std::mt19937 m_cRng; ///< Random number generator.
+
+  /// Create an object.
+  /// \param type Sprite type.
+  /// \param pos Position.
+  /// \param health Health.
+
+  void Create(uint32_t type, const Vec& pos, uint32_t health){
+    std::uniform_real_distribution<float> angle(-PI, PI);
+    Walker w;
+    w.m_cNet.m_nId = ++m_nLastId;
+    w.m_cNet.m_nType = w.m_cNet.m_nSprite = type;
+    w.m_cNet.m_fX = pos.x;
+    w.m_cNet.m_fY = pos.y;
+    w.m_cNet.m_fRoll = w.m_fHeading = angle(m_cRng);
+    w.m_cNet.m_nHealth = health;
+    m_vecWalkers.push_back(w);
+  } //Create
+
+  /// Move everything one tick.
+  /// \param tick Tick number.
+
+  void Step(uint32_t tick){
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for(Walker& w: m_vecWalkers){
+      CNetObject& n = w.m_cNet;
+
+      if(n.m_nType == SPRITE_PLAYER){ //circle the start
+        n.m_fX += 3.0f*cosf(tick/60.0f);
+        n.m_fY += 3.0f*sinf(tick/60.0f);
+        n.m_fRoll = tick/60.0f + PI/2;
+        continue;
+      } //if
+
+      if(unit(m_cRng) < 0.01f) //pick a new direction now and then
+        w.m_fHeading = (unit(m_cRng)*2 - 1)*PI;
+
+      n.m_fX += cosf(w.m_fHeading);
+      n.m_fY += sinf(w.m_fHeading);
+
+      if(n.m_fX < 0 || n.m_fX >= m_fWidth || n.m_fY < 0 || n.m_fY >= m_fHeight){
+        n.m_fX = std::min(std::max(n.m_fX, 0.0f), m_fWidth - 1);
+        n.m_fY = std::min(std::max(n.m_fY, 0.0f), m_fHeight - 1);
+        w.m_fHeading += PI; //bounce off the edge
+      } //if
+
+      float diff = remainderf(w.m_fHeading - n.m_fRoll, 2*PI); //turn towards heading
+      n.m_fRoll = remainderf(n.m_fRoll + std::min(std::max(diff, -0.05f), 0.05f), 2*PI);
+
+      if(n.m_nType == SPRITE_TURRET && tick%25 == 0)
+        n.m_nSprite = n.m_nSprite == SPRITE_TURRET? SPRITE_TURRET2: SPRITE_TURRET;
+
+      if(unit(m_cRng) < 0.002f && --n.m_nHealth == 0) //shot
+        w.m_bDead = true;
+    } //for
+
+    m_vecWalkers.erase(std::remove_if(m_vecWalkers.begin(), m_vecWalkers.end(),
+      [](const Walker& w){return w.m_bDead;}), m_vecWalkers.end());
+  } //Step
+
+  /// Get the networked objects.
+  /// \param v [out] Networked objects.
+
+  void GetNetObjects(std::vector<CNetObject>& v) const{
+    v.clear();
+    for(const Walker& w: m_vecWalkers)
+      v.push_back(w.m_cNet);
+  } //GetNetObjects
+}; //World
+
+/// Whether two quantized snapshots are the same.
+/// \param a One snapshot.
+/// \param b The other snapshot.
+/// \return true if they are the same.
+
+static bool Same(const std::vector<CNetQuantized>& a, const std::vector<CNetQuantized>& b){
+  if(a.size() != b.size())return false;
+
+  for(size_t i=0; i<a.size(); i++)
+    if(a[i].m_nId != b[i].m_nId || a[i].m_nType != b[i].m_nType ||
+      a[i].m_nSprite != b[i].m_nSprite || a[i].m_nX != b[i].m_nX ||
+      a[i].m_nY != b[i].m_nY || a[i].m_nRoll != b[i].m_nRoll ||
+      a[i].m_nHealth != b[i].m_nHealth)
+      return false;
+
+  return true;
+} //Same
+
+/// \brief A simulated client.
+///
+/// The server's and the client's ends of one client's connection, which
+/// either gets every object or only the ones near its view.
+
+struct Client{
+  bool m_bFiltered = false; ///< Only gets the objects near its view.
+  CSnapshotFilter m_cFilter; ///< Chooses the objects to send.
+  CSnapshotRing m_cSent{HISTORY}; ///< Snapshots sent.
+  CSnapshotRing m_cReceived{HISTORY}; ///< Snapshots received.
+  std::vector<uint32_t> m_vecAcks; ///< Acknowledgement arriving at each tick.
+  uint32_t m_nAck = 0; ///< Newest tick acknowledged to the server.
+  uint32_t m_nNewest = 0; ///< Newest tick received by the client.
+  uint32_t m_nLastSent = 0; ///< Newest tick sent.
+
+  std::vector<size_t> m_vecBytes; ///< Encoded size of each snapshot.
+  size_t m_nObjects = 0; ///< Total objects in snapshots.
+  size_t m_nLost = 0; ///< Snapshots lost.
+  double m_fSeconds = 0; ///< Time spent choosing and encoding.
+
+  Client(bool filtered, float margin, size_t budget):
+    m_bFiltered(filtered), m_cFilter(margin, budget){}
+}; //Client
+
+/// Get a percentile of a sorted list.
+/// \param v Sorted values.
+/// \param f Fraction, from 0 to 1.
+/// \return Percentile.
+
+static size_t Percentile(const std::vector<size_t>& v, double f){
+  return v[std::min(v.size() - 1, (size_t)(f*v.size()))];
+} //Percentile
+
+/// Get the view of a client whose camera follows the player and is clamped
+/// to the world, the same way as `CSession::GetView()`.
+/// \param world World.
+/// \param w View width.
+/// \param h View height.
+/// \return View rectangle.
+
+static CNetRect GetView(const World& world, float w, float h){
+  const CNetObject& p = world.m_vecWalkers[0].m_cNet; //player
+  const float pad = 64.0f; //half the largest moving sprite
+
+  const float x = world.m_fWidth > w?
+    std::min(std::max(p.m_fX, w/2), world.m_fWidth - w/2): world.m_fWidth/2;
+  const float y = world.m_fHeight > h?
+    std::min(std::max(p.m_fY, h/2), world.m_fHeight - h/2): world.m_fHeight/2;
+
+  CNetRect r;
+  r.m_fLeft = x - w/2 - pad;
+  r.m_fBottom = y - h/2 - pad;
+  r.m_fRight = x + w/2 + pad;
+  r.m_fTop = y + h/2 + pad;
+  return r;
+} //GetView
+
+int main(int argc, char* argv[]){
+  std::string mapfile = "Media/Maps/map1.txt"; //map file name
+  int nZombies = 70; //zombies to spawn
+  int nTurrets = 70; //turrets to spawn
+  int nTicks = 1800; //ticks to play
+  int nLatency = 3; //ticks before an acknowledgement arrives
+  double fLoss = 0; //fraction of snapshots lost
+  uint32_t seed = 1; //seed
+  int nReps = 20; //timing repetitions
+  int nRepeat = 1; //copies of the map across and up
+  float fViewWidth = 1920, fViewHeight = 1080; //client window size
+  float fMargin = 256; //border around the view
+  int nBudget = 16; //border objects sent per snapshot
+
+  for(int i=1; i+1<argc; i+=2){
+    const std::string opt = argv[i], val = argv[i + 1];
+
+    if(opt == "--map")mapfile = val;
+    else if(opt == "--zombies")nZombies = std::max(0, atoi(val.c_str()));
+    else if(opt == "--turrets")nTurrets = std::max(0, atoi(val.c_str()));
+    else if(opt == "--ticks")nTicks = std::max(1, atoi(val.c_str()));
+    else if(opt == "--latency")nLatency = std::min(std::max(0, atoi(val.c_str())), (int)HISTORY - 2);
+    else if(opt == "--loss")fLoss = std::min(std::max(0.0, atof(val.c_str())), 1.0);
+    else if(opt == "--seed")seed = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+    else if(opt == "--reps")nReps = std::max(1, atoi(val.c_str()));
+    else if(opt == "--repeat")nRepeat = std::max(1, atoi(val.c_str()));
+    else if(opt == "--view")sscanf(val.c_str(), "%fx%f", &fViewWidth, &fViewHeight);
+    else if(opt == "--margin")fMargin = (float)atof(val.c_str());
+    else if(opt == "--budget")nBudget = std::max(0, atoi(val.c_str()));
+
+    else{
+      fprintf(stderr, "Unknown option %s\n", opt.c_str());
+      return 1;
+    } //else
+  } //for
+
+  Map map;
+
+  if(!LoadMap(mapfile, map)){
+    fprintf(stderr, "Cannot read map %s\n", mapfile.c_str());
+    return 1;
+  } //if
+
+  if((nZombies > 0 && map.m_vecZombies.empty()) || (nTurrets > 0 && map.m_vecTurrets.empty())){
+    fprintf(stderr, "Map %s has no spawn positions\n", mapfile.c_str());
+    return 1;
+  } //if
+
+  if(map.m_nWidth*nRepeat > 256 || map.m_nHeight*nRepeat > 256)
+    printf("Warning: the codec clamps positions to 256 tiles\n");
+
+  //spawn the night, in each copy of the map
+
+  World world;
+  world.m_fWidth = map.m_nWidth*nRepeat*TILE_SIZE;
+  world.m_fHeight = map.m_nHeight*nRepeat*TILE_SIZE;
+  world.m_cRng.seed(seed);
+
+  world.Create(SPRITE_PLAYER, map.m_vPlayer, PLAYER_HEALTH);
+
+  for(int r=0; r<nRepeat*nRepeat; r++){
+    const float dx = (r%nRepeat)*map.m_nWidth*TILE_SIZE; //copy offset
+    const float dy = (r/nRepeat)*map.m_nHeight*TILE_SIZE; //copy offset
+
+    for(int i=0; i<nZombies; i++){
+      const Vec& p = map.m_vecZombies[i%map.m_vecZombies.size()];
+      world.Create(SPRITE_ZOMBIE, {p.x + dx, p.y + dy}, ZOMBIE_HEALTH);
+    } //for
+
+    for(int i=0; i<nTurrets; i++){
+      const Vec& p = map.m_vecTurrets[i%map.m_vecTurrets.size()];
+      world.Create(SPRITE_TURRET, {p.x + dx, p.y + dy}, TURRET_HEALTH);
+    } //for
+  } //for
+
+  printf("%s x%d: %dx%d tiles, %zu objects, %d ticks, latency %d, loss %.0f%%\n",
+    mapfile.c_str(), nRepeat*nRepeat, map.m_nWidth*nRepeat, map.m_nHeight*nRepeat,
+    world.m_vecWalkers.size(), nTicks, nLatency, 100*fLoss);
+  printf("view %.0fx%.0f, margin %.0f, budget %d\n", fViewWidth, fViewHeight, fMargin, nBudget);
+
+  //play the night, encoding a snapshot each tick for each client against
+  //the newest one that it has acknowledged
+
+  const CSnapshotCodec codec(TILE_SIZE, NUM_SPRITES);
+  std::vector<Client> clients = {Client(false, fMargin, nBudget), Client(true, fMargin, nBudget)};
+  std::bernoulli_distribution lost(fLoss);
+  std::mt19937 rng(seed*2654435761u);
+
+  std::vector<CNetObject> objects, nearby;
+  std::vector<CNetQuantized> q, decoded;
+  const std::vector<CNetQuantized> empty;
+  std::vector<uint8_t> encoded;
+
+  for(Client& c: clients)
+    c.m_vecAcks.assign(nTicks + nLatency + 1, 0);
+
+  for(uint32_t tick=1; tick<=(uint32_t)nTicks; tick++){
+    world.GetNetObjects(objects);
+
+    for(Client& c: clients){
+      c.m_nAck = std::max(c.m_nAck, c.m_vecAcks[tick]);
+      const auto start = std::chrono::steady_clock::now();
+
+      if(c.m_bFiltered){ //the objects near the view, by a linear scan here
+        const CNetRect view = GetView(world, fViewWidth, fViewHeight);
+        const CNetRect r = c.m_cFilter.GetBounds(view);
+        nearby.clear();
+
+        for(const CNetObject& p: objects)
+          if(p.m_fX >= r.m_fLeft && p.m_fX <= r.m_fRight &&
+            p.m_fY >= r.m_fBottom && p.m_fY <= r.m_fTop)
+            nearby.push_back(p);
+
+        c.m_cFilter.Select(codec, nearby, view, c.m_cSent.Find(c.m_nLastSent), q);
+      } //if
+
+      else codec.Quantize(objects, q);
+
+      const std::vector<CNetQuantized>* base = c.m_cSent.Find(c.m_nAck);
+      codec.Encode(base? *base: empty, q, encoded);
+
+      c.m_fSeconds += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+      c.m_cSent.Add(tick) = q;
+      c.m_nLastSent = tick;
+      c.m_vecBytes.push_back(encoded.size());
+      c.m_nObjects += q.size();
+
+      if(lost(rng))c.m_nLost++;
+
+      else{
+        const std::vector<CNetQuantized>* cbase = c.m_cReceived.Find(c.m_nAck);
+
+        if(!codec.Decode(cbase? *cbase: empty, encoded.data(), encoded.size(), decoded) ||
+          !Same(decoded, q))
+        {
+          fprintf(stderr, "Snapshot %u did not decode\n", tick);
+          return 1;
+        } //if
+
+        std::swap(c.m_cReceived.Add(tick), decoded);
+        c.m_nNewest = tick;
+      } //else
+
+      c.m_vecAcks[tick + nLatency] = c.m_nNewest;
+    } //for
+
+    world.Step(tick);
+  } //for
+
+  //report the snapshot sizes for each client
+
+  printf("\nclient   objects   bytes/tick: mean  p50  p95  max   KB/s  keyframe  us/tick  lost\n");
+
+  for(const Client& c: clients){
+    std::vector<size_t> sorted = c.m_vecBytes;
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0;
+    for(size_t n: sorted)total += n;
+    const double fMean = total/sorted.size();
+
+    printf("%-8s %7.1f %17.1f %4zu %4zu %4zu %6.2f %9zu %8.2f %5zu\n",
+      c.m_bFiltered? "view": "all", (double)c.m_nObjects/nTicks, fMean,
+      Percentile(sorted, 0.5), Percentile(sorted, 0.95), sorted.back(),
+      30*fMean/1024, c.m_vecBytes[0], 1e6*c.m_fSeconds/nTicks, c.m_nLost);
+  } //for
+
+  printf("full records %.0f bytes per tick (%zu per object)\n",
+    (double)clients[0].m_nObjects/nTicks*RECORD_SIZE, RECORD_SIZE);
+
+  //time the codec on the last whole-world snapshot against a baseline from
+  //a few ticks earlier, and against nothing
+
+  const std::vector<CNetQuantized>* base = clients[0].m_cSent.Find(nTicks - nLatency - 1);
+  const std::vector<CNetQuantized>& last = *clients[0].m_cSent.Find(nTicks);
+  auto time = [&](const std::vector<CNetQuantized>& b, const char* label){
+    const int n = nReps*1000; //iterations
+    volatile size_t sink = 0; //stops the optimizer removing the work
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(int i=0; i<n; i++){
+      codec.Encode(b, last, encoded);
+      sink += encoded.size();
+    } //for
+
+    const double enc = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    for(int i=0; i<n; i++){
+      codec.Decode(b, encoded.data(), encoded.size(), decoded);
+      sink += decoded.size();
+    } //for
+
+    const double dec = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+    printf("%-15s %4zu bytes  encode %9.0f/s (%.2f us)  decode %9.0f/s (%.2f us)\n",
+      label, encoded.size(), n/enc, 1e6*enc/n, n/dec, 1e6*dec/n);
+  }; //time
+
+  printf("\n");
+  if(base)time(*base, "delta");
+  time(empty, "keyframe");
+
+  auto start = std::chrono::steady_clock::now();
+  const int n = nReps*1000; //iterations
+
+  for(int i=0; i<n; i++)
+    codec.Quantize(objects, q);
+
+  const double secs = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  printf("quantize        %zu objects  %9.0f/s (%.2f us)\n", objects.size(), n/secs, 1e6*secs/n);
+  return 0;
+} //main